@@ -8,18 +8,60 @@
 
 
 #include <limits>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstddef>
+#include <memory>
+#include <array>
+#include <optional>
+#include <algorithm>
+#include <iterator>
+#include <compare>
+#include <utility>
+#include <atomic>
+#include <thread>
+#include <exception>
+#include <system_error>
+#include <span>
+#include <ranges>
 #include <concepts>
 #include <stdexcept>
 #include <initializer_list>
+#include <memory_resource>
 #include <string>
 #include <string_view>
 #include <sstream>
 #include <vector>
+#include <deque>
+#include <functional>
 #include <tuple>
 #include <variant>
 #include <unordered_map>
 #include <unordered_set>
 
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#include <cerrno>
+#define DEFPROB_CLUTILS_HAVE_UNISTD 1
+#endif
+
+#if defined(DEFPROB_CLUTILS_HAVE_UNISTD) && __has_include(<sys/mman.h>)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#define DEFPROB_CLUTILS_HAVE_MMAN 1
+#endif
+
+// errors are thrown as exceptions, unless the library is built without them
+// (e.g., with -fno-exceptions) or with DEFPROB_CLUTILS_NO_EXCEPTIONS defined,
+// in which case the error is printed and the program aborted where it would
+// have been thrown; the try_ functions report errors without doing either
+#if !defined(DEFPROB_CLUTILS_NO_EXCEPTIONS) && !defined(__cpp_exceptions)
+#define DEFPROB_CLUTILS_NO_EXCEPTIONS 1
+#endif
+
 
 namespace CLUtils {
 
@@ -50,6 +92,13 @@ struct InternalError;
 }
 
 
+#ifdef DEFPROB_CLUTILS_HAVE_MMAN
+namespace helper {
+class MappedFile;
+}
+#endif
+
+
 // forward declare BasicName for the Literals:: user-defined literals
 template <typename T>
 class BasicName;
@@ -85,7 +134,7 @@ enum class FlagType { unset, short_type, long_type };
 
 enum class FlagClass { bare, optional, mandatory, stop };
 
-enum class InputType { unset, internal, external };
+enum class InputType : std::uint8_t { unset, internal, external };
 
 enum class Aggressive { no, yes };
 
@@ -127,6 +176,58 @@ enum class Greedy { no, lax, yes };
   // -o A  | no input      . no input      . noinput
  
 
+// whether an opt "@file" is replaced by the opts read from the file, and if
+// so, whether an "@file" read from a file is replaced in turn
+enum class ResponseFiles { no, yes, nested };
+
+
+// RuntimePolicy
+//
+// The parsing behaviour that a BasicOpts object leaves to be set at run time
+// (by allow_chaining(), set_greedy(), etc.). A policy that fixes some of the
+// behaviour at compile time derives from this and redeclares those members
+// with a value, for example:
+//
+//   struct NoChaining : CLUtils::RuntimePolicy {
+//     static constexpr std::optional<bool> chaining = false;
+//   };
+//   CLUtils::BasicOpts<char, NoChaining> cl;
+//
+// so that the parser is compiled without the branches that can never be
+// taken. The setters of fixed behaviour are not available.
+//
+struct RuntimePolicy {
+  static constexpr std::optional<bool>   chaining           = std::nullopt;
+  static constexpr std::optional<Greedy> mandatory_greedy   = std::nullopt;
+  static constexpr std::optional<bool>   optional_greedy    = std::nullopt;
+  static constexpr std::optional<bool>   empty_inputs       = std::nullopt;
+  static constexpr std::optional<bool>   empty_arguments    = std::nullopt;
+  // whether arguments and unrecognized flags are collected at all; how many
+  // may be is still set by allow_arguments(max), etc.
+  static constexpr std::optional<bool>   arguments          = std::nullopt;
+  static constexpr std::optional<bool>   unrecognized_flags = std::nullopt;
+};
+
+// FixedPolicy
+//
+// A policy that fixes all of the behaviour of RuntimePolicy; the defaults are
+// those of a BasicOpts object that is left unconfigured.
+//
+template <bool Chaining = true, Greedy MandatoryGreedy = Greedy::no,
+          bool OptionalGreedy = false, bool EmptyInputs = false,
+          bool EmptyArguments = false, bool Arguments = false,
+          bool UnrecognizedFlags = false>
+struct FixedPolicy {
+  static constexpr std::optional<bool>   chaining           = Chaining;
+  static constexpr std::optional<Greedy> mandatory_greedy   = MandatoryGreedy;
+  static constexpr std::optional<bool>   optional_greedy    = OptionalGreedy;
+  static constexpr std::optional<bool>   empty_inputs       = EmptyInputs;
+  static constexpr std::optional<bool>   empty_arguments    = EmptyArguments;
+  static constexpr std::optional<bool>   arguments          = Arguments;
+  static constexpr std::optional<bool>   unrecognized_flags = UnrecognizedFlags;
+};
+
+
 enum class ErrorKey {
   ArgEmpty = 1000,
   Unrecognized = 2000,
@@ -145,7 +246,9 @@ enum class ErrorKey {
   StopInput = 4201,
   StopInput_ = 4211,
   MissingInput = 4300,
-  MissingInput_ = 4310
+  MissingInput_ = 4310,
+  UnclosedQuote = 5000,
+  TrailingEscape = 5100
 };
 
 // helper object for returning the ErroKeys
@@ -172,7 +275,57 @@ std::initializer_list<ErrorKey> error_keys{
   ErrorKey::StopInput,
   ErrorKey::StopInput_,
   ErrorKey::StopProscribed,
-  ErrorKey::StopProscribed_
+  ErrorKey::StopProscribed_,
+  ErrorKey::UnclosedQuote,
+  ErrorKey::TrailingEscape
+};
+
+
+// ErrorKeySet
+//
+// A set of ErrorKeys held as a bitmask, for choosing the errors to write.
+//
+class ErrorKeySet {
+public:
+  constexpr ErrorKeySet() noexcept = default;
+  constexpr ErrorKeySet(std::initializer_list<ErrorKey> keys) noexcept;
+
+  [[nodiscard]] static constexpr ErrorKeySet all() noexcept;
+
+  constexpr ErrorKeySet& insert(const ErrorKey key) noexcept;
+  [[nodiscard]] constexpr bool contains(const ErrorKey key) const noexcept;
+
+private:
+  [[nodiscard]] static constexpr std::uint32_t bit(const ErrorKey key) noexcept;
+
+private:
+  std::uint32_t bits_{0};
+};
+
+
+
+// FlagHandle
+//
+// Refers to a declared flag by its position in the declarations, as returned
+// by BasicOpts::add_bare(), etc. A handle stays valid until the declarations
+// are cleared, and is valid for any spec compiled from them. Querying by
+// handle indexes straight into the instances of the flag, so no name is
+// looked up.
+//
+class FlagHandle {
+public:
+  using FlagPos = std::size_t;
+
+public:
+  explicit constexpr FlagHandle(const FlagPos pos) noexcept;
+
+  [[nodiscard]] constexpr FlagPos pos() const noexcept;
+
+  [[nodiscard]] constexpr bool operator==(const FlagHandle& other)
+      const noexcept = default;
+
+private:
+  FlagPos pos_;
 };
 
 
@@ -221,25 +374,156 @@ private:
 //
 // BasicArg is an argument instance on the command line. It will just contain
 // the name of the argument itself, and the position on the command line.
+// An argument is always a whole opt, so its subpos is always 0 and is not
+// stored (see BasicUnrecognizedFlag for an opt that may have one). The name
+// is held as a pointer and a 'TPos' length, so that with a 32-bit 'TPos' an
+// argument takes 16 bytes rather than the 32 of a view and two CLTypes.
 //
-template <typename TChar>
+template <typename TChar, typename TPos = CLType>
 class BasicArg {
 public:
   using Char       = TChar;
   using value_type = Char;
   using StringView = std::basic_string_view<Char>;
+  using Pos        = TPos;
 
 public:
-  BasicArg(const StringView name, const CLType pos, const CLType subpos = 0);
+  BasicArg(const StringView name, const CLType pos);
 
   [[nodiscard]] StringView name() const noexcept;
   [[nodiscard]] CLType pos() const noexcept;
   [[nodiscard]] CLType subpos() const noexcept;
 
 private:
-  StringView name_;
-  CLType     pos_;
-  CLType     subpos_;
+  const Char* name_;
+  Pos         size_;
+  Pos         pos_;
+};
+
+
+
+// BasicUnrecognizedFlag
+//
+// An unrecognized flag on the command line: a BasicArg that also holds the
+// subpos of a flag found within a chain of short flags (0 for a whole opt).
+//
+template <typename TChar, typename TPos = CLType>
+class BasicUnrecognizedFlag : public BasicArg<TChar, TPos> {
+public:
+  using Arg        = BasicArg<TChar, TPos>;
+  using StringView = typename Arg::StringView;
+  using Pos        = TPos;
+
+public:
+  BasicUnrecognizedFlag(const StringView name, const CLType pos,
+                        const CLType subpos = 0);
+
+  [[nodiscard]] CLType subpos() const noexcept;
+
+private:
+  Pos subpos_;
+};
+
+
+
+// BasicArgRange
+//
+// BasicArgRange is a run of arguments given one after another on the command
+// line, held as a view over the argv that was parsed rather than as one
+// BasicArg each. Its elements are the opts at positions [pos(), end_pos()),
+// read straight from that argv (either the pointers of an argc/argv or the
+// views of a saved container), which must outlive it as with any argument.
+//
+template <typename TChar, typename TPos = CLType>
+class BasicArgRange {
+public:
+  using Char            = TChar;
+  using value_type      = std::basic_string_view<Char>;
+  using StringView      = std::basic_string_view<Char>;
+  using Pos             = TPos;
+  using size_type       = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  class iterator {
+  public:
+    using iterator_concept  = std::random_access_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type        = StringView;
+    using difference_type   = std::ptrdiff_t;
+
+  public:
+    iterator() = default;
+
+    [[nodiscard]] StringView operator*() const noexcept;
+    [[nodiscard]] StringView operator[](const difference_type n) const noexcept;
+
+    iterator& operator++() noexcept;
+    iterator operator++(int) noexcept;
+    iterator& operator--() noexcept;
+    iterator operator--(int) noexcept;
+    iterator& operator+=(const difference_type n) noexcept;
+    iterator& operator-=(const difference_type n) noexcept;
+    [[nodiscard]] iterator operator+(const difference_type n) const noexcept;
+    [[nodiscard]] iterator operator-(const difference_type n) const noexcept;
+    [[nodiscard]] difference_type operator-(const iterator& other)
+        const noexcept;
+
+    [[nodiscard]] friend iterator operator+(const difference_type n,
+                                            const iterator& it) noexcept {
+      return it + n;
+    }
+
+    [[nodiscard]] bool operator==(const iterator& other) const noexcept;
+    [[nodiscard]] std::strong_ordering operator<=>(const iterator& other)
+        const noexcept;
+
+  private:
+    friend class BasicArgRange;
+
+    iterator(const Char* const* argv, const StringView* views,
+             const difference_type i) noexcept;
+
+    const Char* const* argv_{nullptr};
+    const StringView*  views_{nullptr};
+    difference_type    i_{0};
+  };
+
+  using const_iterator = iterator;
+
+public:
+  BasicArgRange() = default;
+  BasicArgRange(const Char* const* argv, const CLType pos,
+                const CLType size) noexcept;
+  BasicArgRange(const StringView* views, const CLType pos,
+                const CLType size) noexcept;
+
+  [[nodiscard]] size_type size() const noexcept;
+  [[nodiscard]] bool empty() const noexcept;
+
+  // the position of the first argument, and of the one after the last
+  [[nodiscard]] CLType pos() const noexcept;
+  [[nodiscard]] CLType end_pos() const noexcept;
+
+  [[nodiscard]] StringView operator[](const size_type i) const noexcept;
+
+  [[nodiscard]] iterator begin() const noexcept;
+  [[nodiscard]] iterator end() const noexcept;
+
+  // the underlying argv, as whichever of these it was parsed from (the other
+  // is then empty)
+  [[nodiscard]] std::span<const Char* const> argv() const noexcept;
+  [[nodiscard]] std::span<const StringView> views() const noexcept;
+
+private:
+  template <typename, typename> friend class BasicParseResult;
+
+  void extend() noexcept;
+
+private:
+  const Char* const* argv_{nullptr};
+  const StringView*  views_{nullptr};
+  Pos                pos_{0};
+  Pos                size_{0};
 };
 
 
@@ -278,15 +562,18 @@ private:
 //
 // This class holds all the data pertaining to an instance of a defined
 // flag on the command-line. Specifically, the flag name, its command-line
-// position (and sub-position) and any input to the flag.
+// position (and sub-position) and any input to the flag. The name and
+// input are held as pointers and 'TPos' lengths, next to 'TPos' positions,
+// and the input is put back together when asked for.
 //
-template <typename TChar>
+template <typename TChar, typename TPos = CLType>
 class BasicInstance {
 public:
   using Char       = TChar;
   using value_type = Char;
   using StringView = std::basic_string_view<Char>;
   using Input      = BasicInput<Char>;
+  using Pos        = TPos;
 
 public:
   BasicInstance(const StringView name, const CLType pos);
@@ -303,13 +590,156 @@ public:
   [[nodiscard]] StringView    name() const noexcept;
   [[nodiscard]] CLType        pos() const noexcept;
   [[nodiscard]] CLType        subpos() const noexcept;
-  [[nodiscard]] const Input&  input() const noexcept;
+  [[nodiscard]] Input         input() const noexcept;
+
+private:
+  BasicInstance(const StringView name, const CLType pos, const CLType subpos,
+                const Input& input);
+
+private:
+  const Char* name_      {};
+  const Char* input_     {};
+  Pos         name_size_ {};
+  Pos         input_size_{};
+  Pos         pos_       {};
+  Pos         subpos_    {};
+  InputType   input_type_{InputType::unset};
+};
+
+
+
+// BasicEventLog
+//
+// Everything that a parse found on the command-line, in command-line order:
+// each instance of a flag, argument and unrecognized flag is an event. The
+// events are held column by column (as a structure of arrays), so that
+// walking one property of every event touches no other; the columns are
+// carved out of one block of memory, which is sized (and regrown) as one, so
+// that a parse makes at most one growth chain of allocations for its log.
+// The events of each flag are chained in order, so that they may be walked
+// without visiting any others, and since the events are ordered by
+// position, those at a position are found by a binary search.
+//
+template <typename TChar, typename TPos = CLType>
+class BasicEventLog {
+public:
+  using Char       = TChar;
+  using value_type = Char;
+  using StringView = std::basic_string_view<Char>;
+  using Pos        = TPos;
+  using FlagPos    = std::size_t;
+  using EventPos   = std::size_t;
+  using Resource   = std::pmr::memory_resource;
+
+  enum class Kind : std::uint8_t { instance, argument, unrecognized };
+
+  // no flag, for the events that are not instances; no event, at the end of
+  // a chain
+  static constexpr FlagPos  no_flag  = std::numeric_limits<FlagPos>::max();
+  static constexpr EventPos no_event = std::numeric_limits<EventPos>::max();
+
+public:
+  BasicEventLog() = default;
+  explicit BasicEventLog(Resource* resource);
+  BasicEventLog(const BasicEventLog& other);
+  BasicEventLog(BasicEventLog&& other) noexcept;
+  BasicEventLog& operator=(const BasicEventLog& other);
+  BasicEventLog& operator=(BasicEventLog&& other);
+  ~BasicEventLog();
+
+  [[nodiscard]] EventPos size() const noexcept;
+  [[nodiscard]] bool empty() const noexcept;
+
+  [[nodiscard]] Kind kind(const EventPos event) const noexcept;
+  [[nodiscard]] FlagPos flag(const EventPos event) const noexcept;
+  [[nodiscard]] StringView name(const EventPos event) const noexcept;
+  [[nodiscard]] CLType pos(const EventPos event) const noexcept;
+  [[nodiscard]] CLType subpos(const EventPos event) const noexcept;
+  [[nodiscard]] bool has_input(const EventPos event) const noexcept;
+  [[nodiscard]] StringView input(const EventPos event) const noexcept;
+  [[nodiscard]] InputType input_type(const EventPos event) const noexcept;
+
+  // the first event of 'flag', and the event of the same flag after 'event';
+  // no_event if there is none
+  [[nodiscard]] EventPos first(const FlagPos flag) const noexcept;
+  [[nodiscard]] EventPos next(const EventPos event) const noexcept;
+
+  // the last event of 'flag' (no_event if there is none), and the number of
+  // events of 'flag'
+  [[nodiscard]] EventPos last(const FlagPos flag) const noexcept;
+  [[nodiscard]] EventPos count(const FlagPos flag) const noexcept;
+
+  // the events at command-line position 'pos', as [first, last)
+  [[nodiscard]] std::pair<EventPos, EventPos> at(const CLType pos)
+      const noexcept;
+
+private:
+  template <typename, typename> friend class BasicParseResult;
+
+  // the ends of the chain of a flag's events, and their number
+  struct Chain {
+    EventPos head{no_event};
+    EventPos tail{no_event};
+    EventPos count{0};
+  };
+
+  // the columns, widest first so that each is aligned in the block: the
+  // column of a 'T' starts 'capacity_ * offset' bytes in
+  static constexpr std::size_t names_offset     = 0;
+  static constexpr std::size_t inputs_offset    = sizeof(StringView);
+  static constexpr std::size_t flags_offset     = 2 * sizeof(StringView);
+  static constexpr std::size_t next_offset      = flags_offset
+                                                    + sizeof(FlagPos);
+  static constexpr std::size_t positions_offset = next_offset
+                                                    + sizeof(EventPos);
+  static constexpr std::size_t subpos_offset    = positions_offset
+                                                    + sizeof(Pos);
+  static constexpr std::size_t kinds_offset     = subpos_offset + sizeof(Pos);
+  static constexpr std::size_t types_offset     = kinds_offset + sizeof(Kind);
+  static constexpr std::size_t event_size       = types_offset
+                                                    + sizeof(InputType);
+  static constexpr std::size_t block_align      = alignof(StringView);
+  static constexpr std::array<std::size_t, 9> column_bounds{
+    names_offset, inputs_offset, flags_offset, next_offset, positions_offset,
+    subpos_offset, kinds_offset, types_offset, event_size};
+
+  static_assert(alignof(StringView) >= alignof(FlagPos)
+                  && alignof(FlagPos) >= alignof(Pos),
+                "event log columns out of order of alignment");
+
+  template <typename T>
+  [[nodiscard]] T* column(const std::size_t offset) const noexcept;
+
+  // copy the first 'count' events of the columns of 'from', a block with
+  // room for 'from_capacity' events, to those of 'to'
+  static void copy_columns(std::byte* to, const EventPos to_capacity,
+                           const std::byte* from,
+                           const EventPos from_capacity,
+                           const EventPos count) noexcept;
+
+  void bind(const FlagPos flags);
+
+  void clear() noexcept;
+
+  void reserve(const CLType events);
+
+  // move the columns to a block with room for 'capacity' events
+  void regrow(const EventPos capacity);
+
+  void add(const Kind kind, const FlagPos flag, const StringView name,
+           const CLType pos, const CLType subpos,
+           const StringView input = {},
+           const InputType input_type = InputType::unset);
 
 private:
-  StringView name_  {};
-  CLType     pos_   {};
-  CLType     subpos_{};
-  Input      input_ {};
+  // one entry per event, in one block of 'capacity_' entries a column
+  Resource*    resource_{std::pmr::get_default_resource()};
+  std::byte*   block_{nullptr};
+  EventPos     size_{0};
+  EventPos     capacity_{0};
+
+  // one entry per flag
+  std::pmr::vector<Chain> chains_{};
 };
 
 
@@ -317,9 +747,9 @@ private:
 // BasicFlag
 //
 // This class holds all the data defining a flag with respect to parsing the
-// command-line. For example, the synonyms of the flag, its class, how many
-// times it may appear on the comamnd-line and also all instances of the
-// flag on the command-line.
+// command-line. For example, the synonyms of the flag, its class and how many
+// times it may appear on the comamnd-line. The instances of the flag on the
+// command-line are held separately, in a BasicParseResult.
 //
 template <typename TChar>
 class BasicFlag {
@@ -328,10 +758,8 @@ public:
   using value_type = Char;
   using StringView = std::basic_string_view<Char>;
   using Name = BasicName<Char>;
-  using Instance = BasicInstance<Char>;
   using Input = BasicInput<Char>;
   using Names = std::vector<Name>;
-  using Instances = std::vector<Instance>;
   using FlagMarkers = typename Name::FlagMarkers;
   enum class LimitType { Proscribed, Within, Without };
 
@@ -348,225 +776,1427 @@ public:
   [[nodiscard]] Names&           names() noexcept;
   [[nodiscard]] StringView       canonical_name() const noexcept;
   [[nodiscard]] CLType           max() const noexcept;
-  [[nodiscard]] LimitType        within_limit() const noexcept;
-  [[nodiscard]] const Instances& instances() const noexcept;
-  [[nodiscard]] Instances&       instances() noexcept;
-                void             clear() noexcept;
-
-  void add_instance(const StringView name, const CLType pos,
-                    const CLType subpos, const StringView input,
-                    const InputType type);
-
-  void add_instance(const StringView name, const CLType pos,
-                    const CLType subpos);
+  [[nodiscard]] LimitType        within_limit(const CLType count) const noexcept;
 
 private:
   FlagClass class_;
   Names     names_;
-  Instances instances_{};
   CLType    max_{std::numeric_limits<CLType>::max()};
 };
 
 
 
+// BasicNameTrie
+//
+// A prefix tree over every declared flag name, built when the name map is
+// created. Searching an opt walks the tree once along the opt string and
+// visits every declared name that is a prefix of it, shortest first, so
+// that the cost of a search depends on the length of the opt and not on the
+// number of declared flags.
+//
 template <typename TChar>
-class BasicOpts {
-private:
-  struct Parsing;
-  struct ErrorInfo;
-
+class BasicNameTrie {
 public:
-  using Char         = TChar;
-  using value_type   = Char;
-  using StringView   = std::basic_string_view<Char>;
-  using String       = std::basic_string<Char>;
-  using CLOpts       = std::vector<String>;
-  using Name         = BasicName<Char>;
-  using Flag         = BasicFlag<Char>;
-  using Arg          = BasicArg<Char>;
-  using Flags        = std::vector<Flag>;
-  using Args         = std::vector<Arg>;
-  using Unrecognized = std::vector<Arg>;
-  using ArgPos       = typename Args::difference_type;
-  using UnrecognizedPos = typename Unrecognized::difference_type;
-  using FlagPtr      = Flag*;
-  using NamePtr      = Name*;
-  using SearchRes    = std::tuple<NamePtr, FlagPtr>;
-  using SearchAll    = std::vector<SearchRes>;
-  using Map          = std::unordered_map<StringView, SearchRes>;
-  using Instance     = typename Flag::Instance;
-  using Instances    = typename Flag::Instances;
-  using InstancePos  = typename Instances::difference_type;
-  using InputResult  = std::tuple<bool, StringView>;
-  using ErrorInput   = std::variant<StringView, CLType>;
-  using Error        = std::tuple<ErrorInfo, String>;
-  using Errors       = std::vector<Error>;
-  using ErrorPos     = typename Errors::size_type;
-  using ErrorInfos   = std::vector<ErrorInfo>;
-  using ErrorMap     = std::unordered_map<ErrorKey, String>;
-  using Keys         = std::vector<ErrorKey>;
-  using CanonNames   = std::vector<StringView>;
-  using FlagMarkers  = typename Flag::FlagMarkers;
-  using LimitType    = typename Flag::LimitType;
+  using Char       = TChar;
+  using value_type = Char;
+  using StringView = std::basic_string_view<Char>;
+  using SizeType   = typename StringView::size_type;
+  using Name       = BasicName<Char>;
+  using Flag       = BasicFlag<Char>;
+  using NamePtr    = Name*;
+  using FlagPtr    = Flag*;
+  using SearchRes  = std::tuple<NamePtr, FlagPtr>;
+  using NodePos    = std::uint32_t;
 
 private:
-  struct Parsing {
-    void clear() noexcept;
-    void reset_all() noexcept;
-    [[nodiscard]] bool operator()() const noexcept;
-
-    bool     stop  {false};  // set to true if a stop flag has been given
-    FlagPtr  pflag {nullptr};
-    NamePtr  pname {nullptr};
-    CLType   subpos{0};
+  struct Edge {
+    Char    key;
+    NodePos node;
   };
 
-  struct ErrorInfo {
-    // error: pos P: ...
-    ErrorInfo(const ErrorKey k, const CLType p);
-
-    // error: pos P: flag 'O': ... 'I'...
-    ErrorInfo(const ErrorKey k, const CLType p,
-          const StringView o, const bool f, const CLType i);
-
-    // error: pos P: flag 'O': ... 'I'...
-    ErrorInfo(const ErrorKey k, const CLType p,
-          const StringView o, const bool f, const StringView i);
-
-    // error: pos P: flag 'O': ...
-    ErrorInfo(const ErrorKey k, const CLType p,
-          const StringView o, const bool f);
-
-    // error: pos P, subpos SP: flag 'O': ... 'I'...
-    ErrorInfo(const ErrorKey k, const CLType p, const CLType sp,
-          const StringView o, const bool f, const CLType i);
-
-    // error: pos P, subpos SP: flag 'O': ... 'I'...
-    ErrorInfo(const ErrorKey k, const CLType p, const CLType sp,
-          const StringView o, const bool f, const StringView i);
-
-    // error: pos P, subpos SP: flag 'O': ...
-    ErrorInfo(const ErrorKey k, const CLType p, const CLType sp,
-          const StringView o, const bool f);
-
-    ErrorKey    key       {}; // key value is isomorphic to the error string
-    CLType      pos       {};
-    CLType      subpos    {};  // if subpos is empty, then there is no subpos
-    bool        have_opt  {false};
-    StringView  opt       {};
-    bool        is_flag   {false}; // is_flag to true if the opt is a flag
-    bool        have_input{false};
-    ErrorInput  input     {}; // StringView or CLType
+  struct Node {
+    std::vector<Edge> edges{}; // sorted by key
+    SearchRes         res{nullptr, nullptr};
   };
 
 public:
-  template <class... N>
-  void add_bare(N&&... names);
-  void add_bare() = delete;
+  BasicNameTrie();
 
-  template <class... N>
-  void add_optional(N&&... names);
-  void add_optional() = delete;
+  void clear();
+  void insert(const StringView name, const SearchRes res);
 
-  template <class... N>
-  void add_mandatory(N&&... names);
-  void add_mandatory() = delete;
+  // call 'visit(length, res)' for every name that is a prefix of 'opt', in
+  // order of increasing length
+  template <typename F>
+  void walk(const StringView opt, F&& visit) const;
 
-  template <class... N>
-  void add_stop(N&&... names);
-  void add_stop() = delete;
+  // as above, but for the string formed by 'prefix' followed by 'opt',
+  // without the need to create it
+  template <typename F>
+  void walk(const StringView prefix, const StringView opt, F&& visit) const;
 
-  void allow_empty_arguments(const bool state = true) noexcept;
+private:
+  [[nodiscard]] NodePos find_child(const NodePos node,
+                                   const Char key) const noexcept;
 
-  void allow_empty_inputs(const bool state = true) noexcept;
+private:
+  std::vector<Node> nodes_;
+};
 
-  template <PosType T>
-  void allow_arguments(const T max) noexcept;
 
-  void allow_arguments() noexcept;
 
-  template <PosType T>
-  void allow_unrecognized_flags(const T max, const Aggressive state = Aggressive::no) noexcept;
+// BasicShortTable
+//
+// A direct lookup table for short names, built alongside the name trie. It
+// maps a flag marker and the code unit that follows it (or a lone code unit
+// when there is no flag marker) straight to the short name they spell, so
+// that each subopt in a chain of short opts costs a single lookup. For one
+// byte character types each table is an array indexed by the code unit; for
+// wider types it is a compact sorted table.
+//
+// Should a longer short name also begin with the same code units (e.g.,
+// "-ab"_short alongside "-a"), then the table cannot answer on its own and
+// the trie is searched instead.
+//
+template <typename TChar>
+class BasicShortTable {
+public:
+  using Char        = TChar;
+  using value_type  = Char;
+  using StringView  = std::basic_string_view<Char>;
+  using Name        = BasicName<Char>;
+  using Flag        = BasicFlag<Char>;
+  using NamePtr     = Name*;
+  using FlagPtr     = Flag*;
+  using SearchRes   = std::tuple<NamePtr, FlagPtr>;
+  using FlagMarkers = typename Name::FlagMarkers;
 
-  void allow_unrecognized_flags(const Aggressive state = Aggressive::no) noexcept;
+private:
+  struct Entry {
+    SearchRes res{nullptr, nullptr};
+    bool      longer{false}; // a longer short name begins here too
+  };
 
-  template <PosType T>
-  void allow_unrecognized_opts(const T max) noexcept;
+  static constexpr bool direct = sizeof(Char) == 1;
 
-  void allow_unrecognized_opts() noexcept;
+  using Direct = std::array<Entry, 256>;
+  using Sorted = std::vector<std::tuple<Char, Entry>>; // sorted by Char
+  using Table  = std::conditional_t<direct, Direct, Sorted>;
 
-  void allow_chaining(const bool state = true) noexcept;
+  struct Marked {
+    bool  have_marker{false};
+    Char  marker{};
+    bool  usable{true}; // false if the lone marker is itself a short name
+    Table table{};
+  };
 
-  void set_chaining(const bool state = true) noexcept;
+public:
+  void clear() noexcept;
+  void insert(const StringView name, const SearchRes res,
+              const FlagMarkers& flag_markers);
 
-  void set_no_chaining() noexcept;
+  // return the short name spelled by 'prefix' (empty or a single flag
+  // marker) followed by 'c', a null result if there is none, or else
+  // std::nullopt if the trie needs to be searched instead
+  [[nodiscard]] std::optional<SearchRes> find(const StringView prefix,
+                                              const Char c) const;
 
-  void set_greedy(const bool state = true) noexcept;
+private:
+  [[nodiscard]] Marked& table_for(const bool have_marker, const Char marker);
+  [[nodiscard]] static Entry& entry(Table& table, const Char c);
 
-  void set_not_greedy() noexcept;
+private:
+  std::vector<Marked> tables_{};
+};
 
-  void set_lax_greedy() noexcept;
 
-  void set_greedy(const Greedy state) noexcept;
 
-  void set_optional_greedy(const bool state = true) noexcept;
+// BasicMarkerTable
+//
+// The flag markers, compiled for the test made of every opt that is parsed:
+// whether it begins with one. For code units of a byte, this is a bit per
+// code unit; otherwise the markers are held in sorted order (there are rarely
+// more than one or two), rather than hashed.
+//
+template <typename TChar>
+class BasicMarkerTable {
+public:
+  using Char        = TChar;
+  using value_type  = Char;
+  using FlagMarkers = typename BasicName<Char>::FlagMarkers;
 
-  void set_optional_not_greedy() noexcept;
+private:
+  static constexpr bool direct = sizeof(Char) == 1;
 
-  template <typename Str>
-  void set_preamble(Str&& str);
+  using Direct = std::array<std::uint64_t, 4>; // 256 bits
+  using Sorted = std::vector<Char>;
+  using Table  = std::conditional_t<direct, Direct, Sorted>;
 
-  template <typename Str>
-  void set_postscript(Str&& str);
+public:
+  BasicMarkerTable() = default;
+  explicit BasicMarkerTable(const FlagMarkers& flag_markers);
 
-  template <class... Chars, typename = std::common_type_t<Chars...>>
-  void set_flag_markers(Chars... flag_markers);
+  void assign(const FlagMarkers& flag_markers);
 
-  template <class... Chars, typename = std::common_type_t<Chars...>>
-  void set_flag_marker(Chars... flag_markers);
+  [[nodiscard]] bool contains(const Char c) const noexcept;
 
-  template <class... Chars, typename = std::common_type_t<Chars...>>
-  void add_flag_markers(Chars... flag_markers);
+private:
+  Table table_{};
+};
 
-  template <class... Chars, typename = std::common_type_t<Chars...>>
-  void add_flag_marker(Chars... flag_markers);
 
-  template <class... Chars, typename = std::common_type_t<Chars...>>
-  void set_opt_markers(Chars... flag_markers);
 
-  template <class... Chars, typename = std::common_type_t<Chars...>>
-  void set_opt_marker(Chars... flag_markers);
+// BasicErrorInfo
+//
+// A parsing error as it was registered, before it is formatted into an error
+// string. The key is isomorphic to the error string; the remaining members
+// are whatever the error string will need to be filled in.
+//
+template <typename TChar>
+struct BasicErrorInfo {
+  using Char       = TChar;
+  using value_type = Char;
+  using StringView = std::basic_string_view<Char>;
+  using ErrorInput = std::variant<StringView, CLType>;
+
+  // error: pos P: ...
+  BasicErrorInfo(const ErrorKey k, const CLType p);
+
+  // error: pos P: flag 'O': ... 'I'...
+  BasicErrorInfo(const ErrorKey k, const CLType p,
+        const StringView o, const bool f, const CLType i);
+
+  // error: pos P: flag 'O': ... 'I'...
+  BasicErrorInfo(const ErrorKey k, const CLType p,
+        const StringView o, const bool f, const StringView i);
+
+  // error: pos P: flag 'O': ...
+  BasicErrorInfo(const ErrorKey k, const CLType p,
+        const StringView o, const bool f);
+
+  // error: pos P, subpos SP: flag 'O': ... 'I'...
+  BasicErrorInfo(const ErrorKey k, const CLType p, const CLType sp,
+        const StringView o, const bool f, const CLType i);
+
+  // error: pos P, subpos SP: flag 'O': ... 'I'...
+  BasicErrorInfo(const ErrorKey k, const CLType p, const CLType sp,
+        const StringView o, const bool f, const StringView i);
+
+  // error: pos P, subpos SP: flag 'O': ...
+  BasicErrorInfo(const ErrorKey k, const CLType p, const CLType sp,
+        const StringView o, const bool f);
+
+  ErrorKey    key       {}; // key value is isomorphic to the error string
+  CLType      pos       {};
+  CLType      subpos    {};  // if subpos is empty, then there is no subpos
+  bool        have_opt  {false};
+  StringView  opt       {};
+  bool        is_flag   {false}; // is_flag to true if the opt is a flag
+  bool        have_input{false};
+  ErrorInput  input     {}; // StringView or CLType
+
+  // where the opt at 'pos' came from, if response files were read: its
+  // position in argv, and the response file and offset it was read from
+  // (the file is empty for an opt of argv itself)
+  CLType      arg       {0}; // 0 if no response files were read
+  StringView  file      {};
+  std::size_t offset    {0};
+};
 
-  template <class... Chars, typename = std::common_type_t<Chars...>>
-  void add_opt_markers(Chars... flag_markers);
 
-  template <class... Chars, typename = std::common_type_t<Chars...>>
-  void add_opt_marker(Chars... flag_markers);
 
-  void set_flag_marker() = delete;
-  void set_flag_markers() = delete;
-  void add_flag_marker() = delete;
-  void add_flag_markers() = delete;
-  void set_opt_marker() = delete;
-  void set_opt_markers() = delete;
-  void add_opt_marker() = delete;
-  void add_opt_markers() = delete;
+// BasicErrorFormat
+//
+// An error string prototype (with the preamble and postscript about it),
+// compiled once into a list of literal segments and placeholders such as
+// %pos and %opt. An error is then written by appending each segment in turn
+// to the output, instead of searching and splicing a copy of the prototype.
+// Once response files have been read, %pos is the position in argv, and an
+// opt read from a file is placed by %file and %offset or, if the format has
+// neither, by " (in FILE at OFFSET)" after the first %pos.
+//
+template <typename TChar>
+class BasicErrorFormat {
+public:
+  using Char       = TChar;
+  using value_type = Char;
+  using String     = std::basic_string<Char>;
+  using StringView = std::basic_string_view<Char>;
+  using SizeType   = typename StringView::size_type;
+  using ErrorInfo  = BasicErrorInfo<Char>;
 
-  void set_input_marker(const Char input_marker) noexcept;
+private:
+  enum class Field : std::uint8_t {
+    literal, opt, type, pos, subpos, input, key, file, offset
+  };
 
-  void clear() noexcept;
+  struct Token {
+    Field    field;
+    SizeType offset; // the segment of text_ that is written for a literal,
+    SizeType length; // or else if the placeholder has nothing to fill it
+  };
 
-  void clear_errors() noexcept;
+public:
+  explicit BasicErrorFormat(String proto);
 
-  void clear_declarations() noexcept;
+  // append 'error' written out in this format to 'out' (any string type)
+  template <typename Str>
+  void write(Str& out, const ErrorInfo& error) const;
 
-  void default_error_formats() noexcept;
+  // write 'error' out in this format through 'out'
+  template <std::output_iterator<const Char&> Out>
+  Out write_to(Out out, const ErrorInfo& error) const;
 
-  [[nodiscard]] const Errors& get_all_errors() const noexcept;
+  // an upper bound on the length of 'error' written out in this format
+  [[nodiscard]] SizeType length(const ErrorInfo& error) const noexcept;
 
-  [[nodiscard]] Errors& get_all_errors() noexcept;
+private:
+  template <std::output_iterator<const Char&> Out>
+  static Out write_number(Out out, CLType val);
 
-  [[nodiscard]] const Map& get_map();
+private:
+  String             text_;
+  std::vector<Token> tokens_;
+  SizeType           literal_length_{0};
+  bool               places_file_{false}; // has %file or %offset
+};
+
+
+
+template <typename TChar, typename TPos = CLType>
+class BasicParseResult;
+
+template <typename TChar, typename TPolicy = RuntimePolicy,
+          typename TPos = CLType>
+class BasicOpts;
+
+template <typename TChar, typename TPolicy = RuntimePolicy,
+          typename TPos = CLType>
+class BasicParseStream;
+
+
+
+// BasicCompiledSpec
+//
+// The frozen flag declarations and parsing behaviour of a BasicOpts object,
+// as returned by BasicOpts::compile(). A compiled spec is never modified by
+// parsing: every parse writes to the BasicParseResult that it is given, so
+// that one spec may be shared by any number of threads, each parsing into
+// its own result. The spec must outlive the results that are parsed with it,
+// since they refer to its flag names.
+//
+template <typename TChar>
+class BasicCompiledSpec {
+private:
+  struct Parsing;
+
+public:
+  using Char         = TChar;
+  using value_type   = Char;
+  using StringView   = std::basic_string_view<Char>;
+  using String       = std::basic_string<Char>;
+  using Name         = BasicName<Char>;
+  using Flag         = BasicFlag<Char>;
+  using Flags        = std::vector<Flag>;
+  using FlagPtr      = Flag*;
+  using NamePtr      = Name*;
+  using FlagPos      = typename Flags::size_type;
+  using SearchRes    = std::tuple<NamePtr, FlagPtr>;
+  using Map          = std::unordered_map<StringView, SearchRes>;
+  using Trie         = BasicNameTrie<Char>;
+  using ShortTable   = BasicShortTable<Char>;
+  using Result       = BasicParseResult<Char>;
+  template <typename TPos>
+  using ResultFor    = BasicParseResult<Char, TPos>;
+  using ErrorInfo    = BasicErrorInfo<Char>;
+  using ErrorMap     = std::unordered_map<ErrorKey, String>;
+  using ErrorFormat  = BasicErrorFormat<Char>;
+  using ErrorFormats = std::unordered_map<ErrorKey, ErrorFormat>;
+  using CanonNames   = std::vector<StringView>;
+  using FlagMarkers  = typename Flag::FlagMarkers;
+  using MarkerTable  = BasicMarkerTable<Char>;
+  using LimitType    = typename Flag::LimitType;
+
+private:
+  struct Parsing {
+    void clear() noexcept;
+    void reset_all() noexcept;
+    [[nodiscard]] bool operator()() const noexcept;
+
+    bool     stop  {false};  // set to true if a stop flag has been given
+    FlagPtr  pflag {nullptr};
+    NamePtr  pname {nullptr};
+    CLType   subpos{0};
+  };
+
+  // an entry of a name table generated at compile time (see StaticOpts): a
+  // name, the position of its flag and that of the name within the flag
+  struct StaticName {
+    StringView                      name;
+    FlagPos                         flag;
+    typename Flag::Names::size_type index;
+  };
+
+  using StaticNames = std::span<const StaticName>;
+
+public:
+  BasicCompiledSpec(const BasicCompiledSpec& other);
+  BasicCompiledSpec(BasicCompiledSpec&& other) noexcept = default;
+  BasicCompiledSpec& operator=(BasicCompiledSpec other) noexcept;
+  ~BasicCompiledSpec() = default;
+
+  // the map is empty for the spec of a StaticOpts, whose names are looked up
+  // in a table generated at compile time instead
+  [[nodiscard]] const Map& get_map() const noexcept;
+  [[nodiscard]] const Flags& flags() const noexcept;
+  [[nodiscard]] FlagPos flag_pos(const StringView name) const;
+  [[nodiscard]] FlagPos flag_pos(const Flag& flag) const noexcept;
+
+  // as flag_pos, but std::nullopt if no flag has the name 'name'
+  [[nodiscard]] std::optional<FlagPos> find_flag_pos(const StringView name)
+      const noexcept;
+
+  [[nodiscard]] StringView get_preamble() const;
+  [[nodiscard]] StringView get_postscript() const;
+
+  [[nodiscard]] CanonNames registered_flags() const;
+  [[nodiscard]] CanonNames registered_opts() const;
+
+  [[nodiscard]] String create_error_string(const ErrorInfo& error) const;
+
+  // append the error string for 'error' to 'out' (any string type)
+  template <typename Str>
+  void write_error_string(Str& out, const ErrorInfo& error) const;
+
+  // write the error string for 'error' through 'out'
+  template <std::output_iterator<const Char&> Out>
+  Out write_error_to(Out out, const ErrorInfo& error) const;
+
+  // parse into 'res'. A 'Policy' that fixes some of the parsing behaviour
+  // (see RuntimePolicy) overrides that of the spec, and compiles out the
+  // branches that can never be taken
+  template <typename Policy = RuntimePolicy, typename TPos, PosType T>
+  bool parse(ResultFor<TPos>& res, T argc, Char** argv, T start_at = 1) const;
+
+  template <typename Policy = RuntimePolicy, typename TPos, typename T>
+  bool parse(ResultFor<TPos>& res, T&& args) const;
+
+  template <typename Policy = RuntimePolicy, typename TPos, typename T,
+            PosType U>
+  bool parse(ResultFor<TPos>& res, T&& argv, U start_at) const;
+
+  template <typename Policy = RuntimePolicy, typename TPos, class... T,
+            typename = std::common_type_t<T...>>
+  bool parse(ResultFor<TPos>& res, T&&... args) const;
+
+  template <typename TPos>
+  bool parse(ResultFor<TPos>& res) const;
+
+  // parse the words of 'line', split as a POSIX shell would (at whitespace,
+  // except within '...' or "...", or when escaped by a backslash), from
+  // position 1. A word with nothing to unquote is parsed as a view into
+  // 'line', which must outlive the result; the others are unquoted into one
+  // buffer of the result. A quote left open at the end of 'line', or a
+  // backslash that ends it, is an error (ErrorKey::UnclosedQuote or
+  // ErrorKey::TrailingEscape) at the position of the last word, which is
+  // still parsed as if the line had been closed there.
+  template <typename Policy = RuntimePolicy, typename TPos>
+  bool parse_command_line(ResultFor<TPos>& res, const StringView line) const;
+
+  // parse the opts of 'buf', each ended by a NUL (the last may be ended by
+  // the end of 'buf' instead), as in /proc/PID/cmdline, from the opt at
+  // index 'start_at' (as for argv). The opts are parsed as views into 'buf',
+  // which must outlive the result; they are only held in the result too if
+  // it keeps argument ranges.
+  template <typename Policy = RuntimePolicy, typename TPos>
+  bool parse_nul_separated(ResultFor<TPos>& res, std::span<const Char> buf,
+                           CLType start_at = 1) const;
+
+  // as parse(res, argc, argv, start_at), but for an argv of very many opts:
+  // argv is split into chunks that are parsed on 'threads' threads (or one
+  // per core if 0) and merged in order, with the same result. A chunk only
+  // ever begins after a plain argument, which leaves no flag waiting for an
+  // input, and the chunks after a stop flag are parsed again as such. Parsing
+  // is done on this thread as usual if argv is short, or if the meaning of an
+  // opt could depend on counts that a chunk cannot see or on a flag name
+  // without a flag marker (i.e., if any flag, the arguments or the
+  // unrecognized flags have a limit other than none or zero), or if the
+  // result keeps events or argument ranges.
+  template <typename Policy = RuntimePolicy, typename TPos, PosType T>
+  bool parse_parallel(ResultFor<TPos>& res, T argc, Char** argv,
+                      T start_at = 1, unsigned int threads = 0) const;
+
+  // parse every argv in 'argvs' (each a range of Char*, e.g. a
+  // std::span<Char*>) as per parse(res, argc, argv, start_at) into the
+  // result of the same index in 'results', using 'threads' threads (or one
+  // per core if 0). Returns true if any parse found errors. Results of
+  // another position type than CLType need 'TPos' to be given, since it is
+  // not deduced.
+  template <typename Policy = RuntimePolicy, typename TPos = CLType,
+            std::ranges::random_access_range Argvs, PosType T = int>
+  bool parse_batch(std::span<std::type_identity_t<ResultFor<TPos>>> results,
+                   const Argvs& argvs, T start_at = 1,
+                   unsigned int threads = 0) const;
+
+private:
+  template <typename, typename, typename> friend class BasicOpts;
+  template <typename, typename, typename> friend class BasicParseStream;
+  template <typename... Flags> friend class StaticOpts;
+
+  BasicCompiledSpec() = default;
+
+  void swap(BasicCompiledSpec& other) noexcept;
+
+  void freeze();
+
+  [[nodiscard]] String get_error_string(const ErrorKey key) const;
+
+  void guess_types();
+
+  void create_map();
+
+  [[nodiscard]] bool names_conflict() const;
+
+  [[nodiscard]] String get_error_string_prototype(const ErrorKey key) const;
+
+  void compile_error_formats();
+
+  [[nodiscard]] SearchRes search_flag(const StringView opt, const bool stop,
+                                      const bool short_only = false) const;
+
+  [[nodiscard]] SearchRes search_flag(const StringView prefix,
+                                      const StringView opt, const bool stop,
+                                      const bool short_only = false) const;
+
+  [[nodiscard]] SearchRes search_short_flag(const StringView prefix,
+                                            const StringView opt,
+                                            const bool stop) const;
+
+  [[nodiscard]] bool accept_match(const StringView prefix,
+                                  const StringView opt, const std::size_t len,
+                                  const NamePtr pname,
+                                  const bool short_only) const;
+
+  template <typename F>
+  void walk_static_names(const StringView prefix, const StringView opt,
+                         F&& visit) const;
+
+  [[nodiscard]] std::optional<FlagPos> find_static_name(const StringView name)
+      const noexcept;
+
+  [[nodiscard]] SearchRes static_match(const StaticName& entry) const noexcept;
+
+  [[nodiscard]] bool opt_is_flag(const StringView opt) const;
+
+  [[nodiscard]] bool opt_is_arg(const StringView opt) const;
+
+  template <typename Policy, typename TPos>
+  [[nodiscard]] bool handle_unrecognized(const StringView opt,
+                                         const bool is_flag,
+                                         const CLType pos, const bool stop,
+                                         ResultFor<TPos>& res) const;
+
+  template <typename TPos>
+  [[nodiscard]] LimitType within_limit(const FlagPtr pflag,
+                                       const ResultFor<TPos>& res) const;
+
+  template <typename TPos>
+  [[nodiscard]] bool check_within_limit(const FlagPtr pflag,
+                                        const NamePtr pname,
+                                        const CLType pos, const bool is_flag,
+                                        ResultFor<TPos>& res) const;
+
+  template <typename TPos>
+  [[nodiscard]] bool check_within_limit(const Parsing& prev, const CLType pos,
+                                        const bool is_flag,
+                                        const bool check_subpos,
+                                        ResultFor<TPos>& res) const;
+
+  template <typename Policy, typename TPos>
+  [[nodiscard]] bool add_instance(const Parsing& prev, const CLType pos,
+                                  const StringView input,
+                                  ResultFor<TPos>& res) const;
+
+  template <typename TPos>
+  void add_instance(const Parsing& prev, const CLType pos,
+                    ResultFor<TPos>& res) const;
+
+  template <typename TPos>
+  void add_instance(const FlagPtr pflag, const NamePtr pname,
+                    const CLType pos, const CLType subpos,
+                    ResultFor<TPos>& res) const;
+
+  template <typename TPos>
+  void add_instance(const FlagPtr pflag, const NamePtr pname,
+                    const CLType pos, ResultFor<TPos>& res) const;
+
+  template <typename Policy, typename TPos>
+  [[nodiscard]] bool add_instance(const FlagPtr pflag, const NamePtr pname,
+                                  const CLType pos, const CLType subpos,
+                                  const StringView input, const InputType type,
+                                  ResultFor<TPos>& res) const;
+
+  template <typename Policy, typename TPos>
+  [[nodiscard]] bool add_instance(const FlagPtr pflag, const NamePtr pname,
+                                  const CLType pos, const StringView input,
+                                  const InputType type,
+                                  ResultFor<TPos>& res) const;
+
+  template <typename Policy>
+  [[nodiscard]] bool are_collecting_args() const noexcept;
+
+  template <typename TPos>
+  [[nodiscard]] bool args_within_limit(const ResultFor<TPos>& res)
+      const noexcept;
+
+  template <typename Policy>
+  [[nodiscard]] bool are_collecting_unrecognized_flags() const noexcept;
+
+  template <typename TPos>
+  [[nodiscard]] bool unrecognized_flags_within_limit(
+                                    const ResultFor<TPos>& res) const noexcept;
+
+  template <typename Policy>
+  [[nodiscard]] bool chaining() const noexcept;
+
+  template <typename Policy>
+  [[nodiscard]] Greedy mandatory_greedy() const noexcept;
+
+  template <typename Policy>
+  [[nodiscard]] bool optional_greedy() const noexcept;
+
+  template <typename Policy>
+  [[nodiscard]] bool empty_inputs() const noexcept;
+
+  template <typename Policy>
+  [[nodiscard]] bool empty_arguments() const noexcept;
+
+  template <typename Policy>
+  [[nodiscard]] bool optional_can_take_no_input() const noexcept;
+
+  template <typename Policy>
+  [[nodiscard]] bool mandatory_and_greedy(const Parsing& prev) const noexcept;
+
+  template <typename Policy>
+  [[nodiscard]] bool optional_and_greedy(const Parsing& prev) const noexcept;
+
+  template <typename TPos>
+  static void check_fits(const CLType pos, const std::size_t size);
+
+  template <typename Policy, typename TPos>
+  void parse_opt(const CLType pos, const StringView opt, Parsing& prev,
+                 bool& errors, ResultFor<TPos>& res) const;
+
+  template <typename TPos>
+  void parse_opt_finish(const CLType last_pos, Parsing& prev, bool& errors,
+                        ResultFor<TPos>& res) const;
+
+  template <typename Policy, typename TPos>
+  bool parse_saved(ResultFor<TPos>& res) const;
+
+  template <typename TPos>
+  [[nodiscard]] bool can_parse_in_chunks(const ResultFor<TPos>& res) const;
+
+  template <typename Policy, typename TPos>
+  void parse_chunk(const Char* const* argv, const CLType first,
+                   const CLType end, Parsing& prev, bool& errors,
+                   ResultFor<TPos>& res) const;
+
+  template <typename Policy, typename TPos>
+  [[nodiscard]] bool take_tail(const CLType pos, const CLType end,
+                               const Parsing& prev,
+                               ResultFor<TPos>& res) const;
+
+  template <typename Policy, typename TPos>
+  [[nodiscard]] bool parse_short_opt(const StringView opt, const bool is_flag,
+                                     const FlagPtr pflag,
+                                     const NamePtr pname, const CLType pos,
+                                     Parsing& prev, ResultFor<TPos>& res) const;
+
+  template <typename Policy, typename TPos>
+  [[nodiscard]] bool parse_long_opt(const StringView opt, const bool is_flag,
+                                    const FlagPtr pflag,
+                                    const NamePtr pname, const CLType pos,
+                                    Parsing& prev, ResultFor<TPos>& res) const;
+
+private:
+  // parsing behaviour
+  bool         allow_empty_arg_{false};
+  bool         allow_empty_input_{false};
+  bool         can_chain_{true};
+  Greedy       mandatory_greedy_{Greedy::no};
+  bool         optional_greedy_{false};
+  bool         unrecognized_greedy_{false};
+  CLType       collect_unrecognized_flags_{0};
+  CLType       collect_args_{0};
+  ResponseFiles response_files_{ResponseFiles::no};
+
+  // user-defined formatting
+  String       preamble_{};
+  String       postscript_{};
+  ErrorMap     custom_error_message_{};
+  ErrorFormats error_formats_{}; // compiled from the above
+
+  // flag characteristics
+  FlagMarkers   flag_markers_{static_cast<Char>('-')};
+  Char         input_marker_{static_cast<Char>('=')};
+
+  // flag declarations
+  Flags        flags_{};
+
+  // generated data
+  Map          map_{};
+  Trie         trie_{};
+  ShortTable   short_table_{};
+  MarkerTable  marker_table_{flag_markers_};
+  StaticNames  static_names_{}; // sorted by name; replaces the map if given
+
+  // internal (helper) switches
+  bool         flag_type_tainted_{true};
+  bool         map_tainted_{true};
+  bool         error_formats_tainted_{true};
+
+};
+
+
+
+// BasicParseResult
+//
+// The outcome of parsing a command-line against a BasicCompiledSpec: the
+// instances of each flag, the arguments, the unrecognized flags and the
+// errors. A result may be reused for any number of parses (each parse clears
+// it first), and only needs to live as long as the spec it was parsed with.
+// All of its memory is drawn from the memory resource it is constructed with
+// (e.g., a std::pmr::monotonic_buffer_resource over a per-request buffer).
+//
+template <typename TChar, typename TPos>
+class BasicParseResult {
+  static_assert(std::unsigned_integral<TPos> && !std::same_as<TPos, bool>,
+                "positions must be of an unsigned integral type");
+  static_assert(std::numeric_limits<TPos>::digits >= 32,
+                "positions must be of at least 32 bits");
+
+public:
+  using Char         = TChar;
+  using value_type   = Char;
+  using StringView   = std::basic_string_view<Char>;
+  using String       = std::basic_string<Char>;
+  using OptString    = std::pmr::basic_string<Char>;
+  using CLOpts       = std::pmr::vector<OptString>;
+  using CLViews      = std::pmr::vector<StringView>;
+  using Spec         = BasicCompiledSpec<Char>;
+  using Flag         = BasicFlag<Char>;
+  using Pos          = TPos;
+  using Arg          = BasicArg<Char, Pos>;
+  using Args         = std::pmr::vector<Arg>;
+  using ArgRange     = BasicArgRange<Char, Pos>;
+  using ArgRanges    = std::pmr::vector<ArgRange>;
+  using UnrecognizedFlag = BasicUnrecognizedFlag<Char, Pos>;
+  using Unrecognized = std::pmr::vector<UnrecognizedFlag>;
+  using ArgPos       = typename Args::difference_type;
+  using UnrecognizedPos = typename Unrecognized::difference_type;
+  using FlagPos      = typename Spec::FlagPos;
+  using Instance     = BasicInstance<Char, Pos>;
+  using Instances    = std::pmr::vector<Instance>;
+  using InstancePos  = typename Instances::difference_type;
+  using InputResult  = std::tuple<bool, StringView>;
+  using ErrorInfo    = BasicErrorInfo<Char>;
+  using ErrorString  = std::pmr::basic_string<Char>;
+  using Error        = std::tuple<ErrorInfo, ErrorString>;
+  using Errors       = std::pmr::vector<Error>;
+  using ErrorPos     = typename Errors::size_type;
+  using ErrorInfos   = std::pmr::vector<ErrorInfo>;
+  using EventLog     = BasicEventLog<Char, Pos>;
+  using Resource     = std::pmr::memory_resource;
+  using ArgCallback  = std::function<void(StringView, CLType)>;
+  using InstanceCallback = std::function<void(const Instance&)>;
+  using ErrorCallback = std::function<void(const ErrorInfo&)>;
+
+  // where an opt came from: the position of the opt in argv that it is, or
+  // that it was read for (an @file), and if it was read from a response
+  // file, the name of the file and the offset of the opt in it
+  struct Source {
+    CLType      arg{0};
+    StringView  file{};
+    std::size_t offset{0};
+  };
+
+public:
+  BasicParseResult() = default;
+  explicit BasicParseResult(Resource* resource);
+  explicit BasicParseResult(
+      const Spec& spec, Resource* resource = std::pmr::get_default_resource());
+
+  void clear() noexcept;
+
+  void clear_errors() noexcept;
+
+  // make room for the results of parsing 'args' opts, so that a later parse
+  // of no more opts than this need not allocate
+  void reserve(const CLType args);
+
+  // whether later parses also record their results in the event log (off
+  // by default, since it costs a second write of every result)
+  void keep_events(const bool keep = true) noexcept;
+
+  // whether later parses record the instances, arguments and unrecognized
+  // flags in the event log only, as their one store: get_all_instances(),
+  // get_all_arguments() and get_all_unrecognized_flags() are then empty (as
+  // are the queries of an argument or unrecognized flag by index), while
+  // have_opt(), get_input() and the other queries of a flag by name or
+  // handle read the log. Turning this off keeps the log as well
+  void keep_events_only(const bool only = true) noexcept;
+
+  // whether later parses hold the arguments as runs of consecutive positions
+  // over argv (see get_argument_ranges()) rather than one Arg each
+  void keep_argument_ranges(const bool keep = true) noexcept;
+
+  // hand each argument of later parses to 'callback', as callback(arg, pos),
+  // instead of keeping it (neither as an Arg, nor in the argument ranges or
+  // the event log); an empty callback keeps them again. The limit of
+  // arguments still applies
+  void set_argument_callback(ArgCallback callback);
+
+  // likewise for the instances of 'flag', the unrecognized flags and the
+  // errors (which are not cached either, but has_errors() is still true;
+  // see BasicCompiledSpec::write_error_to() for their strings). With a
+  // callback for every flag as well as the above, a parse keeps nothing and,
+  // once the result has been parsed with the spec once, allocates nothing.
+  // The limits of flags and unrecognized flags still apply
+  void set_flag_callback(const FlagHandle flag, InstanceCallback callback);
+  void set_unrecognized_flag_callback(ArgCallback callback);
+  void set_error_callback(ErrorCallback callback);
+
+  [[nodiscard]] const Spec* spec() const noexcept;
+
+  [[nodiscard]] bool has_errors() const noexcept;
+
+  [[nodiscard]] const Errors& get_all_errors() const noexcept;
+
+  [[nodiscard]] Errors& get_all_errors() noexcept;
+
+  // every instance, argument and unrecognized flag of the last parse, in
+  // command-line order, if keep_events() or keep_events_only() was set (as
+  // parsed: changes made through get_all_instances() are not seen here)
+  [[nodiscard]] const EventLog& events() const noexcept;
+
+  [[nodiscard]] bool have_opt(const StringView name) const;
+  [[nodiscard]] bool has_opt(const StringView name) const;
+  [[nodiscard]] bool have_flag(const StringView name) const;
+  [[nodiscard]] bool has_flag(const StringView name) const;
+
+  [[nodiscard]] Instances& get_all_instances(const StringView name);
+  [[nodiscard]] const Instances& get_all_instances(const StringView name) const;
+
+  [[nodiscard]] bool has_input(const StringView name, const InstancePos pos = -1) const;
+  [[nodiscard]] bool has_input(const Instance& instance) const noexcept;
+
+  [[nodiscard]] InputResult get_input(const StringView name, const InstancePos pos = -1) const;
+  [[nodiscard]] InputResult get_input(const Instance& instance) const noexcept;
+
+  [[nodiscard]] bool is_input_internal(const StringView name, const InstancePos pos = -1) const;
+  [[nodiscard]] bool is_input_internal(const Instance& instance) const noexcept;
+
+  [[nodiscard]] bool is_input_external(const StringView name, const InstancePos pos = -1) const;
+  [[nodiscard]] bool is_input_external(const Instance& instance) const noexcept;
+
+  [[nodiscard]] StringView get_name(const StringView name, const InstancePos pos = -1) const;
+  [[nodiscard]] StringView get_name(const Instance& instance) const noexcept;
+
+  [[nodiscard]] StringView get_opt_name(const StringView name,
+                             const InstancePos pos = -1) const;
+  [[nodiscard]] StringView get_opt_name(const Instance& instance) const noexcept;
+
+  [[nodiscard]] StringView get_flag_name(const StringView name, const InstancePos pos = -1) const;
+  [[nodiscard]] StringView get_flag_name(const Instance& instance) const noexcept;
+
+  [[nodiscard]] CLType get_pos(const StringView name, const InstancePos pos = -1) const;
+  [[nodiscard]] CLType get_pos(const Instance& instance) const noexcept;
+
+  [[nodiscard]] CLType get_subpos(const StringView name, const InstancePos pos = -1) const;
+  [[nodiscard]] CLType get_subpos(const Instance& instance) const noexcept;
+
+  // as above, for the flag of a handle returned by add_bare(), etc.
+  [[nodiscard]] bool have_opt(const FlagHandle flag) const;
+  [[nodiscard]] bool has_opt(const FlagHandle flag) const;
+  [[nodiscard]] bool have_flag(const FlagHandle flag) const;
+  [[nodiscard]] bool has_flag(const FlagHandle flag) const;
+
+  [[nodiscard]] Instances& get_all_instances(const FlagHandle flag);
+  [[nodiscard]] const Instances& get_all_instances(const FlagHandle flag) const;
+
+  [[nodiscard]] bool has_input(const FlagHandle flag, const InstancePos pos = -1) const;
+  [[nodiscard]] InputResult get_input(const FlagHandle flag, const InstancePos pos = -1) const;
+  [[nodiscard]] bool is_input_internal(const FlagHandle flag, const InstancePos pos = -1) const;
+  [[nodiscard]] bool is_input_external(const FlagHandle flag, const InstancePos pos = -1) const;
+  [[nodiscard]] StringView get_name(const FlagHandle flag, const InstancePos pos = -1) const;
+  [[nodiscard]] StringView get_opt_name(const FlagHandle flag, const InstancePos pos = -1) const;
+  [[nodiscard]] StringView get_flag_name(const FlagHandle flag, const InstancePos pos = -1) const;
+  [[nodiscard]] CLType get_pos(const FlagHandle flag, const InstancePos pos = -1) const;
+  [[nodiscard]] CLType get_subpos(const FlagHandle flag, const InstancePos pos = -1) const;
+
+  [[nodiscard]] Unrecognized& get_all_unrecognized_flags() noexcept;
+  [[nodiscard]] const Unrecognized& get_all_unrecognized_flags() const noexcept;
+  [[nodiscard]] Unrecognized& get_all_unrecognized_opts() noexcept;
+  [[nodiscard]] const Unrecognized& get_all_unrecognized_opts() const noexcept;
+
+  [[nodiscard]] UnrecognizedFlag& get_unrecognized_flag(const UnrecognizedPos pos = -1);
+  [[nodiscard]] const UnrecognizedFlag& get_unrecognized_flag(const UnrecognizedPos pos = -1) const;
+  [[nodiscard]] UnrecognizedFlag& get_unrecognized_opt(const UnrecognizedPos pos = -1);
+  [[nodiscard]] const UnrecognizedFlag& get_unrecognized_opt(const UnrecognizedPos pos = -1) const;
+
+  [[nodiscard]] Args& get_all_arguments() noexcept;
+  [[nodiscard]] const Args& get_all_arguments() const noexcept;
+
+  [[nodiscard]] Arg& get_argument(const ArgPos pos = -1);
+  [[nodiscard]] const Arg& get_argument(const ArgPos pos = -1) const;
+
+  // the arguments of the last parse, in order, if keep_argument_ranges() was
+  // set (get_all_arguments() is then empty, except after a BasicParseStream,
+  // which keeps an Arg each instead). Once a stop flag is given, the
+  // rest of argv is not parsed at all but taken as the last range, which is
+  // also the tail (empty if there was no stop flag); it is not checked for
+  // empty arguments. The tail is parsed as usual if the event log is kept or
+  // it would exceed the limit of arguments
+  [[nodiscard]] const ArgRanges& get_argument_ranges() const noexcept;
+  [[nodiscard]] const ArgRange& get_tail() const noexcept;
+
+  // the source of the opt at position 'pos' of the last parse; the opts read
+  // from response files are counted in the positions of the parse, so that
+  // this is needed to find them in argv
+  [[nodiscard]] Source get_source(const CLType pos) const;
+
+  // as the queries above, but rather than throwing, these return std::nullopt
+  // (or nullptr) for an unknown flag, an instance or argument out of range, or
+  // a result that has not been parsed
+  [[nodiscard]] std::optional<bool> try_have_opt(const StringView name) const noexcept;
+  [[nodiscard]] const Instances* try_get_all_instances(const StringView name) const noexcept;
+  [[nodiscard]] std::optional<bool> try_has_input(const StringView name, const InstancePos pos = -1) const noexcept;
+  [[nodiscard]] std::optional<InputResult> try_get_input(const StringView name, const InstancePos pos = -1) const noexcept;
+  [[nodiscard]] std::optional<bool> try_is_input_internal(const StringView name, const InstancePos pos = -1) const noexcept;
+  [[nodiscard]] std::optional<bool> try_is_input_external(const StringView name, const InstancePos pos = -1) const noexcept;
+  [[nodiscard]] std::optional<StringView> try_get_name(const StringView name, const InstancePos pos = -1) const noexcept;
+  [[nodiscard]] std::optional<CLType> try_get_pos(const StringView name, const InstancePos pos = -1) const noexcept;
+  [[nodiscard]] std::optional<CLType> try_get_subpos(const StringView name, const InstancePos pos = -1) const noexcept;
+
+  [[nodiscard]] std::optional<bool> try_have_opt(const FlagHandle flag) const noexcept;
+  [[nodiscard]] const Instances* try_get_all_instances(const FlagHandle flag) const noexcept;
+  [[nodiscard]] std::optional<bool> try_has_input(const FlagHandle flag, const InstancePos pos = -1) const noexcept;
+  [[nodiscard]] std::optional<InputResult> try_get_input(const FlagHandle flag, const InstancePos pos = -1) const noexcept;
+  [[nodiscard]] std::optional<bool> try_is_input_internal(const FlagHandle flag, const InstancePos pos = -1) const noexcept;
+  [[nodiscard]] std::optional<bool> try_is_input_external(const FlagHandle flag, const InstancePos pos = -1) const noexcept;
+  [[nodiscard]] std::optional<StringView> try_get_name(const FlagHandle flag, const InstancePos pos = -1) const noexcept;
+  [[nodiscard]] std::optional<CLType> try_get_pos(const FlagHandle flag, const InstancePos pos = -1) const noexcept;
+  [[nodiscard]] std::optional<CLType> try_get_subpos(const FlagHandle flag, const InstancePos pos = -1) const noexcept;
+
+  [[nodiscard]] const UnrecognizedFlag* try_get_unrecognized_flag(const UnrecognizedPos pos = -1) const noexcept;
+  [[nodiscard]] const Arg* try_get_argument(const ArgPos pos = -1) const noexcept;
+
+  template <typename T>
+  T& write_errors(T& out);
+
+  template <typename T, typename U>
+  T& write_error(T& out, const U pos);
+
+  template <typename T, class... U>
+  T& write_errors_with(T& out, const U... keys);
+
+  template <typename T>
+  T& write_errors_with(T&) = delete;
+
+  // write the errors with a key in 'keys', one per line, straight through
+  // 'out' (e.g. a std::back_inserter or the iterator of std::format_to),
+  // without storing them as strings
+  template <std::output_iterator<const Char&> Out>
+  Out write_errors_to(Out out, const ErrorKeySet keys = ErrorKeySet::all()) const;
+
+  // as above, but in batches through 'sink(const Char* data, size)'
+  template <typename Sink>
+    requires std::invocable<Sink&, const Char*, std::size_t>
+  void write_errors_to_sink(Sink&& sink,
+                            const ErrorKeySet keys = ErrorKeySet::all()) const;
+
+#ifdef DEFPROB_CLUTILS_HAVE_UNISTD
+  // as above, to the file descriptor 'fd'; throws std::system_error if a
+  // write fails
+  void write_errors_to_fd(const int fd,
+                          const ErrorKeySet keys = ErrorKeySet::all()) const
+    requires (sizeof(Char) == 1);
+
+  // as above, but returns the errno of a failed write (or else 0)
+  [[nodiscard]] int try_write_errors_to_fd(
+      const int fd, const ErrorKeySet keys = ErrorKeySet::all()) const
+    requires (sizeof(Char) == 1);
+#endif
+
+private:
+  friend class BasicCompiledSpec<Char>;
+  template <typename, typename, typename> friend class BasicOpts;
+  template <typename, typename, typename> friend class BasicParseStream;
+  template <typename... Flags> friend class StaticOpts;
+
+  void bind(const Spec& spec);
+
+  [[nodiscard]] const Instances& flag_instances(const StringView name) const;
+
+  [[nodiscard]] const Instances& flag_instances(const FlagPos flag) const;
+
+  [[nodiscard]] const Instances& flag_instances(const FlagHandle flag) const;
+
+  [[nodiscard]] const Instances* find_instances(const StringView name)
+      const noexcept;
+
+  [[nodiscard]] const Instances* find_instances(const FlagHandle flag)
+      const noexcept;
+
+  [[nodiscard]] FlagPos flag_index(const StringView name) const;
+
+  [[nodiscard]] FlagPos flag_index(const FlagHandle flag) const;
+
+  [[nodiscard]] std::optional<FlagPos> find_flag_index(const StringView name)
+      const noexcept;
+
+  [[nodiscard]] std::optional<FlagPos> find_flag_index(const FlagHandle flag)
+      const noexcept;
+
+  [[nodiscard]] CLType kept_count(const FlagPos flag) const noexcept;
+
+  [[nodiscard]] std::optional<Instance> find_instance(
+      const std::optional<FlagPos> flag, const InstancePos pos) const noexcept;
+
+  [[nodiscard]] Instance instance_at(const FlagPos flag,
+                                     const InstancePos pos) const;
+
+  void touch(const FlagPos flag);
+
+  [[nodiscard]] CLType instance_count(const FlagPos flag) const noexcept;
+
+  [[nodiscard]] bool is_handed(const FlagPos flag) const noexcept;
+
+  void hand_instance(const FlagPos flag, const Instance& instance);
+
+  void add_instance(const FlagPos flag, const StringView name,
+                    const CLType pos, const CLType subpos,
+                    const StringView input, const InputType type);
+
+  void add_instance(const FlagPos flag, const StringView name,
+                    const CLType pos, const CLType subpos);
+
+  void add_argument(const StringView arg, const CLType pos);
+
+  void add_tail(const CLType pos, const CLType end);
+
+  void append(const BasicParseResult& part);
+
+  void add_unrecognized_flag(const StringView flag, const CLType pos);
+
+  template <typename... T>
+  void register_error(const ErrorKey key, T&&... data);
+
+  void locate_error(ErrorInfo& info) const noexcept;
+
+  void cache_errors();
+
+  template <typename T>
+  [[nodiscard]] bool save_opts(T&);
+
+  template <typename T>
+  [[nodiscard]] bool save_opts(T&& argv);
+
+  template <class... T>
+  void save_opts_pack(T&&... args);
+
+  [[nodiscard]] std::optional<ErrorKey> save_command_line(
+      const StringView line);
+
+  template <typename T>
+  void save_opt(T&& opt);
+
+  void view_opts(const Char* const* argv) noexcept;
+
+  void view_opts(const StringView* views) noexcept;
+
+  template <typename T>
+  void view_opts(T& argv, const CLType start_at);
+
+  [[nodiscard]] ArgRange arg_range(const CLType pos, const CLType size)
+      const noexcept;
+
+#ifdef DEFPROB_CLUTILS_HAVE_MMAN
+  template <typename T>
+  [[nodiscard]] bool expand_response_files(const T argc, Char** argv,
+                                           const T start_at,
+                                           const bool nested)
+    requires (sizeof(Char) == 1);
+
+  void expand_response_file(const StringView opt, const Source& from,
+                            const bool nested,
+                            std::vector<std::size_t>& expanding)
+    requires (sizeof(Char) == 1);
+#endif
+
+private:
+  const Spec*  spec_{nullptr};
+
+  // parsing results
+  std::pmr::vector<Instances> instances_{}; // indexed by flag position
+  std::pmr::vector<FlagPos> touched_{}; // flags given instances, in order
+  bool         instances_lent_{false}; // handed out to be changed
+  Args         args_{};
+  ArgRanges    arg_ranges_{};
+  ArgRange     tail_{};
+  Unrecognized unrecognized_flags_{};
+  Errors       cached_error_strings_{};
+  CLType       collect_unrecognized_flags_count_{0};
+  CLType       collect_args_count_{0};
+
+  // parsing generated data
+  CLOpts       cl_opts_{};  // opts that had to be copied to be parsed
+  std::pmr::vector<String> cl_taken_{}; // opts handed over (and taken as is)
+  CLViews      cl_views_{}; // the saved opts, in order
+  OptString    cl_text_{};  // words of a command line, unquoted
+  ErrorInfos   errors_{};
+  EventLog     events_{};
+  bool         keep_events_{false};
+  bool         events_only_{false}; // the log is the only store
+  bool         keep_ranges_{false};
+
+  // the argv of the last parse, as one of these, from its first opt: kept for
+  // the argument ranges
+  const Char* const* argv_{nullptr};
+  const StringView*  argv_views_{nullptr};
+
+  // the source of each saved opt, if any were read from response files
+  std::pmr::vector<Source> sources_{};
+#ifdef DEFPROB_CLUTILS_HAVE_MMAN
+  // the response files that were read; the opts are views into them
+  std::pmr::vector<std::shared_ptr<helper::MappedFile>> mapped_files_{};
+#endif
+
+  // the results that are handed over rather than kept, and the number of
+  // instances of each flag that were (for its limit)
+  ArgCallback  arg_callback_{};
+  ArgCallback  unrecognized_callback_{};
+  ErrorCallback error_callback_{};
+  std::pmr::vector<InstanceCallback> flag_callbacks_{}; // by flag position
+  std::pmr::vector<CLType> handed_{};                   // by flag position
+  bool         errors_handed_{false};
+
+  // the opts fed to a BasicParseStream that the result refers to; a deque,
+  // since its elements are never moved as it grows. If 'streamed_spare_',
+  // the last one was handed to arg_callback_ and is reused for the next
+  std::pmr::deque<OptString> cl_streamed_{};
+  bool         streamed_spare_{false};
+};
+
+
+
+// BasicParseStream
+//
+// A parse of opts that are fed one at a time as they arrive (e.g., read
+// from a NUL-separated stream, as by xargs -0), rather than all at once:
+// each opt fed is parsed at once, at the next position, and finish() ends
+// the parse as the end of argv would. Every opt that the result would refer
+// to is copied into it, so the opts fed need not outlive the call; those
+// handed to an argument callback (see set_argument_callback()) are not, so
+// that streaming any number of arguments takes no more memory. The copies
+// are not in order in memory, so argument ranges cannot view them: a stream
+// keeps one Arg per argument (see get_all_arguments()) even if the result
+// keeps argument ranges, and get_argument_ranges() stays empty.
+//
+template <typename TChar, typename TPolicy, typename TPos>
+class BasicParseStream {
+public:
+  using Char        = TChar;
+  using value_type  = Char;
+  using StringView  = std::basic_string_view<Char>;
+  using Spec        = BasicCompiledSpec<Char>;
+  using ParseResult = BasicParseResult<Char, TPos>;
+
+  // start a parse with 'spec' into 'res' (which is cleared), both of which
+  // must outlive the stream
+  BasicParseStream(const Spec& spec, ParseResult& res);
+
+  // parse 'opt' at the next position
+  void feed(const StringView opt);
+
+  // end the parse; true if any parsing errors were found
+  bool finish();
+
+  // the number of opts fed so far
+  [[nodiscard]] CLType size() const noexcept;
+
+private:
+  const Spec*  spec_;
+  ParseResult* res_;
+  typename Spec::Parsing prev_{};
+  bool         errors_{false};
+  CLType       pos_{0};
+};
+
+
+
+// BasicOpts
+//
+// Declares the flags and the parsing behaviour and holds the result of the
+// last parse. This is a convenience wrapper around a BasicCompiledSpec and a
+// BasicParseResult; call compile() to obtain a spec that may be parsed with
+// concurrently. The parsing behaviour that 'TPolicy' fixes cannot be set (see
+// RuntimePolicy).
+//
+template <typename TChar, typename TPolicy, typename TPos>
+class BasicOpts {
+public:
+  using Char         = TChar;
+  using Policy       = TPolicy;
+  using value_type   = Char;
+  using StringView   = std::basic_string_view<Char>;
+  using String       = std::basic_string<Char>;
+  using CompiledSpec = BasicCompiledSpec<Char>;
+  using ParseResult  = BasicParseResult<Char, TPos>;
+  using CLOpts       = typename ParseResult::CLOpts;
+  using Name         = BasicName<Char>;
+  using Flag         = BasicFlag<Char>;
+  using Arg          = typename ParseResult::Arg;
+  using Flags        = typename CompiledSpec::Flags;
+  using Args         = typename ParseResult::Args;
+  using ArgRange     = typename ParseResult::ArgRange;
+  using ArgRanges    = typename ParseResult::ArgRanges;
+  using Source       = typename ParseResult::Source;
+  using ArgCallback  = typename ParseResult::ArgCallback;
+  using InstanceCallback = typename ParseResult::InstanceCallback;
+  using ErrorCallback = typename ParseResult::ErrorCallback;
+  using ParseStream  = BasicParseStream<Char, TPolicy, TPos>;
+  using UnrecognizedFlag = typename ParseResult::UnrecognizedFlag;
+  using Unrecognized = typename ParseResult::Unrecognized;
+  using ArgPos       = typename ParseResult::ArgPos;
+  using UnrecognizedPos = typename ParseResult::UnrecognizedPos;
+  using FlagPtr      = typename CompiledSpec::FlagPtr;
+  using NamePtr      = typename CompiledSpec::NamePtr;
+  using SearchRes    = typename CompiledSpec::SearchRes;
+  using Map          = typename CompiledSpec::Map;
+  using Instance     = typename ParseResult::Instance;
+  using Instances    = typename ParseResult::Instances;
+  using InstancePos  = typename Instances::difference_type;
+  using InputResult  = typename ParseResult::InputResult;
+  using ErrorInfo    = BasicErrorInfo<Char>;
+  using ErrorInput   = typename ErrorInfo::ErrorInput;
+  using Error        = typename ParseResult::Error;
+  using Errors       = typename ParseResult::Errors;
+  using ErrorPos     = typename Errors::size_type;
+  using ErrorInfos   = typename ParseResult::ErrorInfos;
+  using Resource     = typename ParseResult::Resource;
+  using ErrorMap     = typename CompiledSpec::ErrorMap;
+  using Keys         = std::vector<ErrorKey>;
+  using CanonNames   = typename CompiledSpec::CanonNames;
+  using FlagMarkers  = typename Flag::FlagMarkers;
+  using LimitType    = typename Flag::LimitType;
+
+public:
+  BasicOpts();
+  explicit BasicOpts(Resource* resource);
+  BasicOpts(const BasicOpts& other);
+  BasicOpts(BasicOpts&& other) noexcept;
+  BasicOpts& operator=(const BasicOpts& other);
+  BasicOpts& operator=(BasicOpts&& other) noexcept;
+  ~BasicOpts() = default;
+
+  template <class... N>
+  FlagHandle add_bare(N&&... names);
+  void add_bare() = delete;
+
+  // as add_bare(), etc., but rather than declaring the flag, return
+  // std::nullopt if a name is empty or is already declared
+  template <class... N>
+    requires (sizeof...(N) > 0
+              && (std::convertible_to<const N&, StringView> && ...))
+  [[nodiscard]] std::optional<FlagHandle> try_add_bare(const N&... names);
+  template <PosType C, class... N>
+    requires (sizeof...(N) > 0
+              && (std::convertible_to<const N&, StringView> && ...))
+  [[nodiscard]] std::optional<FlagHandle> try_add_bare(
+      const C max, const N&... names);
+
+  template <class... N>
+  FlagHandle add_optional(N&&... names);
+  void add_optional() = delete;
+
+  template <class... N>
+    requires (sizeof...(N) > 0
+              && (std::convertible_to<const N&, StringView> && ...))
+  [[nodiscard]] std::optional<FlagHandle> try_add_optional(const N&... names);
+  template <PosType C, class... N>
+    requires (sizeof...(N) > 0
+              && (std::convertible_to<const N&, StringView> && ...))
+  [[nodiscard]] std::optional<FlagHandle> try_add_optional(
+      const C max, const N&... names);
+
+  template <class... N>
+  FlagHandle add_mandatory(N&&... names);
+  void add_mandatory() = delete;
+
+  template <class... N>
+    requires (sizeof...(N) > 0
+              && (std::convertible_to<const N&, StringView> && ...))
+  [[nodiscard]] std::optional<FlagHandle> try_add_mandatory(const N&... names);
+  template <PosType C, class... N>
+    requires (sizeof...(N) > 0
+              && (std::convertible_to<const N&, StringView> && ...))
+  [[nodiscard]] std::optional<FlagHandle> try_add_mandatory(
+      const C max, const N&... names);
+
+  template <class... N>
+  FlagHandle add_stop(N&&... names);
+  void add_stop() = delete;
+
+  template <class... N>
+    requires (sizeof...(N) > 0
+              && (std::convertible_to<const N&, StringView> && ...))
+  [[nodiscard]] std::optional<FlagHandle> try_add_stop(const N&... names);
+  template <PosType C, class... N>
+    requires (sizeof...(N) > 0
+              && (std::convertible_to<const N&, StringView> && ...))
+  [[nodiscard]] std::optional<FlagHandle> try_add_stop(
+      const C max, const N&... names);
+
+  void allow_empty_arguments(const bool state = true) noexcept
+    requires (!TPolicy::empty_arguments.has_value());
+
+  void allow_empty_inputs(const bool state = true) noexcept
+    requires (!TPolicy::empty_inputs.has_value());
+
+  template <PosType T>
+  void allow_arguments(const T max) noexcept
+    requires (TPolicy::arguments.value_or(true));
+
+  void allow_arguments() noexcept
+    requires (TPolicy::arguments.value_or(true));
+
+  template <PosType T>
+  void allow_unrecognized_flags(const T max, const Aggressive state = Aggressive::no) noexcept
+    requires (TPolicy::unrecognized_flags.value_or(true));
+
+  void allow_unrecognized_flags(const Aggressive state = Aggressive::no) noexcept
+    requires (TPolicy::unrecognized_flags.value_or(true));
+
+  template <PosType T>
+  void allow_unrecognized_opts(const T max) noexcept
+    requires (TPolicy::unrecognized_flags.value_or(true));
+
+  void allow_unrecognized_opts() noexcept
+    requires (TPolicy::unrecognized_flags.value_or(true));
+
+  void allow_chaining(const bool state = true) noexcept
+    requires (!TPolicy::chaining.has_value());
+
+  void set_chaining(const bool state = true) noexcept
+    requires (!TPolicy::chaining.has_value());
+
+  void set_no_chaining() noexcept
+    requires (!TPolicy::chaining.has_value());
+
+  void set_greedy(const bool state = true) noexcept
+    requires (!TPolicy::mandatory_greedy.has_value());
+
+  void set_not_greedy() noexcept
+    requires (!TPolicy::mandatory_greedy.has_value());
+
+  void set_lax_greedy() noexcept
+    requires (!TPolicy::mandatory_greedy.has_value());
+
+  void set_greedy(const Greedy state) noexcept
+    requires (!TPolicy::mandatory_greedy.has_value());
+
+  void set_optional_greedy(const bool state = true) noexcept
+    requires (!TPolicy::optional_greedy.has_value());
+
+  void set_optional_not_greedy() noexcept
+    requires (!TPolicy::optional_greedy.has_value());
+
+  template <typename Str>
+  void set_preamble(Str&& str);
+
+  template <typename Str>
+  void set_postscript(Str&& str);
+
+  template <class... Chars, typename = std::common_type_t<Chars...>>
+  void set_flag_markers(Chars... flag_markers);
+
+  template <class... Chars, typename = std::common_type_t<Chars...>>
+  void set_flag_marker(Chars... flag_markers);
+
+  template <class... Chars, typename = std::common_type_t<Chars...>>
+  void add_flag_markers(Chars... flag_markers);
+
+  template <class... Chars, typename = std::common_type_t<Chars...>>
+  void add_flag_marker(Chars... flag_markers);
+
+  template <class... Chars, typename = std::common_type_t<Chars...>>
+  void set_opt_markers(Chars... flag_markers);
+
+  template <class... Chars, typename = std::common_type_t<Chars...>>
+  void set_opt_marker(Chars... flag_markers);
+
+  template <class... Chars, typename = std::common_type_t<Chars...>>
+  void add_opt_markers(Chars... flag_markers);
+
+  template <class... Chars, typename = std::common_type_t<Chars...>>
+  void add_opt_marker(Chars... flag_markers);
+
+  void set_flag_marker() = delete;
+  void set_flag_markers() = delete;
+  void add_flag_marker() = delete;
+  void add_flag_markers() = delete;
+  void set_opt_marker() = delete;
+  void set_opt_markers() = delete;
+  void add_opt_marker() = delete;
+  void add_opt_markers() = delete;
+
+  void set_input_marker(const Char input_marker) noexcept;
+
+  // for parse(argc, argv): response files are read for code units of a
+  // byte, on systems with mmap(); see ResponseFiles
+  void allow_response_files(
+      const ResponseFiles state = ResponseFiles::yes) noexcept;
+
+  void clear() noexcept;
+
+  void clear_errors() noexcept;
+
+  void reserve(const CLType args);
+
+  void keep_events(const bool keep = true) noexcept;
+
+  void keep_events_only(const bool only = true) noexcept;
+
+  void keep_argument_ranges(const bool keep = true) noexcept;
+
+  void set_argument_callback(ArgCallback callback);
+
+  void set_flag_callback(const FlagHandle flag, InstanceCallback callback);
+
+  void set_unrecognized_flag_callback(ArgCallback callback);
+
+  void set_error_callback(ErrorCallback callback);
+
+  void clear_declarations() noexcept;
+
+  void default_error_formats() noexcept;
+
+  [[nodiscard]] CompiledSpec compile();
+
+  // as compile(), but std::nullopt if the declarations have conflicting names
+  [[nodiscard]] std::optional<CompiledSpec> try_compile();
+
+  [[nodiscard]] const ParseResult& result() const noexcept;
+
+  [[nodiscard]] ParseResult& result() noexcept;
+
+  [[nodiscard]] const Errors& get_all_errors() const noexcept;
+
+  [[nodiscard]] Errors& get_all_errors() noexcept;
+
+  [[nodiscard]] const Map& get_map();
 
   [[nodiscard]] bool have_opt(const StringView name) const;
   [[nodiscard]] bool has_opt(const StringView name) const;
@@ -604,15 +2234,34 @@ public:
   [[nodiscard]] CLType get_subpos(const StringView name, const InstancePos pos = -1) const;
   [[nodiscard]] CLType get_subpos(const Instance& instance) const noexcept;
 
+  // as above, for the flag of a handle returned by add_bare(), etc.
+  [[nodiscard]] bool have_opt(const FlagHandle flag) const;
+  [[nodiscard]] bool has_opt(const FlagHandle flag) const;
+  [[nodiscard]] bool have_flag(const FlagHandle flag) const;
+  [[nodiscard]] bool has_flag(const FlagHandle flag) const;
+
+  [[nodiscard]] Instances& get_all_instances(const FlagHandle flag);
+  [[nodiscard]] const Instances& get_all_instances(const FlagHandle flag) const;
+
+  [[nodiscard]] bool has_input(const FlagHandle flag, const InstancePos pos = -1) const;
+  [[nodiscard]] InputResult get_input(const FlagHandle flag, const InstancePos pos = -1) const;
+  [[nodiscard]] bool is_input_internal(const FlagHandle flag, const InstancePos pos = -1) const;
+  [[nodiscard]] bool is_input_external(const FlagHandle flag, const InstancePos pos = -1) const;
+  [[nodiscard]] StringView get_name(const FlagHandle flag, const InstancePos pos = -1) const;
+  [[nodiscard]] StringView get_opt_name(const FlagHandle flag, const InstancePos pos = -1) const;
+  [[nodiscard]] StringView get_flag_name(const FlagHandle flag, const InstancePos pos = -1) const;
+  [[nodiscard]] CLType get_pos(const FlagHandle flag, const InstancePos pos = -1) const;
+  [[nodiscard]] CLType get_subpos(const FlagHandle flag, const InstancePos pos = -1) const;
+
   [[nodiscard]] Unrecognized& get_all_unrecognized_flags() noexcept;
   [[nodiscard]] const Unrecognized& get_all_unrecognized_flags() const noexcept;
   [[nodiscard]] Unrecognized& get_all_unrecognized_opts() noexcept;
   [[nodiscard]] const Unrecognized& get_all_unrecognized_opts() const noexcept;
 
-  [[nodiscard]] Arg& get_unrecognized_flag(const UnrecognizedPos pos = -1);
-  [[nodiscard]] const Arg& get_unrecognized_flag(const UnrecognizedPos pos = -1) const;
-  [[nodiscard]] Arg& get_unrecognized_opt(const UnrecognizedPos pos = -1);
-  [[nodiscard]] const Arg& get_unrecognized_opt(const UnrecognizedPos pos = -1) const;
+  [[nodiscard]] UnrecognizedFlag& get_unrecognized_flag(const UnrecognizedPos pos = -1);
+  [[nodiscard]] const UnrecognizedFlag& get_unrecognized_flag(const UnrecognizedPos pos = -1) const;
+  [[nodiscard]] UnrecognizedFlag& get_unrecognized_opt(const UnrecognizedPos pos = -1);
+  [[nodiscard]] const UnrecognizedFlag& get_unrecognized_opt(const UnrecognizedPos pos = -1) const;
 
   [[nodiscard]] Args& get_all_arguments() noexcept;
   [[nodiscard]] const Args& get_all_arguments() const noexcept;
@@ -620,6 +2269,37 @@ public:
   [[nodiscard]] Arg& get_argument(const ArgPos pos = -1);
   [[nodiscard]] const Arg& get_argument(const ArgPos pos = -1) const;
 
+  [[nodiscard]] const ArgRanges& get_argument_ranges() const noexcept;
+  [[nodiscard]] const ArgRange& get_tail() const noexcept;
+
+  [[nodiscard]] Source get_source(const CLType pos) const;
+
+  // as the queries above, but rather than throwing, these return std::nullopt
+  // (or nullptr) for an unknown flag, an instance or argument out of range, or
+  // a result that has not been parsed
+  [[nodiscard]] std::optional<bool> try_have_opt(const StringView name) const noexcept;
+  [[nodiscard]] const Instances* try_get_all_instances(const StringView name) const noexcept;
+  [[nodiscard]] std::optional<bool> try_has_input(const StringView name, const InstancePos pos = -1) const noexcept;
+  [[nodiscard]] std::optional<InputResult> try_get_input(const StringView name, const InstancePos pos = -1) const noexcept;
+  [[nodiscard]] std::optional<bool> try_is_input_internal(const StringView name, const InstancePos pos = -1) const noexcept;
+  [[nodiscard]] std::optional<bool> try_is_input_external(const StringView name, const InstancePos pos = -1) const noexcept;
+  [[nodiscard]] std::optional<StringView> try_get_name(const StringView name, const InstancePos pos = -1) const noexcept;
+  [[nodiscard]] std::optional<CLType> try_get_pos(const StringView name, const InstancePos pos = -1) const noexcept;
+  [[nodiscard]] std::optional<CLType> try_get_subpos(const StringView name, const InstancePos pos = -1) const noexcept;
+
+  [[nodiscard]] std::optional<bool> try_have_opt(const FlagHandle flag) const noexcept;
+  [[nodiscard]] const Instances* try_get_all_instances(const FlagHandle flag) const noexcept;
+  [[nodiscard]] std::optional<bool> try_has_input(const FlagHandle flag, const InstancePos pos = -1) const noexcept;
+  [[nodiscard]] std::optional<InputResult> try_get_input(const FlagHandle flag, const InstancePos pos = -1) const noexcept;
+  [[nodiscard]] std::optional<bool> try_is_input_internal(const FlagHandle flag, const InstancePos pos = -1) const noexcept;
+  [[nodiscard]] std::optional<bool> try_is_input_external(const FlagHandle flag, const InstancePos pos = -1) const noexcept;
+  [[nodiscard]] std::optional<StringView> try_get_name(const FlagHandle flag, const InstancePos pos = -1) const noexcept;
+  [[nodiscard]] std::optional<CLType> try_get_pos(const FlagHandle flag, const InstancePos pos = -1) const noexcept;
+  [[nodiscard]] std::optional<CLType> try_get_subpos(const FlagHandle flag, const InstancePos pos = -1) const noexcept;
+
+  [[nodiscard]] const UnrecognizedFlag* try_get_unrecognized_flag(const UnrecognizedPos pos = -1) const noexcept;
+  [[nodiscard]] const Arg* try_get_argument(const ArgPos pos = -1) const noexcept;
+
   [[nodiscard]] StringView get_preamble() const;
   [[nodiscard]] StringView get_postscript() const;
 
@@ -637,6 +2317,20 @@ public:
 
   bool parse();
 
+  // see BasicCompiledSpec::parse_command_line()
+  bool parse_command_line(const StringView line);
+
+  // see BasicCompiledSpec::parse_nul_separated()
+  bool parse_nul_separated(std::span<const Char> buf, CLType start_at = 1);
+
+  // start a parse of opts fed one at a time; see BasicParseStream
+  [[nodiscard]] ParseStream stream();
+
+  // see BasicCompiledSpec::parse_parallel()
+  template <PosType T>
+  bool parse_parallel(T argc, Char** argv, T start_at = 1,
+                      unsigned int threads = 0);
+
   template <typename Str>
   void format_error(const ErrorKey key, Str&& str);
 
@@ -652,143 +2346,231 @@ public:
   template <typename T>
   T& write_errors_with(T&) = delete;
 
+  template <std::output_iterator<const Char&> Out>
+  Out write_errors_to(Out out, const ErrorKeySet keys = ErrorKeySet::all()) const;
+
+  template <typename Sink>
+    requires std::invocable<Sink&, const Char*, std::size_t>
+  void write_errors_to_sink(Sink&& sink,
+                            const ErrorKeySet keys = ErrorKeySet::all()) const;
+
+#ifdef DEFPROB_CLUTILS_HAVE_UNISTD
+  void write_errors_to_fd(const int fd,
+                          const ErrorKeySet keys = ErrorKeySet::all()) const
+    requires (sizeof(Char) == 1);
+
+  [[nodiscard]] int try_write_errors_to_fd(
+      const int fd, const ErrorKeySet keys = ErrorKeySet::all()) const
+    requires (sizeof(Char) == 1);
+#endif
+
   [[nodiscard]] CanonNames registered_flags() const;
   [[nodiscard]] CanonNames registered_opts() const;
 
 private:
-  [[nodiscard]] String get_error_string(const ErrorKey key) const;
+  void apply_policy() noexcept;
 
-  void guess_types();
+  template <class... N>
+  [[nodiscard]] bool can_declare(const N&... names) const;
 
-  void create_map();
+private:
+  template <typename... Flags> friend class StaticOpts;
 
-  template <typename... T>
-  void register_error(const ErrorKey key, T&&... data);
+  CompiledSpec spec_{};
+  ParseResult  result_{}; // always bound to spec_
+};
 
-  void cache_errors();
 
-  [[nodiscard]] String create_error_string(const ErrorInfo& error) const;
 
-  [[nodiscard]] String get_error_string_prototype(const ErrorKey key) const;
+// BasicFixedString
+//
+// A string literal that may be given as a template argument, such as the name
+// of a flag declared at compile time (e.g., Static::Bare<"-h", "--help">).
+//
+template <typename TChar, std::size_t N>
+struct BasicFixedString {
+  using Char       = TChar;
+  using value_type = Char;
+  using StringView = std::basic_string_view<Char>;
 
-  void convert_error_str(String& str, const ErrorInfo& error) const;
+  constexpr BasicFixedString(const Char (&str)[N]) noexcept;
 
-  [[nodiscard]] SearchAll search_flag_all(const StringView opt,
-                                          const bool short_only) const;
+  [[nodiscard]] constexpr StringView view() const noexcept;
 
-  [[nodiscard]] SearchRes search_flag(const StringView opt, const bool stop,
-                                      const bool short_only = false) const;
+  Char data[N]{};
+};
 
-  [[nodiscard]] bool opt_is_flag(const StringView opt) const;
 
-  [[nodiscard]] bool opt_is_arg(const StringView opt) const;
+namespace Static {
 
-  void add_unrecognized_flag(const StringView flag, const CLType pos);
+// Flag
+//
+// A flag declared at compile time: its class, the number of times it may
+// appear on the command-line and its names. Use the aliases below, e.g.
+// Static::Mandatory<"-o", "--output">.
+//
+template <FlagClass Class, CLType Max, BasicFixedString... Names>
+struct Flag {
+  static_assert(sizeof...(Names) > 0, "a flag must have at least one name");
 
-  void add_argument(const StringView arg, const CLType pos);
+  using Char = typename std::remove_cvref_t<
+      decltype(std::get<0>(std::tuple{Names...}))>::Char;
+  using StringView = std::basic_string_view<Char>;
 
-  [[nodiscard]] bool handle_unrecognized(const StringView opt,
-                                         const CLType pos, const bool stop);
+  static_assert(
+      (std::is_same_v<typename std::remove_cvref_t<decltype(Names)>::Char,
+                      Char> && ...),
+      "the names of a flag must all have the same character type");
 
-  [[nodiscard]] bool check_within_limit(const FlagPtr pflag,
-                                        const NamePtr pname,
-                                        const CLType pos, const bool is_flag);
+  static constexpr FlagClass flag_class = Class;
+  static constexpr CLType    max        = Max;
+  static constexpr std::array<StringView, sizeof...(Names)> names{
+      Names.view()...};
 
-  [[nodiscard]] bool check_within_limit(const Parsing& prev, const CLType pos,
-                                        const bool is_flag,
-                                        const bool check_subpos = false);
+  [[nodiscard]] static constexpr bool has_name(const StringView name) noexcept;
+};
 
-  [[nodiscard]] bool add_instance(const Parsing& prev, const CLType pos,
-                                  const StringView input);
+template <BasicFixedString... Names>
+using Bare = Flag<FlagClass::bare, std::numeric_limits<CLType>::max(), Names...>;
 
-  void add_instance(const Parsing& prev, const CLType pos);
+template <BasicFixedString... Names>
+using Optional =
+    Flag<FlagClass::optional, std::numeric_limits<CLType>::max(), Names...>;
 
-  void add_instance(const FlagPtr pflag, const NamePtr pname,
-                    const CLType pos, const CLType subpos);
+template <BasicFixedString... Names>
+using Mandatory =
+    Flag<FlagClass::mandatory, std::numeric_limits<CLType>::max(), Names...>;
 
-  void add_instance(const FlagPtr pflag, const NamePtr pname,
-                    const CLType pos);
+template <BasicFixedString... Names>
+using Stop = Flag<FlagClass::stop, std::numeric_limits<CLType>::max(), Names...>;
 
-  [[nodiscard]] bool add_instance(const FlagPtr pflag, const NamePtr pname,
-                                  const CLType pos, const CLType subpos,
-                                  const StringView input, const InputType type);
+} // namespace Static
 
-  [[nodiscard]] bool add_instance(const FlagPtr pflag, const NamePtr pname,
-                                  const CLType pos, const StringView input,
-                                  const InputType type);
 
-  [[nodiscard]] bool are_collecting_args() const noexcept;
 
-  [[nodiscard]] bool args_within_limit() const noexcept;
+// StaticOpts
+//
+// Flags declared at compile time, for example:
+//
+//   StaticOpts<Static::Bare<"-h", "--help">,
+//              Static::Mandatory<"-o", "--output">> cl;
+//   cl.parse(argc, argv);
+//   if (cl.have_opt<"--help">()) ...
+//
+// The flag names are checked for conflicts by the compiler, and a query names
+// its flag by template argument, which is resolved to the position of the flag
+// at compile time, so that querying looks up no names. The names are also
+// sorted into a table at compile time, which the parser searches for the
+// longest name that an opt begins with in place of the name map and trie
+// that a BasicOpts builds. Otherwise a StaticOpts parses with a
+// BasicCompiledSpec built from its declarations (and whatever else the
+// constructor's 'configure' callback sets on a BasicOpts), so the results are
+// those of a BasicOpts declared alike. Should 'configure' declare flags of
+// its own, the table would not know them, and the map is built as usual.
+//
+template <typename... Flags>
+class StaticOpts {
+  static_assert(sizeof...(Flags) > 0, "at least one flag must be declared");
 
-  [[nodiscard]] bool are_collecting_unrecognized_flags() const noexcept;
+public:
+  using Char         = typename std::tuple_element_t<0, std::tuple<Flags...>>::Char;
+  using value_type   = Char;
+  using StringView   = std::basic_string_view<Char>;
+  using Opts         = BasicOpts<Char>;
+  using CompiledSpec = BasicCompiledSpec<Char>;
+  using ParseResult  = BasicParseResult<Char>;
+  using FlagPos      = typename CompiledSpec::FlagPos;
+  using Instance     = typename ParseResult::Instance;
+  using Instances    = typename ParseResult::Instances;
+  using InstancePos  = typename ParseResult::InstancePos;
+  using InputResult  = typename ParseResult::InputResult;
 
-  [[nodiscard]] bool unrecognized_flags_within_limit() const noexcept;
+  static_assert((std::is_same_v<typename Flags::Char, Char> && ...),
+                "all flags must have the same character type");
 
-  [[nodiscard]] bool optional_can_take_no_input() const noexcept;
+  static constexpr FlagPos flag_count = sizeof...(Flags);
 
-  [[nodiscard]] bool mandatory_and_greedy(const Parsing& prev) const noexcept;
+private:
+  using StaticName = typename CompiledSpec::StaticName;
 
-  [[nodiscard]] bool optional_and_greedy(const Parsing& prev) const noexcept;
+  static constexpr std::size_t name_count = (Flags::names.size() + ...);
 
-  template <typename T>
-  [[nodiscard]] bool save_opts(T&);
+public:
+  StaticOpts();
 
-  template <typename T>
-  [[nodiscard]] bool save_opts(T&& argv);
+  template <typename F>
+    requires std::invocable<F&, Opts&>
+  explicit StaticOpts(F&& configure);
+
+  StaticOpts(const StaticOpts& other);
+  StaticOpts(StaticOpts&& other) noexcept;
+  StaticOpts& operator=(const StaticOpts& other);
+  StaticOpts& operator=(StaticOpts&& other) noexcept;
+  ~StaticOpts() = default;
+
+  // the position of the flag named 'Name' in the declarations; naming an
+  // undeclared flag is a compile error
+  template <BasicFixedString Name>
+  [[nodiscard]] static consteval FlagPos flag_pos() noexcept;
+
+  [[nodiscard]] const CompiledSpec& spec() const noexcept;
+
+  [[nodiscard]] const ParseResult& result() const noexcept;
+
+  [[nodiscard]] ParseResult& result() noexcept;
 
   template <class... T>
-  void save_opts_pack(T&&... args);
+  bool parse(T&&... args);
 
-  void parse_opt(const CLType pos, const StringView opt, Parsing& prev,
-                 bool& errors);
+  template <BasicFixedString Name>
+  [[nodiscard]] bool have_opt() const;
 
-  void parse_opt_finish(const CLType last_pos, Parsing& prev, bool& errors);
+  template <BasicFixedString Name>
+  [[nodiscard]] const Instances& get_all_instances() const;
 
-  [[nodiscard]] bool parse_short_opt(const StringView opt, const FlagPtr pflag,
-                                     const NamePtr pname, const CLType pos,
-                                     Parsing& prev);
+  template <BasicFixedString Name>
+  [[nodiscard]] bool has_input(const InstancePos pos = -1) const;
 
-  [[nodiscard]] bool parse_long_opt(const StringView opt, const FlagPtr pflag,
-                                    const NamePtr pname, const CLType pos,
-                                    Parsing& prev);
+  template <BasicFixedString Name>
+  [[nodiscard]] InputResult get_input(const InstancePos pos = -1) const;
+
+  template <BasicFixedString Name>
+  [[nodiscard]] bool is_input_internal(const InstancePos pos = -1) const;
+
+  template <BasicFixedString Name>
+  [[nodiscard]] bool is_input_external(const InstancePos pos = -1) const;
+
+  template <BasicFixedString Name>
+  [[nodiscard]] StringView get_name(const InstancePos pos = -1) const;
+
+  template <BasicFixedString Name>
+  [[nodiscard]] CLType get_pos(const InstancePos pos = -1) const;
+
+  template <BasicFixedString Name>
+  [[nodiscard]] CLType get_subpos(const InstancePos pos = -1) const;
 
 private:
-  // parsing behaviour
-  bool         allow_empty_arg_{false};
-  bool         allow_empty_input_{false};
-  bool         can_chain_{true};
-  Greedy       mandatory_greedy_{Greedy::no};
-  bool         optional_greedy_{false};
-  bool         unrecognized_greedy_{false};
-  CLType       collect_unrecognized_flags_{0};
-  CLType       collect_unrecognized_flags_count_{0};
-  CLType       collect_args_{0};
-  CLType       collect_args_count_{0};
+  [[nodiscard]] static consteval bool names_nonempty() noexcept;
+  [[nodiscard]] static consteval bool names_unique() noexcept;
 
-  // user-defined formatting
-  String       preamble_{};
-  String       postscript_{};
-  ErrorMap     custom_error_message_{};
+  static_assert(names_nonempty(), "flag names must not be empty");
+  static_assert(names_unique(), "a flag name is declared more than once");
 
-  // flag characteristics
-  FlagMarkers   flag_markers_{static_cast<Char>('-')};
-  Char         input_marker_{static_cast<Char>('=')};
+  [[nodiscard]] static consteval std::array<StaticName, name_count>
+      name_table() noexcept;
 
-  // parsing results (also flag declarations)
-  Flags        flags_{};
-  Args         args_{};
-  Unrecognized unrecognized_flags_{};
-  Errors       cached_error_strings_{};
+  template <typename F>
+  [[nodiscard]] static CompiledSpec declare(F& configure);
 
-  // parsing generated data
-  CLOpts       cl_opts_{};
-  Map          map_{};
-  ErrorInfos   errors_{};
+  template <typename Flag>
+  static void declare_flag(Opts& opts);
 
-  // internal (helper) switches
-  bool         flag_type_tainted_{true};
-  bool         map_tainted_{true};
+  template <BasicFixedString Name>
+  [[nodiscard]] Instance instance(const InstancePos pos) const;
+
+private:
+  CompiledSpec spec_;
+  ParseResult  result_; // always bound to spec_
 };
 
 
@@ -799,6 +2581,18 @@ using U8Opts  = BasicOpts<char8_t>;
 using U16Opts = BasicOpts<char16_t>;
 using U32Opts = BasicOpts<char32_t>;
 
+using CompiledSpec    = BasicCompiledSpec<char>;
+using WCompiledSpec   = BasicCompiledSpec<wchar_t>;
+using U8CompiledSpec  = BasicCompiledSpec<char8_t>;
+using U16CompiledSpec = BasicCompiledSpec<char16_t>;
+using U32CompiledSpec = BasicCompiledSpec<char32_t>;
+
+using ParseResult    = BasicParseResult<char>;
+using WParseResult   = BasicParseResult<wchar_t>;
+using U8ParseResult  = BasicParseResult<char8_t>;
+using U16ParseResult = BasicParseResult<char16_t>;
+using U32ParseResult = BasicParseResult<char32_t>;
+
 } // namespace CLUtils
 
 #include <clutils.tcc>
@@ -150,6 +150,10 @@ struct ErrorStrings {
   static constexpr const char* stopproscribed{"error: arg %pos: %type \u2018%opt\u2019: stop %opt may not be present."};
 
   static constexpr const char* stopproscribed_{"error: arg %pos, subpos %subpos: %type \u2018%opt\u2019: stop %opt may not be present."};
+
+  static constexpr const char* unclosed_quote{"error: arg %pos: %type \u2018%opt\u2019: quote not closed at the end of the line."};
+
+  static constexpr const char* trailing_escape{"error: arg %pos: %type \u2018%opt\u2019: backslash at the end of the line escapes nothing."};
 };
 
 template <>
@@ -189,6 +193,10 @@ struct ErrorStrings<char8_t> {
   static constexpr const char8_t* stopproscribed{u8"error: arg %pos: %type \u2018%opt\u2019: stop %opt may not be present."};
 
   static constexpr const char8_t* stopproscribed_{u8"error: arg %pos, subpos %subpos: %type \u2018%opt\u2019: stop %opt may not be present."};
+
+  static constexpr const char8_t* unclosed_quote{u8"error: arg %pos: %type \u2018%opt\u2019: quote not closed at the end of the line."};
+
+  static constexpr const char8_t* trailing_escape{u8"error: arg %pos: %type \u2018%opt\u2019: backslash at the end of the line escapes nothing."};
 };
 
 template <>
@@ -228,6 +236,10 @@ struct ErrorStrings<char16_t> {
   static constexpr const char16_t* stopproscribed{u"error: arg %pos: %type \u2018%opt\u2019: stop %opt may not be present."};
 
   static constexpr const char16_t* stopproscribed_{u"error: arg %pos, subpos %subpos: %type \u2018%opt\u2019: stop %opt may not be present."};
+
+  static constexpr const char16_t* unclosed_quote{u"error: arg %pos: %type \u2018%opt\u2019: quote not closed at the end of the line."};
+
+  static constexpr const char16_t* trailing_escape{u"error: arg %pos: %type \u2018%opt\u2019: backslash at the end of the line escapes nothing."};
 };
 
 template <>
@@ -267,6 +279,10 @@ struct ErrorStrings<char32_t> {
   static constexpr const char32_t* stopproscribed{U"error: arg %pos: %type \u2018%opt\u2019: stop %opt may not be present."};
 
   static constexpr const char32_t* stopproscribed_{U"error: arg %pos, subpos %subpos: %type \u2018%opt\u2019: stop %opt may not be present."};
+
+  static constexpr const char32_t* unclosed_quote{U"error: arg %pos: %type \u2018%opt\u2019: quote not closed at the end of the line."};
+
+  static constexpr const char32_t* trailing_escape{U"error: arg %pos: %type \u2018%opt\u2019: backslash at the end of the line escapes nothing."};
 };
 
 template <>
@@ -306,12 +322,482 @@ struct ErrorStrings<wchar_t> {
   static constexpr const wchar_t* stopproscribed{L"error: arg %pos: %type \u2018%opt\u2019: stop %opt may not be present."};
 
   static constexpr const wchar_t* stopproscribed_{L"error: arg %pos, subpos %subpos: %type \u2018%opt\u2019: stop %opt may not be present."};
+
+  static constexpr const wchar_t* unclosed_quote{L"error: arg %pos: %type \u2018%opt\u2019: quote not closed at the end of the line."};
+
+  static constexpr const wchar_t* trailing_escape{L"error: arg %pos: %type \u2018%opt\u2019: backslash at the end of the line escapes nothing."};
+};
+
+// throw an 'E' made from 'args' or, if built without exceptions, print its
+// message and abort
+template <typename E, typename... A>
+[[noreturn]] void raise(A&&... args) {
+#ifdef DEFPROB_CLUTILS_NO_EXCEPTIONS
+  const E error(std::forward<A>(args)...);
+  std::fprintf(stderr, "libclutils: %s\n", error.what());
+  std::abort();
+#else
+  throw E(std::forward<A>(args)...);
+#endif
+}
+
+// a share of the work item indices given to one worker thread; its
+// owner takes indices from the front, as do other workers once they have
+// run out of their own
+struct alignas(64) WorkRange {
+  std::atomic<std::size_t> next{0};
+  std::size_t              end{0};
+};
+
+// call 'work(i)' for every i in [0, count), spread over 'threads' threads
+// (one of which is the calling thread). The first exception thrown by
+// 'work' on any thread is rethrown once all threads are done.
+template <typename F>
+void run_work_stealing(const std::size_t count, unsigned int threads,
+                       F&& work) {
+  if (count == 0) {
+    return;
+  }
+  if (threads == 0) {
+    threads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  if (threads > count) {
+    threads = static_cast<unsigned int>(count);
+  }
+
+  std::vector<WorkRange> ranges(threads);
+  for (unsigned int t = 0; t < threads; ++t) {
+    ranges[t].next.store(count * t / threads, std::memory_order_relaxed);
+    ranges[t].end = count * (t + 1) / threads;
+  }
+
+  // own range first, then steal from the others in turn
+  const auto steal = [&](const unsigned int self) {
+    for (unsigned int k = 0; k < threads; ++k) {
+      auto& range = ranges[(self + k) % threads];
+      for (std::size_t i;
+           (i = range.next.fetch_add(1, std::memory_order_relaxed))
+             < range.end; ) {
+        work(i);
+      }
+    }
+  };
+
+#ifdef DEFPROB_CLUTILS_NO_EXCEPTIONS
+  std::vector<std::thread> pool;
+  pool.reserve(threads - 1);
+  for (unsigned int t = 1; t < threads; ++t) {
+    pool.emplace_back(steal, t);
+  }
+  steal(0);
+  for (auto& thread: pool) {
+    thread.join();
+  }
+#else
+  std::vector<std::exception_ptr> failures(threads);
+  const auto worker = [&](const unsigned int self) {
+    try {
+      steal(self);
+    }
+    catch (...) {
+      failures[self] = std::current_exception();
+    }
+  };
+
+  std::vector<std::thread> pool;
+  pool.reserve(threads - 1);
+  try {
+    for (unsigned int t = 1; t < threads; ++t) {
+      pool.emplace_back(worker, t);
+    }
+  }
+  catch (const std::system_error&) {
+    // could not start as many threads as asked for; the ranges of the
+    // threads that never started will be stolen by those that did
+  }
+  worker(0);
+  for (auto& thread: pool) {
+    thread.join();
+  }
+
+  for (const auto& failure: failures) {
+    if (failure) {
+      std::rethrow_exception(failure);
+    }
+  }
+#endif
+}
+
+// how a character of a command line is taken when it is not quoted: looked
+// up in a table for code units of a byte, so that the run of plain
+// characters that makes up most words is skipped with one load and test per
+// character
+enum class ShellClass : std::uint8_t { plain, space, special };
+
+template <typename TChar>
+[[nodiscard]] constexpr ShellClass shell_class_of(const TChar c) noexcept {
+  switch (c) {
+    case ' ': case '\t': case '\n': case '\r': case '\f': case '\v':
+      return ShellClass::space;
+    case '\'': case '"': case '\\':
+      return ShellClass::special;
+    default:
+      return ShellClass::plain;
+  }
+}
+
+inline constexpr auto shell_classes = [] {
+  std::array<ShellClass, 256> ret{};
+  for (std::size_t i = 0; i < ret.size(); ++i) {
+    ret[i] = shell_class_of(static_cast<char>(i));
+  }
+  return ret;
+}();
+
+template <typename TChar>
+[[nodiscard]] constexpr ShellClass shell_class(const TChar c) noexcept {
+  if constexpr (sizeof(TChar) == 1) {
+    return shell_classes[static_cast<unsigned char>(c)];
+  }
+  else {
+    return shell_class_of(c);
+  }
+}
+
+// split 'line' into words as a POSIX shell would, handing each over as
+// emit(word). A word with nothing to unquote is a view into 'line'; the
+// others are unquoted onto the end of 'text', which must have room for them
+// so as not to move the words already handed over. Within "...", a
+// backslash only escapes $, `, ", \ and a newline; an escaped newline is
+// removed, as a line continuation. A shell would not accept a line that
+// ends within a quote or with a backslash, which is returned as an error
+// (the last word is still handed over, as if the line had been closed)
+template <typename TChar, typename Text, typename F>
+[[nodiscard]] std::optional<ErrorKey> tokenize_command_line(
+      const std::basic_string_view<TChar> line, Text& text, F&& emit) {
+  const auto escapable = [](const TChar c) {
+    return c == '$' || c == '`' || c == '"' || c == '\\' || c == '\n';
+  };
+  const std::size_t end = line.size();
+  std::size_t p = 0;
+  while (true) {
+    // (a line continuation between words is as whitespace)
+    while (p != end) {
+      if (shell_class(line[p]) == ShellClass::space) {
+        ++p;
+      }
+      else if (line[p] == '\\' && p + 1 != end && line[p + 1] == '\n') {
+        p += 2;
+      }
+      else {
+        break;
+      }
+    }
+    if (p == end) {
+      return std::nullopt;
+    }
+
+    // the plain run at the start of the word
+    const std::size_t first = p;
+    while (p != end && shell_class(line[p]) == ShellClass::plain) {
+      ++p;
+    }
+    if (p == end || shell_class(line[p]) == ShellClass::space) {
+      emit(line.substr(first, p - first));
+      continue;
+    }
+
+    // the rest of the word is unquoted into 'text'
+    const std::size_t out = text.size();
+    text.append(line.data() + first, p - first);
+    TChar quote = 0;
+    bool escaping = false;
+    for (; p != end; ++p) {
+      const TChar c = line[p];
+      if (quote == '\'') {
+        if (c == '\'') {
+          quote = 0;
+        }
+        else {
+          text.push_back(c);
+        }
+      }
+      else if (quote == '"') {
+        if (c == '"') {
+          quote = 0;
+        }
+        else if (c == '\\' && p + 1 != end && escapable(line[p + 1])) {
+          if (line[++p] != '\n') {
+            text.push_back(line[p]);
+          }
+        }
+        else {
+          text.push_back(c);
+        }
+      }
+      else if (shell_class(c) == ShellClass::space) {
+        break;
+      }
+      else if (c == '\'' || c == '"') {
+        quote = c;
+      }
+      else if (c == '\\') {
+        if (p + 1 == end) {
+          escaping = true;
+        }
+        else if (line[++p] != '\n') {
+          text.push_back(line[p]);
+        }
+      }
+      else {
+        text.push_back(c);
+      }
+    }
+    emit(std::basic_string_view<TChar>{text.data() + out, text.size() - out});
+    if (quote != 0) {
+      return ErrorKey::UnclosedQuote;
+    }
+    if (escaping) {
+      return ErrorKey::TrailingEscape;
+    }
+  }
+}
+
+#ifdef DEFPROB_CLUTILS_HAVE_MMAN
+// a response file, mapped privately so that its opts can be unquoted in
+// place without writing to the file; only the pages that are written to
+// are copied
+class MappedFile {
+public:
+  MappedFile() = default;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  ~MappedFile() {
+    if (data_ != nullptr) {
+      ::munmap(data_, size_);
+    }
+  }
+
+  // 0, or the errno of the failure
+  [[nodiscard]] int open(std::string name) {
+    name_ = std::move(name);
+    const int fd = ::open(name_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      return errno;
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+      const int err = errno;
+      ::close(fd);
+      return err;
+    }
+    if (!S_ISREG(st.st_mode)) {
+      ::close(fd);
+      return EINVAL;
+    }
+    dev_ = st.st_dev;
+    ino_ = st.st_ino;
+    size_ = static_cast<std::size_t>(st.st_size);
+    if (size_ > 0) {
+      void* data = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                          fd, 0);
+      if (data == MAP_FAILED) {
+        const int err = errno;
+        ::close(fd);
+        size_ = 0;
+        return err;
+      }
+      data_ = static_cast<char*>(data);
+    }
+    ::close(fd);
+    return 0;
+  }
+
+  [[nodiscard]] char* data() const noexcept { return data_; }
+  [[nodiscard]] std::size_t size() const noexcept { return size_; }
+  [[nodiscard]] const std::string& name() const noexcept { return name_; }
+
+  [[nodiscard]] bool same_file(const MappedFile& other) const noexcept {
+    return dev_ == other.dev_ && ino_ == other.ino_;
+  }
+
+private:
+  char*       data_{nullptr};
+  std::size_t size_{0};
+  dev_t       dev_{};
+  ino_t       ino_{};
+  std::string name_{};
+};
+
+// split [first, last) into opts as a shell would: at whitespace, except
+// within '...' or "...", and with a backslash taking the next character as
+// it is, except within '...'. The opts are unquoted in place, and each is
+// handed over as emit(opt, size, offset of the opt in the file)
+template <typename TChar, typename F>
+void tokenize_response_file(TChar* const first, TChar* const last, F&& emit) {
+  const auto is_space = [](const TChar c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f'
+             || c == '\v';
+  };
+  TChar* p = first;
+  while (true) {
+    while (p != last && is_space(*p)) {
+      ++p;
+    }
+    if (p == last) {
+      return;
+    }
+    TChar* const opt = p;
+    TChar* out = p;
+    TChar quote = 0;
+    for (; p != last; ++p) {
+      if (quote == 0 && is_space(*p)) {
+        break;
+      }
+      if (quote != 0 && *p == quote) {
+        quote = 0;
+        continue;
+      }
+      if (quote == 0 && (*p == '\'' || *p == '"')) {
+        quote = *p;
+        continue;
+      }
+      if (*p == '\\' && quote != '\'' && p + 1 != last) {
+        ++p;
+      }
+      // an opt with nothing to unquote is left untouched (and unwritten)
+      if (out != p) {
+        *out = *p;
+      }
+      ++out;
+    }
+    emit(opt, static_cast<std::size_t>(out - opt),
+         static_cast<std::size_t>(opt - first));
+  }
+}
+#endif
+
+// an output iterator that gathers characters into batches and hands each
+// batch to a sink, as sink(data, size)
+template <typename TChar, typename Sink>
+class BatchWriter {
+public:
+  class iterator {
+  public:
+    using difference_type = std::ptrdiff_t;
+
+    iterator() = default;
+    explicit iterator(BatchWriter& writer) noexcept : writer_{&writer} {}
+
+    iterator& operator=(const TChar c) {
+      writer_->put(c);
+      return *this;
+    }
+    iterator& operator*() noexcept { return *this; }
+    iterator& operator++() noexcept { return *this; }
+    iterator& operator++(int) noexcept { return *this; }
+
+  private:
+    BatchWriter* writer_{nullptr};
+  };
+
+  explicit BatchWriter(Sink& sink) noexcept : sink_{sink} {}
+
+  [[nodiscard]] iterator begin() noexcept {
+    return iterator{*this};
+  }
+
+  void put(const TChar c) {
+    if (size_ == buffer_.size()) {
+      flush();
+    }
+    buffer_[size_++] = c;
+  }
+
+  void flush() {
+    if (size_ > 0) {
+      sink_(static_cast<const TChar*>(buffer_.data()), size_);
+      size_ = 0;
+    }
+  }
+
+private:
+  Sink&                                   sink_;
+  std::array<TChar, 4096 / sizeof(TChar)> buffer_;
+  std::size_t                             size_{0};
 };
 
 } // namespace helper
 
 
 
+// ErrorKeySet
+
+constexpr ErrorKeySet::ErrorKeySet(std::initializer_list<ErrorKey> keys)
+      noexcept {
+  for (const auto key: keys) {
+    insert(key);
+  }
+}
+
+[[nodiscard]] constexpr ErrorKeySet ErrorKeySet::all() noexcept {
+  ErrorKeySet ret;
+  ret.bits_ = ~std::uint32_t{0};
+  return ret;
+}
+
+constexpr ErrorKeySet& ErrorKeySet::insert(const ErrorKey key) noexcept {
+  bits_ |= bit(key);
+  return *this;
+}
+
+[[nodiscard]] constexpr bool ErrorKeySet::contains(const ErrorKey key)
+      const noexcept {
+  return (bits_ & bit(key)) != 0;
+}
+
+[[nodiscard]] constexpr std::uint32_t ErrorKeySet::bit(const ErrorKey key)
+      noexcept {
+  switch (key) {
+  case ErrorKey::ArgEmpty:        return std::uint32_t{1} << 0;
+  case ErrorKey::Unrecognized:    return std::uint32_t{1} << 1;
+  case ErrorKey::Surplus:         return std::uint32_t{1} << 2;
+  case ErrorKey::Surplus_:        return std::uint32_t{1} << 3;
+  case ErrorKey::Proscribed:      return std::uint32_t{1} << 4;
+  case ErrorKey::Proscribed_:     return std::uint32_t{1} << 5;
+  case ErrorKey::StopProscribed:  return std::uint32_t{1} << 6;
+  case ErrorKey::StopProscribed_: return std::uint32_t{1} << 7;
+  case ErrorKey::EmptyInput:      return std::uint32_t{1} << 8;
+  case ErrorKey::EmptyInput_:     return std::uint32_t{1} << 9;
+  case ErrorKey::BareEmptyInput:  return std::uint32_t{1} << 10;
+  case ErrorKey::StopEmptyInput:  return std::uint32_t{1} << 11;
+  case ErrorKey::BareInput:       return std::uint32_t{1} << 12;
+  case ErrorKey::BareInput_:      return std::uint32_t{1} << 13;
+  case ErrorKey::StopInput:       return std::uint32_t{1} << 14;
+  case ErrorKey::StopInput_:      return std::uint32_t{1} << 15;
+  case ErrorKey::MissingInput:    return std::uint32_t{1} << 16;
+  case ErrorKey::MissingInput_:   return std::uint32_t{1} << 17;
+  case ErrorKey::UnclosedQuote:   return std::uint32_t{1} << 18;
+  case ErrorKey::TrailingEscape:  return std::uint32_t{1} << 19;
+  }
+  return 0;
+}
+
+
+
+// FlagHandle
+
+constexpr FlagHandle::FlagHandle(const FlagPos pos) noexcept
+  : pos_{pos}
+{}
+
+[[nodiscard]] constexpr auto FlagHandle::pos() const noexcept -> FlagPos {
+  return pos_;
+}
+
+
+
 // BasicName
 
 template <typename TChar>
@@ -343,7 +829,7 @@ BasicName<TChar>::BasicName(const T& name, const FlagType type)
 template <typename TChar>
 void BasicName<TChar>::check_name() const {
   if (name().empty()) {
-    throw FlagNameError("flag declaration error: flag name empty");
+    helper::raise<FlagNameError>("flag declaration error: flag name empty");
   }
 }
 
@@ -411,29 +897,224 @@ void BasicName<TChar>::guess_type(
 
 // BasicArg
 
-template <typename TChar>
-BasicArg<TChar>::BasicArg(
-      const StringView name, const CLType pos, const CLType subpos)
-  : name_{name}, pos_{pos}, subpos_{subpos}
+template <typename TChar, typename TPos>
+BasicArg<TChar, TPos>::BasicArg(const StringView name, const CLType pos)
+  : name_{name.data()}, size_{static_cast<Pos>(name.size())},
+    pos_{static_cast<Pos>(pos)}
 {}
 
-template <typename TChar>
-[[nodiscard]] auto BasicArg<TChar>::name() const noexcept -> StringView {
-  return name_;
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicArg<TChar, TPos>::name() const noexcept -> StringView {
+  return {name_, size_};
 }
 
-template <typename TChar>
-[[nodiscard]] CLType BasicArg<TChar>::pos() const noexcept {
+template <typename TChar, typename TPos>
+[[nodiscard]] CLType BasicArg<TChar, TPos>::pos() const noexcept {
   return pos_;
 }
 
-template <typename TChar>
-[[nodiscard]] CLType BasicArg<TChar>::subpos() const noexcept {
+template <typename TChar, typename TPos>
+[[nodiscard]] CLType BasicArg<TChar, TPos>::subpos() const noexcept {
+  return 0;
+}
+
+
+
+// BasicUnrecognizedFlag
+
+template <typename TChar, typename TPos>
+BasicUnrecognizedFlag<TChar, TPos>::BasicUnrecognizedFlag(
+      const StringView name, const CLType pos, const CLType subpos)
+  : Arg{name, pos}, subpos_{static_cast<Pos>(subpos)}
+{}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] CLType BasicUnrecognizedFlag<TChar, TPos>::subpos()
+      const noexcept {
   return subpos_;
 }
 
 
 
+// BasicArgRange
+
+template <typename TChar, typename TPos>
+BasicArgRange<TChar, TPos>::BasicArgRange(const Char* const* argv,
+                                          const CLType pos,
+                                          const CLType size) noexcept
+  : argv_{argv}, pos_{static_cast<Pos>(pos)}, size_{static_cast<Pos>(size)}
+{}
+
+template <typename TChar, typename TPos>
+BasicArgRange<TChar, TPos>::BasicArgRange(const StringView* views,
+                                          const CLType pos,
+                                          const CLType size) noexcept
+  : views_{views}, pos_{static_cast<Pos>(pos)}, size_{static_cast<Pos>(size)}
+{}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicArgRange<TChar, TPos>::size() const noexcept
+      -> size_type {
+  return size_;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] bool BasicArgRange<TChar, TPos>::empty() const noexcept {
+  return size_ == 0;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] CLType BasicArgRange<TChar, TPos>::pos() const noexcept {
+  return pos_;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] CLType BasicArgRange<TChar, TPos>::end_pos() const noexcept {
+  return static_cast<CLType>(pos_) + size_;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicArgRange<TChar, TPos>::operator[](
+      const size_type i) const noexcept -> StringView {
+  return argv_ != nullptr ? StringView{argv_[i]} : views_[i];
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicArgRange<TChar, TPos>::begin() const noexcept
+      -> iterator {
+  return {argv_, views_, 0};
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicArgRange<TChar, TPos>::end() const noexcept
+      -> iterator {
+  return {argv_, views_, static_cast<difference_type>(size_)};
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicArgRange<TChar, TPos>::argv() const noexcept
+      -> std::span<const Char* const> {
+  if (argv_ == nullptr) {
+    return {};
+  }
+  return {argv_, size_};
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicArgRange<TChar, TPos>::views() const noexcept
+      -> std::span<const StringView> {
+  if (views_ == nullptr) {
+    return {};
+  }
+  return {views_, size_};
+}
+
+// the argument at end_pos() joins the range
+template <typename TChar, typename TPos>
+void BasicArgRange<TChar, TPos>::extend() noexcept {
+  ++size_;
+}
+
+
+
+// BasicArgRange::iterator
+
+template <typename TChar, typename TPos>
+BasicArgRange<TChar, TPos>::iterator::iterator(const Char* const* argv,
+                                               const StringView* views,
+                                               const difference_type i) noexcept
+  : argv_{argv}, views_{views}, i_{i}
+{}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicArgRange<TChar, TPos>::iterator::operator*()
+      const noexcept -> StringView {
+  return argv_ != nullptr ? StringView{argv_[i_]} : views_[i_];
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicArgRange<TChar, TPos>::iterator::operator[](
+      const difference_type n) const noexcept -> StringView {
+  return *(*this + n);
+}
+
+template <typename TChar, typename TPos>
+auto BasicArgRange<TChar, TPos>::iterator::operator++() noexcept
+      -> iterator& {
+  ++i_;
+  return *this;
+}
+
+template <typename TChar, typename TPos>
+auto BasicArgRange<TChar, TPos>::iterator::operator++(int) noexcept
+      -> iterator {
+  auto ret = *this;
+  ++i_;
+  return ret;
+}
+
+template <typename TChar, typename TPos>
+auto BasicArgRange<TChar, TPos>::iterator::operator--() noexcept
+      -> iterator& {
+  --i_;
+  return *this;
+}
+
+template <typename TChar, typename TPos>
+auto BasicArgRange<TChar, TPos>::iterator::operator--(int) noexcept
+      -> iterator {
+  auto ret = *this;
+  --i_;
+  return ret;
+}
+
+template <typename TChar, typename TPos>
+auto BasicArgRange<TChar, TPos>::iterator::operator+=(
+      const difference_type n) noexcept -> iterator& {
+  i_ += n;
+  return *this;
+}
+
+template <typename TChar, typename TPos>
+auto BasicArgRange<TChar, TPos>::iterator::operator-=(
+      const difference_type n) noexcept -> iterator& {
+  i_ -= n;
+  return *this;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicArgRange<TChar, TPos>::iterator::operator+(
+      const difference_type n) const noexcept -> iterator {
+  return {argv_, views_, i_ + n};
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicArgRange<TChar, TPos>::iterator::operator-(
+      const difference_type n) const noexcept -> iterator {
+  return {argv_, views_, i_ - n};
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicArgRange<TChar, TPos>::iterator::operator-(
+      const iterator& other) const noexcept -> difference_type {
+  return i_ - other.i_;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] bool BasicArgRange<TChar, TPos>::iterator::operator==(
+      const iterator& other) const noexcept {
+  return i_ == other.i_;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] std::strong_ordering
+BasicArgRange<TChar, TPos>::iterator::operator<=>(
+      const iterator& other) const noexcept {
+  return i_ <=> other.i_;
+}
+
+
+
 // BasicInput
 
 template <typename TChar>
@@ -461,71 +1142,342 @@ template <typename TChar>
 
 // BasicInstance
 
-template <typename TChar>
-BasicInstance<TChar>::BasicInstance(const StringView name, const CLType pos)
-  : name_{name}, pos_{pos}
+template <typename TChar, typename TPos>
+BasicInstance<TChar, TPos>::BasicInstance(const StringView name,
+                                          const CLType pos)
+  : BasicInstance{name, pos, CLType{0}, Input{}}
 {}
 
-template <typename TChar>
-BasicInstance<TChar>::BasicInstance(const StringView name, const CLType pos,
-                                    const CLType subpos)
-  : name_{name}, pos_{pos}, subpos_{subpos}
+template <typename TChar, typename TPos>
+BasicInstance<TChar, TPos>::BasicInstance(const StringView name,
+                                          const CLType pos,
+                                          const CLType subpos)
+  : BasicInstance{name, pos, subpos, Input{}}
 {}
 
-template <typename TChar>
+template <typename TChar, typename TPos>
 template <class... IArgs>
-BasicInstance<TChar>::BasicInstance(const StringView name, const CLType pos,
-  IArgs... input)
-  : name_{name}, pos_{pos}, input_{input...}
+BasicInstance<TChar, TPos>::BasicInstance(const StringView name,
+                                          const CLType pos, IArgs... input)
+  : BasicInstance{name, pos, CLType{0}, Input{input...}}
 {}
 
-template <typename TChar>
+template <typename TChar, typename TPos>
 template <class... IArgs>
-BasicInstance<TChar>::BasicInstance(const StringView name, const CLType pos,
-  const CLType subpos, IArgs... input)
-  : name_{name}, pos_{pos}, subpos_{subpos}, input_{input...}
+BasicInstance<TChar, TPos>::BasicInstance(const StringView name,
+                                          const CLType pos,
+                                          const CLType subpos,
+                                          IArgs... input)
+  : BasicInstance{name, pos, subpos, Input{input...}}
 {}
 
-template <typename TChar>
-[[nodiscard]] auto BasicInstance<TChar>::name() const noexcept -> StringView {
-  return name_;
+template <typename TChar, typename TPos>
+BasicInstance<TChar, TPos>::BasicInstance(const StringView name,
+                                          const CLType pos,
+                                          const CLType subpos,
+                                          const Input& input)
+  : name_{name.data()}, input_{input.value().data()},
+    name_size_{static_cast<Pos>(name.size())},
+    input_size_{static_cast<Pos>(input.value().size())},
+    pos_{static_cast<Pos>(pos)}, subpos_{static_cast<Pos>(subpos)},
+    input_type_{input() ? input.type() : InputType::unset}
+{}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicInstance<TChar, TPos>::name() const noexcept
+      -> StringView {
+  return {name_, name_size_};
 }
 
-template <typename TChar>
-[[nodiscard]] CLType BasicInstance<TChar>::pos() const noexcept {
+template <typename TChar, typename TPos>
+[[nodiscard]] CLType BasicInstance<TChar, TPos>::pos() const noexcept {
   return pos_;
 }
 
-template <typename TChar>
-[[nodiscard]] CLType BasicInstance<TChar>::subpos() const noexcept {
+template <typename TChar, typename TPos>
+[[nodiscard]] CLType BasicInstance<TChar, TPos>::subpos() const noexcept {
   return subpos_;
 }
 
-template <typename TChar>
-[[nodiscard]] auto BasicInstance<TChar>::input() const noexcept
-      -> const Input& {
-  return input_;
+// an input is set if it has a type (the parser always gives it one)
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicInstance<TChar, TPos>::input() const noexcept
+      -> Input {
+  if (input_type_ == InputType::unset) {
+    return {};
+  }
+  return {StringView{input_, input_size_}, input_type_};
 }
 
 
 
-// BasicFlag
+// BasicEventLog
 
-template <typename TChar>
-template <class... N, typename>
-BasicFlag<TChar>::BasicFlag(const FlagClass flag_class, N&&... names)
-  : class_{flag_class}, names_{std::forward<N>(names)...}
+template <typename TChar, typename TPos>
+BasicEventLog<TChar, TPos>::BasicEventLog(Resource* resource)
+  : resource_{resource}, chains_{resource}
 {}
 
-template <typename TChar>
-template <PosType C, class... N, typename>
-BasicFlag<TChar>::BasicFlag(const FlagClass flag_class,
-                              const C max, N&&... names)
-  : class_{flag_class}, names_{std::forward<N>(names)...},
-    max_{max < 0 ? 0 : static_cast<CLType>(max)}
+// as a std::pmr container, a copy draws on the default memory resource
+template <typename TChar, typename TPos>
+BasicEventLog<TChar, TPos>::BasicEventLog(const BasicEventLog& other) {
+  *this = other;
+}
+
+template <typename TChar, typename TPos>
+BasicEventLog<TChar, TPos>::BasicEventLog(BasicEventLog&& other) noexcept
+  : resource_{other.resource_}, block_{std::exchange(other.block_, nullptr)},
+    size_{std::exchange(other.size_, 0)},
+    capacity_{std::exchange(other.capacity_, 0)},
+    chains_{std::move(other.chains_)}
 {}
 
-template <typename TChar>
+// as a std::pmr container, the log keeps its own memory resource
+template <typename TChar, typename TPos>
+auto BasicEventLog<TChar, TPos>::operator=(const BasicEventLog& other)
+      -> BasicEventLog& {
+  if (this != &other) {
+    if (capacity_ < other.size_) {
+      size_ = 0;
+      regrow(other.size_);
+    }
+    copy_columns(block_, capacity_, other.block_, other.capacity_,
+                 other.size_);
+    size_ = other.size_;
+    chains_ = other.chains_;
+  }
+  return *this;
+}
+
+template <typename TChar, typename TPos>
+auto BasicEventLog<TChar, TPos>::operator=(BasicEventLog&& other)
+      -> BasicEventLog& {
+  if (*resource_ != *other.resource_) {
+    return *this = std::as_const(other);
+  }
+  std::swap(block_, other.block_);
+  std::swap(size_, other.size_);
+  std::swap(capacity_, other.capacity_);
+  chains_ = std::move(other.chains_);
+  return *this;
+}
+
+template <typename TChar, typename TPos>
+BasicEventLog<TChar, TPos>::~BasicEventLog() {
+  if (block_ != nullptr) {
+    resource_->deallocate(block_, capacity_ * event_size, block_align);
+  }
+}
+
+template <typename TChar, typename TPos>
+template <typename T>
+[[nodiscard]] T* BasicEventLog<TChar, TPos>::column(const std::size_t offset)
+      const noexcept {
+  return reinterpret_cast<T*>(block_ + capacity_ * offset);
+}
+
+template <typename TChar, typename TPos>
+void BasicEventLog<TChar, TPos>::copy_columns(
+      std::byte* to, const EventPos to_capacity, const std::byte* from,
+      const EventPos from_capacity, const EventPos count) noexcept {
+  if (count == 0) {
+    return;
+  }
+  for (std::size_t i = 0; i + 1 < column_bounds.size(); ++i) {
+    std::memcpy(to + to_capacity * column_bounds[i],
+                from + from_capacity * column_bounds[i],
+                count * (column_bounds[i + 1] - column_bounds[i]));
+  }
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicEventLog<TChar, TPos>::size() const noexcept
+      -> EventPos {
+  return size_;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] bool BasicEventLog<TChar, TPos>::empty() const noexcept {
+  return size_ == 0;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicEventLog<TChar, TPos>::kind(const EventPos event)
+      const noexcept -> Kind {
+  return column<Kind>(kinds_offset)[event];
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicEventLog<TChar, TPos>::flag(const EventPos event)
+      const noexcept -> FlagPos {
+  return column<FlagPos>(flags_offset)[event];
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicEventLog<TChar, TPos>::name(const EventPos event)
+      const noexcept -> StringView {
+  return column<StringView>(names_offset)[event];
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] CLType BasicEventLog<TChar, TPos>::pos(const EventPos event)
+      const noexcept {
+  return column<Pos>(positions_offset)[event];
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] CLType BasicEventLog<TChar, TPos>::subpos(const EventPos event)
+      const noexcept {
+  return column<Pos>(subpos_offset)[event];
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] bool BasicEventLog<TChar, TPos>::has_input(const EventPos event)
+      const noexcept {
+  return input_type(event) != InputType::unset;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicEventLog<TChar, TPos>::input(const EventPos event)
+      const noexcept -> StringView {
+  return column<StringView>(inputs_offset)[event];
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] InputType BasicEventLog<TChar, TPos>::input_type(
+      const EventPos event) const noexcept {
+  return column<InputType>(types_offset)[event];
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicEventLog<TChar, TPos>::first(const FlagPos flag)
+      const noexcept -> EventPos {
+  return flag < chains_.size() ? chains_[flag].head : no_event;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicEventLog<TChar, TPos>::next(const EventPos event)
+      const noexcept -> EventPos {
+  return column<EventPos>(next_offset)[event];
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicEventLog<TChar, TPos>::last(const FlagPos flag)
+      const noexcept -> EventPos {
+  return flag < chains_.size() ? chains_[flag].tail : no_event;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicEventLog<TChar, TPos>::count(const FlagPos flag)
+      const noexcept -> EventPos {
+  return flag < chains_.size() ? chains_[flag].count : 0;
+}
+
+// events are added in command-line order, so those at 'pos' are a run of
+// the positions column
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicEventLog<TChar, TPos>::at(const CLType pos)
+      const noexcept -> std::pair<EventPos, EventPos> {
+  const Pos* positions = column<Pos>(positions_offset);
+  if (pos > std::numeric_limits<Pos>::max()) {
+    return {size_, size_};
+  }
+  const auto [first, last] = std::equal_range(positions, positions + size_,
+                                              static_cast<Pos>(pos));
+  return {static_cast<EventPos>(first - positions),
+          static_cast<EventPos>(last - positions)};
+}
+
+// make room for the chains of 'flags' flags
+template <typename TChar, typename TPos>
+void BasicEventLog<TChar, TPos>::bind(const FlagPos flags) {
+  clear();
+  chains_.resize(flags);
+}
+
+// only the chains of the flags that have events need to be reset
+template <typename TChar, typename TPos>
+void BasicEventLog<TChar, TPos>::clear() noexcept {
+  const FlagPos* flags = column<FlagPos>(flags_offset);
+  for (EventPos event = 0; event < size_; ++event) {
+    if (flags[event] != no_flag) {
+      chains_[flags[event]] = Chain{};
+    }
+  }
+  size_ = 0;
+}
+
+template <typename TChar, typename TPos>
+void BasicEventLog<TChar, TPos>::reserve(const CLType events) {
+  if (events > capacity_) {
+    regrow(events);
+  }
+}
+
+template <typename TChar, typename TPos>
+void BasicEventLog<TChar, TPos>::regrow(const EventPos capacity) {
+  auto* block = static_cast<std::byte*>(
+      resource_->allocate(capacity * event_size, block_align));
+  if (block_ != nullptr) {
+    copy_columns(block, capacity, block_, capacity_, size_);
+    resource_->deallocate(block_, capacity_ * event_size, block_align);
+  }
+  block_ = block;
+  capacity_ = capacity;
+}
+
+template <typename TChar, typename TPos>
+void BasicEventLog<TChar, TPos>::add(
+      const Kind kind, const FlagPos flag, const StringView name,
+      const CLType pos, const CLType subpos, const StringView input,
+      const InputType input_type) {
+  if (size_ == capacity_) {
+    regrow(std::max<EventPos>(2 * capacity_, 16));
+  }
+  const EventPos event = size_++;
+  std::construct_at(column<StringView>(names_offset) + event, name);
+  std::construct_at(column<StringView>(inputs_offset) + event, input);
+  std::construct_at(column<FlagPos>(flags_offset) + event, flag);
+  std::construct_at(column<EventPos>(next_offset) + event, no_event);
+  std::construct_at(column<Pos>(positions_offset) + event,
+                    static_cast<Pos>(pos));
+  std::construct_at(column<Pos>(subpos_offset) + event,
+                    static_cast<Pos>(subpos));
+  std::construct_at(column<Kind>(kinds_offset) + event, kind);
+  std::construct_at(column<InputType>(types_offset) + event, input_type);
+
+  if (flag != no_flag) {
+    auto& chain = chains_[flag];
+    if (chain.head == no_event) {
+      chain.head = event;
+    }
+    else {
+      column<EventPos>(next_offset)[chain.tail] = event;
+    }
+    chain.tail = event;
+    ++chain.count;
+  }
+}
+
+
+
+// BasicFlag
+
+template <typename TChar>
+template <class... N, typename>
+BasicFlag<TChar>::BasicFlag(const FlagClass flag_class, N&&... names)
+  : class_{flag_class}, names_{std::forward<N>(names)...}
+{}
+
+template <typename TChar>
+template <PosType C, class... N, typename>
+BasicFlag<TChar>::BasicFlag(const FlagClass flag_class,
+                              const C max, N&&... names)
+  : class_{flag_class}, names_{std::forward<N>(names)...},
+    max_{max < 0 ? 0 : static_cast<CLType>(max)}
+{}
+
+template <typename TChar>
 void BasicFlag<TChar>::guess_types(
       const FlagMarkers& flag_markers, const bool tainted) {
   // pass on to each flag name
@@ -561,93 +1513,250 @@ template <typename TChar>
 }
 
 template <typename TChar>
-[[nodiscard]] auto BasicFlag<TChar>::within_limit() const noexcept
-      -> LimitType {
+[[nodiscard]] auto BasicFlag<TChar>::within_limit(const CLType count)
+      const noexcept -> LimitType {
   if (max_ == 0) {
     return LimitType::Proscribed;
   }
   // next line is correct: instance will yet to be increased when this
   // check is called, so as long as it is strictly less than max _now_,
   // then we are within the limit
-  return instances_.size() < max_ ? LimitType::Within : LimitType::Without;
+  return count < max_ ? LimitType::Within : LimitType::Without;
 }
 
+
+
+// BasicNameTrie
+
 template <typename TChar>
-[[nodiscard]] auto BasicFlag<TChar>::instances() const noexcept
-      -> const Instances& {
-  return instances_;
+BasicNameTrie<TChar>::BasicNameTrie()
+  : nodes_(1)
+{}
+
+template <typename TChar>
+void BasicNameTrie<TChar>::clear() {
+  // always keep the root node
+  nodes_.assign(1, Node{});
 }
 
 template <typename TChar>
-[[nodiscard]] auto BasicFlag<TChar>::instances() noexcept -> Instances& {
-  return instances_;
+void BasicNameTrie<TChar>::insert(const StringView name, const SearchRes res) {
+  NodePos node = 0;
+  for (const Char c: name) {
+    auto& edges = nodes_[node].edges;
+    const auto it = std::lower_bound(edges.begin(), edges.end(), c,
+                      [](const Edge& e, const Char k) { return e.key < k; });
+    if (it != edges.end() && it->key == c) {
+      node = it->node;
+    }
+    else {
+      const auto next = static_cast<NodePos>(nodes_.size());
+      edges.insert(it, Edge{c, next});
+      // N.B., 'edges' is invalidated from here on
+      nodes_.emplace_back();
+      node = next;
+    }
+  }
+  nodes_[node].res = res;
 }
 
 template <typename TChar>
-void BasicFlag<TChar>::clear() noexcept {
-  instances_.clear();
+template <typename F>
+void BasicNameTrie<TChar>::walk(const StringView opt, F&& visit) const {
+  walk(StringView{}, opt, std::forward<F>(visit));
 }
 
 template <typename TChar>
-void BasicFlag<TChar>::add_instance(
-      const StringView name, const CLType pos, const CLType subpos,
-      const StringView input, const InputType type) {
-  if (subpos > 0) {
-    // if subpos is set
-    instances_.emplace_back(name, pos, subpos, input, type);
+template <typename F>
+void BasicNameTrie<TChar>::walk(
+      const StringView prefix, const StringView opt, F&& visit) const {
+  const SizeType size = prefix.size() + opt.size();
+  NodePos node = 0;
+  for (SizeType i = 0; i < size; ++i) {
+    node = find_child(node, i < prefix.size() ? prefix[i]
+                                              : opt[i - prefix.size()]);
+    if (node == 0) {
+      return;
+    }
+    if (std::get<1>(nodes_[node].res) != nullptr) {
+      visit(i + 1, nodes_[node].res);
+    }
+  }
+}
+
+// return the position of the child node of 'node' along 'key', or else 0
+// (the root, which is never a child) if there is no such child
+template <typename TChar>
+[[nodiscard]] auto BasicNameTrie<TChar>::find_child(
+      const NodePos node, const Char key) const noexcept -> NodePos {
+  const auto& edges = nodes_[node].edges;
+  const auto it = std::lower_bound(edges.begin(), edges.end(), key,
+                    [](const Edge& e, const Char k) { return e.key < k; });
+  return (it != edges.end() && it->key == key) ? it->node : 0;
+}
+
+
+
+// BasicShortTable
+
+template <typename TChar>
+void BasicShortTable<TChar>::clear() noexcept {
+  tables_.clear();
+}
+
+template <typename TChar>
+void BasicShortTable<TChar>::insert(
+      const StringView name, const SearchRes res,
+      const FlagMarkers& flag_markers) {
+  // only short names are looked up in chains
+  if (std::get<0>(res)->type() != FlagType::short_type) {
+    return;
+  }
+
+  // looked up without a flag marker: "a" is found directly, but any longer
+  // name beginning with 'a' needs the trie
+  auto& e = entry(table_for(false, Char{}).table, name[0]);
+  if (name.size() == 1) {
+    e.res = res;
+  }
+  else {
+    e.longer = true;
+  }
+
+  // looked up behind a flag marker
+  if (flag_markers.contains(name[0])) {
+    auto& marked = table_for(true, name[0]);
+    if (name.size() == 1) {
+      marked.usable = false;
+    }
+    else if (name.size() == 2) {
+      entry(marked.table, name[1]).res = res;
+    }
+    else {
+      entry(marked.table, name[1]).longer = true;
+    }
+  }
+}
+
+template <typename TChar>
+[[nodiscard]] auto BasicShortTable<TChar>::find(
+      const StringView prefix, const Char c) const
+      -> std::optional<SearchRes> {
+  const bool have_marker = !prefix.empty();
+  const auto it = std::find_if(tables_.begin(), tables_.end(),
+      [&](const Marked& m) {
+        return m.have_marker == have_marker
+                  && (!have_marker || m.marker == prefix[0]);
+      });
+
+  // no short name begins here at all
+  if (it == tables_.end()) {
+    return SearchRes{nullptr, nullptr};
+  }
+  if (!it->usable) {
+    return std::nullopt;
+  }
+
+  const Entry* e = nullptr;
+  if constexpr (direct) {
+    e = &it->table[static_cast<unsigned char>(c)];
   }
   else {
-    instances_.emplace_back(name, pos, input, type);
+    const auto& table = it->table;
+    const auto found = std::lower_bound(table.begin(), table.end(), c,
+        [](const auto& t, const Char k) { return std::get<0>(t) < k; });
+    if (found == table.end() || std::get<0>(*found) != c) {
+      return SearchRes{nullptr, nullptr};
+    }
+    e = &std::get<1>(*found);
+  }
+
+  if (e->longer) {
+    return std::nullopt;
   }
+  return e->res;
 }
 
 template <typename TChar>
-void BasicFlag<TChar>::add_instance(
-      const StringView name, const CLType pos, const CLType subpos) {
-  if (subpos > 0) {
-    instances_.emplace_back(name, pos, subpos);
+[[nodiscard]] auto BasicShortTable<TChar>::table_for(
+      const bool have_marker, const Char marker) -> Marked& {
+  for (auto& m: tables_) {
+    if (m.have_marker == have_marker && (!have_marker || m.marker == marker)) {
+      return m;
+    }
+  }
+  auto& m = tables_.emplace_back();
+  m.have_marker = have_marker;
+  m.marker = marker;
+  return m;
+}
+
+template <typename TChar>
+[[nodiscard]] auto BasicShortTable<TChar>::entry(Table& table, const Char c)
+      -> Entry& {
+  if constexpr (direct) {
+    return table[static_cast<unsigned char>(c)];
   }
   else {
-    instances_.emplace_back(name, pos);
+    const auto it = std::lower_bound(table.begin(), table.end(), c,
+        [](const auto& t, const Char k) { return std::get<0>(t) < k; });
+    if (it != table.end() && std::get<0>(*it) == c) {
+      return std::get<1>(*it);
+    }
+    return std::get<1>(*table.insert(it, {c, Entry{}}));
   }
 }
 
 
 
-// BasicOpts::Parsing
+
+// BasicMarkerTable
 
 template <typename TChar>
-void BasicOpts<TChar>::Parsing::clear() noexcept {
-  // preserve stop state, so don't reset 'stop'
-  pflag = nullptr;
-  pname = nullptr;
-  subpos = 0;
+BasicMarkerTable<TChar>::BasicMarkerTable(const FlagMarkers& flag_markers) {
+  assign(flag_markers);
 }
 
 template <typename TChar>
-void BasicOpts<TChar>::Parsing::reset_all() noexcept {
-  clear();
-  stop = false;
+void BasicMarkerTable<TChar>::assign(const FlagMarkers& flag_markers) {
+  if constexpr (direct) {
+    table_.fill(0);
+    for (const auto m: flag_markers) {
+      const auto c = static_cast<unsigned char>(m);
+      table_[c >> 6] |= std::uint64_t{1} << (c & 63);
+    }
+  }
+  else {
+    table_.assign(flag_markers.begin(), flag_markers.end());
+    std::sort(table_.begin(), table_.end());
+  }
 }
 
-// return true if 'set' and false if clear.
 template <typename TChar>
-[[nodiscard]] bool BasicOpts<TChar>::Parsing::operator()() const noexcept {
-  return pflag != nullptr;
+[[nodiscard]] bool BasicMarkerTable<TChar>::contains(const Char c)
+      const noexcept {
+  if constexpr (direct) {
+    const auto u = static_cast<unsigned char>(c);
+    return (table_[u >> 6] >> (u & 63)) & 1;
+  }
+  else {
+    return std::binary_search(table_.begin(), table_.end(), c);
+  }
 }
 
 
-// BasicOpts::ErrorInfo
+
+// BasicErrorInfo
 
 // error: pos P: ...
 template <typename TChar>
-BasicOpts<TChar>::ErrorInfo::ErrorInfo(const ErrorKey k, const CLType p)
+BasicErrorInfo<TChar>::BasicErrorInfo(const ErrorKey k, const CLType p)
   : key{k}, pos{p}
 {}
 
 // error: pos P: flag 'O': ... 'I'...
 template <typename TChar>
-BasicOpts<TChar>::ErrorInfo::ErrorInfo(
+BasicErrorInfo<TChar>::BasicErrorInfo(
       const ErrorKey k, const CLType p, const StringView o, const bool f,
       const CLType i)
   : key{k}, pos{p}, have_opt{true}, opt{o}, is_flag{f},
@@ -656,7 +1765,7 @@ BasicOpts<TChar>::ErrorInfo::ErrorInfo(
 
 // error: pos P: flag 'O': ... 'I'...
 template <typename TChar>
-BasicOpts<TChar>::ErrorInfo::ErrorInfo(
+BasicErrorInfo<TChar>::BasicErrorInfo(
       const ErrorKey k, const CLType p, const StringView o, const bool f,
       const StringView i)
   : key{k}, pos{p}, have_opt{true}, opt{o}, is_flag{f},
@@ -665,14 +1774,14 @@ BasicOpts<TChar>::ErrorInfo::ErrorInfo(
 
 // error: pos P: flag 'O': ...
 template <typename TChar>
-BasicOpts<TChar>::ErrorInfo::ErrorInfo(
+BasicErrorInfo<TChar>::BasicErrorInfo(
       const ErrorKey k, const CLType p, const StringView o, const bool f)
   : key{k}, pos{p}, have_opt{true}, opt{o}, is_flag{f}
 {}
 
 // error: pos P: subpos SP: flag 'O': ... 'I'...
 template <typename TChar>
-BasicOpts<TChar>::ErrorInfo::ErrorInfo(
+BasicErrorInfo<TChar>::BasicErrorInfo(
       const ErrorKey k, const CLType p, const CLType sp, const StringView o,
       const bool f, const CLType i)
   : key{k}, pos{p}, subpos{sp}, have_opt{true}, opt{o}, is_flag{f},
@@ -681,7 +1790,7 @@ BasicOpts<TChar>::ErrorInfo::ErrorInfo(
 
 // error: pos P, subpos SP: flag 'O': ... 'I'...
 template <typename TChar>
-BasicOpts<TChar>::ErrorInfo::ErrorInfo(
+BasicErrorInfo<TChar>::BasicErrorInfo(
       const ErrorKey k, const CLType p, const CLType sp, const StringView o,
       const bool f, const StringView i)
   : key{k}, pos{p}, subpos{sp}, have_opt{true}, opt{o}, is_flag{f},
@@ -690,753 +1799,757 @@ BasicOpts<TChar>::ErrorInfo::ErrorInfo(
 
 // error: pos P, subpos SP: flag 'O': ...
 template <typename TChar>
-BasicOpts<TChar>::ErrorInfo::ErrorInfo(
+BasicErrorInfo<TChar>::BasicErrorInfo(
       const ErrorKey k, const CLType p, const CLType sp, const StringView o,
       const bool f)
   : key{k}, pos{p}, subpos{sp}, have_opt{true}, opt{o}, is_flag{f}
 {}
 
 
-// BasicOpts
+
+// BasicErrorFormat
 
 template <typename TChar>
-void BasicOpts<TChar>::convert_error_str(
-      String& str, const ErrorInfo& error) const {
-  typename String::size_type i = 0;
-  while (i = str.find(static_cast<Char>('%'), i),
-    i < str.size() || i != String::npos) {
-    if (str[i + 1] == static_cast<Char>('%')) {
-      str.erase(i, 1);
-    }
-    else if (str.substr(i, 4) == String{ '%','o', 'p', 't' }) {
-      if (error.have_opt) {
-        str.replace(i, 4, error.opt);
-      }
-    }
-    else if (str.substr(i, 5) == String{ '%', 't', 'y', 'p', 'e' }) {
-      if (error.have_opt) {
-        if (error.is_flag) {
-          str.replace(i, 5, String{ 'f', 'l', 'a', 'g' });
-        }
-        else {
-          str.replace(i, 5, String{ 'a', 'r', 'g' });
-        }
+BasicErrorFormat<TChar>::BasicErrorFormat(String proto)
+  : text_{std::move(proto)}
+{
+  // the placeholders and what they are replaced with
+  static constexpr std::array<std::tuple<const char*, Field>, 8> fields{{
+    {"%opt", Field::opt},
+    {"%type", Field::type},
+    {"%pos", Field::pos},
+    {"%subpos", Field::subpos},
+    {"%input", Field::input},
+    {"%errno", Field::key},
+    {"%file", Field::file},
+    {"%offset", Field::offset}
+  }};
+
+  const auto matches = [this](const SizeType i, const char* name) {
+    for (SizeType j = 0; name[j] != '\0'; ++j) {
+      if (i + j >= text_.size() || text_[i + j] != static_cast<Char>(name[j])) {
+        return false;
       }
     }
-    else if (str.substr(i, 4) == String{ '%', 'p', 'o', 's' }) {
-      str.replace(i, 4, to_string<Char>(error.pos));
-    }
-    else if (str.substr(i, 7) == String{ '%', 's', 'u', 'b', 'p', 'o', 's' }) {
-      if (error.subpos > 0) {
-        str.replace(i, 7, to_string<Char>(error.subpos));
-      }
+    return true;
+  };
+
+  // start of the literal segment that has not been added yet
+  SizeType start = 0;
+  const auto add_literal = [&](const SizeType end) {
+    if (end > start) {
+      tokens_.push_back({Field::literal, start, end - start});
+      literal_length_ += end - start;
     }
-    else if (str.substr(i, 6) == String{ '%', 'i', 'n', 'p', 'u', 't' }) {
-      if (error.have_input) {
-        if (std::holds_alternative<CLType>(error.input)) {
-          str.replace(i, 6, to_string<Char>(std::get<CLType>(error.input)));
-        }
-        else {
-          str.replace(i, 6, std::get<StringView>(error.input));
-        }
-      }
+  };
+
+  SizeType i = 0;
+  while ( (i = text_.find(static_cast<Char>('%'), i)) != String::npos ) {
+    // "%%" is a literal '%'
+    if (i + 1 < text_.size() && text_[i + 1] == static_cast<Char>('%')) {
+      add_literal(i + 1);
+      start = i += 2;
+      continue;
     }
-    else if (str.substr(i, 6) == String{ '%', 'e', 'r', 'r', 'n', 'o' }) {
-      str.replace(i, 6, to_string<Char>(static_cast<int>(error.key)));
+
+    const auto field = std::ranges::find_if(fields, [&](const auto& f) {
+      return matches(i, std::get<0>(f));
+    });
+    // anything else is kept as it is
+    if (field == fields.end()) {
+      ++i;
+      continue;
     }
-    ++i;
-  }
-}
 
-template <typename TChar>
-template <class... N>
-void BasicOpts<TChar>::add_bare(N&&... names) {
-  flags_.emplace_back(FlagClass::bare, std::forward<N>(names)...);
-  map_tainted_ = true;
+    add_literal(i);
+    const auto length = std::char_traits<char>::length(std::get<0>(*field));
+    tokens_.push_back({std::get<1>(*field), i, length});
+    places_file_ = places_file_ || std::get<1>(*field) == Field::file
+                     || std::get<1>(*field) == Field::offset;
+    start = i += length;
+  }
+  add_literal(text_.size());
 }
 
 template <typename TChar>
-template <class... N>
-void BasicOpts<TChar>::add_optional(N&&... names) {
-  flags_.emplace_back(FlagClass::optional, std::forward<N>(names)...);
-  map_tainted_ = true;
+template <typename Str>
+void BasicErrorFormat<TChar>::write(Str& out, const ErrorInfo& error) const {
+  out.reserve(out.size() + length(error));
+  write_to(std::back_inserter(out), error);
+}
+
+template <typename TChar>
+template <std::output_iterator<const TChar&> Out>
+Out BasicErrorFormat<TChar>::write_to(Out out, const ErrorInfo& error) const {
+  static constexpr Char flag[] = {'f', 'l', 'a', 'g'};
+  static constexpr Char arg[] = {'a', 'r', 'g'};
+  static constexpr Char in[] = {' ', '(', 'i', 'n', ' '};
+  static constexpr Char at[] = {' ', 'a', 't', ' '};
+
+  // an opt from a response file is placed after the first %pos, unless the
+  // format places it itself
+  bool placed = places_file_ || error.file.empty();
+  for (const auto& token: tokens_) {
+    const auto raw = [&] {
+      const auto first = text_.begin() + token.offset;
+      return std::copy(first, first + token.length, out);
+    };
+    switch (token.field) {
+    case Field::literal:
+      out = raw();
+      break;
+    case Field::opt:
+      out = error.have_opt ? std::ranges::copy(error.opt, out).out : raw();
+      break;
+    case Field::type:
+      if (error.have_opt) {
+        out = error.is_flag ? std::ranges::copy(flag, out).out
+                            : std::ranges::copy(arg, out).out;
+      }
+      else {
+        out = raw();
+      }
+      break;
+    case Field::pos:
+      out = write_number(out, error.arg > 0 ? error.arg : error.pos);
+      if (!placed) {
+        out = std::ranges::copy(in, out).out;
+        out = std::ranges::copy(error.file, out).out;
+        out = std::ranges::copy(at, out).out;
+        out = write_number(out, error.offset);
+        *out++ = static_cast<Char>(')');
+        placed = true;
+      }
+      break;
+    case Field::file:
+      out = error.file.empty() ? raw() : std::ranges::copy(error.file, out).out;
+      break;
+    case Field::offset:
+      out = error.file.empty() ? raw() : write_number(out, error.offset);
+      break;
+    case Field::subpos:
+      out = error.subpos > 0 ? write_number(out, error.subpos) : raw();
+      break;
+    case Field::input:
+      if ( !error.have_input ) {
+        out = raw();
+      }
+      else if (std::holds_alternative<CLType>(error.input)) {
+        out = write_number(out, std::get<CLType>(error.input));
+      }
+      else {
+        out = std::ranges::copy(std::get<StringView>(error.input), out).out;
+      }
+      break;
+    case Field::key:
+      out = write_number(out, static_cast<CLType>(error.key));
+      break;
+    }
+  }
+  return out;
 }
 
 template <typename TChar>
-template <class... N>
-void BasicOpts<TChar>::add_mandatory(N&&... names) {
-  flags_.emplace_back(FlagClass::mandatory, std::forward<N>(names)...);
-  map_tainted_ = true;
+[[nodiscard]] auto BasicErrorFormat<TChar>::length(
+      const ErrorInfo& error) const noexcept -> SizeType {
+  // enough for any number
+  constexpr SizeType number_length = std::numeric_limits<CLType>::digits10 + 1;
+
+  SizeType ret = literal_length_;
+  // " (in FILE at OFFSET)", or the file of %file
+  ret += error.file.size() + number_length + 10;
+  for (const auto& token: tokens_) {
+    switch (token.field) {
+    case Field::literal:
+      break;
+    case Field::opt:
+      ret += std::max(error.opt.size(), token.length);
+      break;
+    case Field::input:
+      ret += std::holds_alternative<StringView>(error.input)
+               ? std::max(std::get<StringView>(error.input).size(),
+                          token.length)
+               : number_length;
+      break;
+    default:
+      ret += number_length;
+    }
+  }
+  return ret;
 }
 
 template <typename TChar>
-template <class... N>
-void BasicOpts<TChar>::add_stop(N&&... names) {
-  flags_.emplace_back(FlagClass::stop, std::forward<N>(names)...);
-  map_tainted_ = true;
+template <std::output_iterator<const TChar&> Out>
+Out BasicErrorFormat<TChar>::write_number(Out out, CLType val) {
+  Char digits[std::numeric_limits<CLType>::digits10 + 1];
+  auto first = std::end(digits);
+  do {
+    *--first = static_cast<Char>('0' + val % 10);
+    val /= 10;
+  } while (val > 0);
+  return std::copy(first, std::end(digits), out);
 }
 
-template <typename TChar>
-void BasicOpts<TChar>::allow_empty_arguments(const bool state) noexcept {
-  allow_empty_arg_ = state;
-}
 
-template <typename TChar>
-void BasicOpts<TChar>::allow_empty_inputs(const bool state) noexcept {
-  allow_empty_input_ = state;
-}
 
-template <typename TChar>
-template <PosType T>
-void BasicOpts<TChar>::allow_arguments(const T max) noexcept {
-  collect_args_ = max < 0 ? 0 : max;
-}
+// BasicCompiledSpec::Parsing
 
 template <typename TChar>
-void BasicOpts<TChar>::allow_arguments() noexcept {
-  collect_args_ = std::numeric_limits<CLType>::max();
+void BasicCompiledSpec<TChar>::Parsing::clear() noexcept {
+  // preserve stop state, so don't reset 'stop'
+  pflag = nullptr;
+  pname = nullptr;
+  subpos = 0;
 }
 
 template <typename TChar>
-template <PosType T>
-void BasicOpts<TChar>::allow_unrecognized_flags(
-      const T max, const Aggressive state) noexcept {
-  collect_unrecognized_flags_ = max < 0 ? 0 : max;
-  unrecognized_greedy_ = state == Aggressive::no ? false : true;
+void BasicCompiledSpec<TChar>::Parsing::reset_all() noexcept {
+  clear();
+  stop = false;
 }
 
+// return true if 'set' and false if clear.
 template <typename TChar>
-void BasicOpts<TChar>::allow_unrecognized_flags(
-      const Aggressive state) noexcept {
-  collect_unrecognized_flags_ = std::numeric_limits<CLType>::max();
-  unrecognized_greedy_ = state == Aggressive::no ? false : true;
+[[nodiscard]] bool BasicCompiledSpec<TChar>::Parsing::operator()() const noexcept {
+  return pflag != nullptr;
 }
 
-template <typename TChar>
-template <PosType T>
-void BasicOpts<TChar>::allow_unrecognized_opts(const T max) noexcept {
-  allow_unrecognized_flags(max);
-}
 
-template <typename TChar>
-void BasicOpts<TChar>::allow_unrecognized_opts() noexcept {
-  allow_unrecognized_flags();
-}
 
-template <typename TChar>
-void BasicOpts<TChar>::allow_chaining(const bool state) noexcept {
-  can_chain_ = state;
+// BasicCompiledSpec
+
+template <typename TChar>
+BasicCompiledSpec<TChar>::BasicCompiledSpec(const BasicCompiledSpec& other)
+  : allow_empty_arg_{other.allow_empty_arg_},
+    allow_empty_input_{other.allow_empty_input_},
+    can_chain_{other.can_chain_},
+    mandatory_greedy_{other.mandatory_greedy_},
+    optional_greedy_{other.optional_greedy_},
+    unrecognized_greedy_{other.unrecognized_greedy_},
+    collect_unrecognized_flags_{other.collect_unrecognized_flags_},
+    collect_args_{other.collect_args_},
+    response_files_{other.response_files_},
+    preamble_{other.preamble_},
+    postscript_{other.postscript_},
+    custom_error_message_{other.custom_error_message_},
+    error_formats_{other.error_formats_},
+    flag_markers_{other.flag_markers_},
+    input_marker_{other.input_marker_},
+    flags_{other.flags_},
+    static_names_{other.static_names_},
+    flag_type_tainted_{other.flag_type_tainted_},
+    error_formats_tainted_{other.error_formats_tainted_}
+{
+  // the map of 'other' points into its own flags, so build our own if
+  // 'other' had one
+  if ( !other.map_tainted_ ) {
+    create_map();
+  }
 }
 
 template <typename TChar>
-void BasicOpts<TChar>::set_chaining(const bool state) noexcept {
-  allow_chaining(state);
+auto BasicCompiledSpec<TChar>::operator=(BasicCompiledSpec other) noexcept
+      -> BasicCompiledSpec& {
+  swap(other);
+  return *this;
+}
+
+template <typename TChar>
+void BasicCompiledSpec<TChar>::swap(BasicCompiledSpec& other) noexcept {
+  using std::swap;
+  swap(allow_empty_arg_, other.allow_empty_arg_);
+  swap(allow_empty_input_, other.allow_empty_input_);
+  swap(can_chain_, other.can_chain_);
+  swap(mandatory_greedy_, other.mandatory_greedy_);
+  swap(optional_greedy_, other.optional_greedy_);
+  swap(unrecognized_greedy_, other.unrecognized_greedy_);
+  swap(collect_unrecognized_flags_, other.collect_unrecognized_flags_);
+  swap(collect_args_, other.collect_args_);
+  swap(response_files_, other.response_files_);
+  swap(preamble_, other.preamble_);
+  swap(postscript_, other.postscript_);
+  swap(custom_error_message_, other.custom_error_message_);
+  swap(error_formats_, other.error_formats_);
+  swap(flag_markers_, other.flag_markers_);
+  swap(input_marker_, other.input_marker_);
+  swap(flags_, other.flags_);
+  swap(map_, other.map_);
+  swap(trie_, other.trie_);
+  swap(short_table_, other.short_table_);
+  swap(marker_table_, other.marker_table_);
+  swap(static_names_, other.static_names_);
+  swap(flag_type_tainted_, other.flag_type_tainted_);
+  swap(map_tainted_, other.map_tainted_);
+  swap(error_formats_tainted_, other.error_formats_tainted_);
+}
+
+// bring the flag types and the map up to date with the declarations; after
+// this, the spec is ready to be parsed with
+template <typename TChar>
+void BasicCompiledSpec<TChar>::freeze() {
+  guess_types();
+  create_map();
+  compile_error_formats();
 }
 
 template <typename TChar>
-void BasicOpts<TChar>::set_no_chaining() noexcept {
-  allow_chaining(false);
+[[nodiscard]] auto BasicCompiledSpec<TChar>::get_map() const noexcept
+      -> const Map& {
+  return map_;
 }
 
 template <typename TChar>
-void BasicOpts<TChar>::set_greedy(const bool state) noexcept {
-  mandatory_greedy_ = state ? Greedy::yes : Greedy::no;
+[[nodiscard]] auto BasicCompiledSpec<TChar>::flags() const noexcept
+      -> const Flags& {
+  return flags_;
 }
 
 template <typename TChar>
-void BasicOpts<TChar>::set_not_greedy() noexcept {
-  mandatory_greedy_ = Greedy::no;
+[[nodiscard]] auto BasicCompiledSpec<TChar>::flag_pos(const StringView name)
+      const -> FlagPos {
+  if (!static_names_.empty()) {
+    if (const auto pos = find_static_name(name)) {
+      return *pos;
+    }
+    helper::raise<std::out_of_range>("flag_pos: no flag has this name");
+  }
+  const auto it = map_.find(name);
+  if (it == map_.end()) {
+    helper::raise<std::out_of_range>("flag_pos: no flag has this name");
+  }
+  return flag_pos(*std::get<1>(it->second));
 }
 
 template <typename TChar>
-void BasicOpts<TChar>::set_lax_greedy() noexcept {
-  mandatory_greedy_ = Greedy::lax;
+[[nodiscard]] auto BasicCompiledSpec<TChar>::flag_pos(const Flag& flag)
+      const noexcept -> FlagPos {
+  return static_cast<FlagPos>(&flag - flags_.data());
 }
 
 template <typename TChar>
-void BasicOpts<TChar>::set_greedy(const Greedy state) noexcept {
-  mandatory_greedy_ = state;
+[[nodiscard]] auto BasicCompiledSpec<TChar>::find_flag_pos(
+      const StringView name) const noexcept -> std::optional<FlagPos> {
+  if (!static_names_.empty()) {
+    return find_static_name(name);
+  }
+  if (const auto it = map_.find(name); it != map_.end()) {
+    return flag_pos(*std::get<1>(it->second));
+  }
+  return std::nullopt;
 }
 
 template <typename TChar>
-void BasicOpts<TChar>::set_optional_greedy(const bool state) noexcept {
-  optional_greedy_ = state;
+[[nodiscard]] auto BasicCompiledSpec<TChar>::get_preamble() const -> StringView {
+  return StringView{preamble_};
 }
 
 template <typename TChar>
-void BasicOpts<TChar>::set_optional_not_greedy() noexcept {
-  optional_greedy_ = false;
+[[nodiscard]] auto BasicCompiledSpec<TChar>::get_postscript() const -> StringView {
+  return StringView{postscript_};
 }
 
 template <typename TChar>
-template <typename Str>
-void BasicOpts<TChar>::set_preamble(Str&& str) {
-  preamble_ = std::forward<Str>(str);
+template <typename Policy, typename TPos, typename T>
+bool BasicCompiledSpec<TChar>::parse(ResultFor<TPos>& res, T&& args) const {
+  return parse<Policy>(res, std::forward<T>(args), static_cast<CLType>(0));
 }
 
 template <typename TChar>
-template <typename Str>
-void BasicOpts<TChar>::set_postscript(Str&& str) {
-  postscript_ = std::forward<Str>(str);
-}
+template <typename Policy, typename TPos, PosType T>
+bool BasicCompiledSpec<TChar>::parse(
+      ResultFor<TPos>& res, T argc, Char** argv, T start_at) const {
+  res.bind(*this);
 
-template <typename TChar>
-template <class... Chars, typename>
-void BasicOpts<TChar>::set_flag_marker(Chars... flag_markers) {
-  set_flag_markers(flag_markers...);
-}
-
-template <typename TChar>
-template <class... Chars, typename>
-void BasicOpts<TChar>::set_flag_markers(Chars... flag_markers) {
-  flag_markers_.clear();
-  add_flag_markers(flag_markers...);
-}
-
-template <typename TChar>
-template <class... Chars, typename>
-void BasicOpts<TChar>::add_flag_marker(Chars... flag_markers) {
-  add_flag_markers(flag_markers...);
-}
+  if (argc < 1 || argv == nullptr || start_at >= argc) {
+    return false;
+  }
+  if (start_at < 0) {
+    start_at = argc + start_at;
+  }
+  if (start_at < 0) {
+    return false;
+  }
 
-template <typename TChar>
-template <class... Chars, typename>
-void BasicOpts<TChar>::add_flag_markers(Chars... flag_markers) {
-  (flag_markers_.emplace(flag_markers), ...);
-  flag_type_tainted_ = true;
-}
+#ifdef DEFPROB_CLUTILS_HAVE_MMAN
+  // replace the response files with their opts, and parse those instead
+  if constexpr (sizeof(Char) == 1) {
+    if (response_files_ != ResponseFiles::no &&
+        res.expand_response_files(argc, argv, start_at,
+                                  response_files_ == ResponseFiles::nested)) {
+      return parse_saved<Policy>(res);
+    }
+  }
+#endif
 
-template <typename TChar>
-template <class... Chars, typename>
-void BasicOpts<TChar>::set_opt_marker(Chars... flag_markers) {
-  set_flag_markers(flag_markers...);
-}
+  // set to true if any parsing errors found
+  bool errors = false;
 
-template <typename TChar>
-template <class... Chars, typename>
-void BasicOpts<TChar>::set_opt_markers(Chars... flag_markers) {
-  set_flag_markers(flag_markers...);
-}
+  // keep track of prev parsing details on loop through argv
+  Parsing prev;
 
-template <typename TChar>
-template <class... Chars, typename>
-void BasicOpts<TChar>::add_opt_marker(Chars... flag_markers) {
-  add_flag_markers(flag_markers...);
-}
+  // loop over opts
+  // let's always start 'pos' at 1 so that counting (and referencing) opts
+  // at the command-line begins at 1 and not 0
+  const CLType end = 1 + static_cast<CLType>(argc) - start_at;
+  check_fits<TPos>(end - 1, 0);
+  res.view_opts(argv + start_at);
+  for (CLType pos = 1; pos < end; ++pos) {
+    parse_opt<Policy>(pos, argv[pos - 1 + start_at], prev, errors, res);
+    if (prev.stop && take_tail<Policy>(pos + 1, end, prev, res)) {
+      break;
+    }
+  }
 
-template <typename TChar>
-template <class... Chars, typename>
-void BasicOpts<TChar>::add_opt_markers(Chars... flag_markers) {
-  add_flag_markers(flag_markers...);
-}
+  // if prev set, then last mandatory flag was expecting an input
+  parse_opt_finish(static_cast<CLType>(argc) - start_at, prev, errors, res);
 
-template <typename TChar>
-void BasicOpts<TChar>::set_input_marker(const Char input_marker) noexcept {
-  input_marker_ = input_marker;
+  return errors;
 }
 
 template <typename TChar>
-void BasicOpts<TChar>::clear() noexcept {
-  // clear saved opts
-  cl_opts_.clear();
+template <typename Policy, typename TPos, typename T, PosType U>
+bool BasicCompiledSpec<TChar>::parse(
+      ResultFor<TPos>& res, T&& argv, U start_at) const {
+  const auto argc = std::size(argv);
+  res.bind(*this);
 
-  // clear arguments
-  args_.clear();
+  if (argc == 0 || start_at >= argc) {
+    return false;
+  }
+  if (start_at < 0) {
+    start_at = argc + start_at;
+  }
+  if (start_at < 0) {
+    return false;
+  }
+  check_fits<TPos>(static_cast<CLType>(argc - start_at), 0);
 
-  // clear unrecognized flags
-  unrecognized_flags_.clear();
+  // set to true if any parsing errors found
+  bool errors = false;
 
-  // clear errors
-  clear_errors();
+  // keep track of prev parsing details on loop through argv
+  Parsing prev;
 
-  // clear flag instances
-  for (auto& flag: flags_) {
-    flag.clear();
+  // save opts, if need be
+  const bool saved = res.save_opts(std::forward<T>(argv));
+  if (saved) {
+    res.view_opts(res.cl_views_.data() + start_at);
+  }
+  else {
+    res.view_opts(argv, start_at);
   }
-}
-
-template <typename TChar>
-void BasicOpts<TChar>::clear_errors() noexcept {
-  errors_.clear();
-  cached_error_strings_.clear();
-}
-
-template <typename TChar>
-void BasicOpts<TChar>::clear_declarations() noexcept {
-  flags_.clear();
-  flag_type_tainted_ = true;
-  map_.clear();
-  map_tainted_ = true;
-  collect_unrecognized_flags_ = 0;
-  collect_unrecognized_flags_count_ = 0;
-  collect_args_ = 0;
-  collect_args_count_ = 0;
-}
 
-template <typename TChar>
-void BasicOpts<TChar>::default_error_formats() noexcept {
-  custom_error_message_.clear();
-}
+  // loop over opts
+  // let's always start 'pos' at 1 so that counting (and referencing) opts
+  // at the command-line begins at 1 and not 0
+  const CLType end = 1 + argc - start_at;
+  for (CLType pos = 1; pos < end; ++pos) {
+    if (saved) {
+      parse_opt<Policy>(pos, res.cl_views_[pos - 1 + start_at], prev, errors,
+                        res);
+    }
+    else {
+      parse_opt<Policy>(pos, argv[pos - 1 + start_at], prev, errors, res);
+    }
+    if (prev.stop && take_tail<Policy>(pos + 1, end, prev, res)) {
+      break;
+    }
+  }
 
-template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::get_all_errors() const noexcept
-      -> const Errors& {
-  return errors_;
-}
+  // if prev set, then last mandatory flag was expecting an input
+  parse_opt_finish(argc - start_at, prev, errors, res);
 
-template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::get_all_errors() noexcept -> Errors& {
-  return errors_;
+  return errors;
 }
 
 template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::get_map() -> const Map& {
-  create_map();
-  return map_;
-}
+template <typename Policy, typename TPos, class... T, typename>
+bool BasicCompiledSpec<TChar>::parse(ResultFor<TPos>& res, T&&... args) const {
+  res.bind(*this);
 
-template <typename TChar>
-[[nodiscard]] bool BasicOpts<TChar>::have_opt(const StringView name) const {
-  return !std::get<1>( map_.at(name) )->instances().empty();
-}
+  // save opts
+  res.save_opts_pack(std::forward<T>(args)...);
 
-template <typename TChar>
-[[nodiscard]] bool BasicOpts<TChar>::has_opt(const StringView name) const {
-  return have_opt(name);
+  return parse_saved<Policy>(res);
 }
 
 template <typename TChar>
-[[nodiscard]] bool BasicOpts<TChar>::have_flag(const StringView name) const {
-  return have_opt(name);
-}
+template <typename Policy, typename TPos>
+bool BasicCompiledSpec<TChar>::parse_command_line(
+      ResultFor<TPos>& res, const StringView line) const {
+  res.bind(*this);
 
-template <typename TChar>
-[[nodiscard]] bool BasicOpts<TChar>::has_flag(const StringView name) const {
-  return have_opt(name);
-}
+  // save the words of the line
+  const auto unfinished = res.save_command_line(line);
 
-template <typename TChar>
-[[nodiscard]] bool BasicOpts<TChar>::has_input(
-      const StringView name, const InstancePos pos) const {
-  const auto& instances = std::get<1>( map_.at(name) )->instances();
-  return has_input(instances.at(pos < 0 ? instances.size() + pos : pos));
+  const bool errors = parse_saved<Policy>(res);
+  if (unfinished) {
+    const StringView word = res.cl_views_.back();
+    res.register_error(*unfinished, res.cl_views_.size(), word,
+                       opt_is_flag(word));
+    return true;
+  }
+  return errors;
 }
 
 template <typename TChar>
-[[nodiscard]] bool BasicOpts<TChar>::has_input(
-      const Instance& instance) const noexcept {
-  return instance.input()();
-}
+template <typename Policy, typename TPos>
+bool BasicCompiledSpec<TChar>::parse_nul_separated(
+      ResultFor<TPos>& res, std::span<const Char> buf, CLType start_at) const {
+  res.bind(*this);
+
+  // the opt at the front of 'buf', which is then dropped from it
+  const auto next = [&buf] {
+    const Char* const nul = std::char_traits<Char>::find(buf.data(),
+                                                         buf.size(), Char{});
+    const std::size_t size = nul != nullptr
+                               ? static_cast<std::size_t>(nul - buf.data())
+                               : buf.size();
+    const StringView opt{buf.data(), size};
+    buf = buf.subspan(std::min(size + 1, buf.size()));
+    return opt;
+  };
+  for (; start_at > 0 && !buf.empty(); --start_at) {
+    next();
+  }
 
-template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::get_all_instances(const StringView name)
-      -> Instances& {
-  return const_cast<Instances&>(std::as_const(*this).get_all_instances(name));
-}
+  // the argument ranges need the opts in order in memory
+  if (res.keep_ranges_) {
+    while (!buf.empty()) {
+      res.cl_views_.push_back(next());
+    }
+    return parse_saved<Policy>(res);
+  }
 
-template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::get_all_instances(
-      const StringView name) const -> const Instances& {
-  return std::get<1>( map_.at(name) )->instances();
-}
+  // set to true if any parsing errors found
+  bool errors = false;
 
-// pos can be 0, ..., N-1 to get instance k from N total, or else negative
-// fetching retrograde from -1, ..., -N.
-// return will be: <flag_has_input?, input>
-template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::get_input(
-      const StringView name, const InstancePos pos) const -> InputResult {
-  const auto& instances = std::get<1>( map_.at(name) )->instances();
-  return get_input(instances.at(pos < 0 ? instances.size() + pos : pos));
-}
+  // keep track of prev parsing details on loop through buf
+  Parsing prev;
 
-template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::get_input(
-      const Instance& instance) const noexcept -> InputResult {
-  const auto& input = instance.input();
-  return {input(), input.value()};
-}
+  // loop over opts
+  CLType pos = 0;
+  while (!buf.empty()) {
+    parse_opt<Policy>(++pos, next(), prev, errors, res);
+  }
 
-template <typename TChar>
-[[nodiscard]] bool BasicOpts<TChar>::is_input_internal(
-      const StringView name, const InstancePos pos) const {
-  const auto& instances = std::get<1>( map_.at(name) )->instances();
-  return is_input_internal(
-            instances.at(pos < 0 ? instances.size() + pos : pos));
-}
+  // if prev set, then last mandatory flag was expecting an input
+  parse_opt_finish(pos, prev, errors, res);
 
-template <typename TChar>
-[[nodiscard]] bool BasicOpts<TChar>::is_input_external(
-      const StringView name, const InstancePos pos) const {
-  const auto& instances = std::get<1>(map_.at(name))->instances();
-  return is_input_external(
-            instances.at(pos < 0 ? instances.size() + pos : pos));
+  return errors;
 }
 
+// parse the opts viewed in cl_views_
 template <typename TChar>
-[[nodiscard]] bool BasicOpts<TChar>::is_input_internal(
-      const Instance& instance) const noexcept {
-  return instance.input().type() == InputType::internal;
-}
+template <typename Policy, typename TPos>
+bool BasicCompiledSpec<TChar>::parse_saved(ResultFor<TPos>& res) const {
+  // set to true if any parsing errors found
+  bool errors = false;
 
-template <typename TChar>
-[[nodiscard]] bool BasicOpts<TChar>::is_input_external(
-      const Instance& instance) const noexcept {
-  return instance.input().type() == InputType::external;
-}
+  // keep track of prev parsing details on loop through argv
+  Parsing prev;
 
-template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::get_name(
-      const StringView name, const InstancePos pos) const -> StringView {
-  const auto& instances = std::get<1>( map_.at(name) )->instances();
-  return get_name(instances.at(pos < 0 ? instances.size() + pos : pos));
-}
+  // loop over opts
+  const CLType end = 1 + res.cl_views_.size();
+  check_fits<TPos>(end - 1, 0);
+  res.view_opts(res.cl_views_.data());
+  for (CLType pos = 1; pos < end; ++pos) {
+    parse_opt<Policy>(pos, res.cl_views_[pos - 1], prev, errors, res);
+    if (prev.stop && take_tail<Policy>(pos + 1, end, prev, res)) {
+      break;
+    }
+  }
 
-template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::get_name(
-      const Instance& instance) const noexcept -> StringView {
-  return instance.name();
-}
+  // if prev set, then last mandatory flag was expecting an input
+  parse_opt_finish(res.cl_views_.size(), prev, errors, res);
 
-template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::get_opt_name(
-      const StringView name, const InstancePos pos) const -> StringView {
-  return get_name(name, pos);
+  return errors;
 }
 
 template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::get_opt_name(
-      const Instance& instance) const noexcept -> StringView {
-  return get_name(instance);
+template <typename TPos>
+bool BasicCompiledSpec<TChar>::parse(ResultFor<TPos>& res) const {
+  res.bind(*this);
+  return false;
 }
 
 template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::get_flag_name(
-  const StringView name, const InstancePos pos) const -> StringView {
-  return get_name(name, pos);
-}
+template <typename Policy, typename TPos, PosType T>
+bool BasicCompiledSpec<TChar>::parse_parallel(
+      ResultFor<TPos>& res, T argc, Char** argv, T start_at,
+      unsigned int threads) const {
+  // the fewest opts worth a chunk (and a thread) of their own
+  constexpr CLType min_chunk = 4096;
 
-template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::get_flag_name(
-      const Instance& instance) const noexcept -> StringView {
-  return get_name(instance);
-}
+  if (argc > 0 && start_at < 0) {
+    start_at = argc + start_at;
+  }
+  if (argc < 1 || argv == nullptr || start_at < 0 || start_at >= argc
+        || static_cast<CLType>(argc - start_at) < 2 * min_chunk) {
+    return parse<Policy>(res, argc, argv, start_at);
+  }
+  if (threads == 0) {
+    threads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  if (threads < 2 || !can_parse_in_chunks(res)) {
+    return parse<Policy>(res, argc, argv, start_at);
+  }
+  res.bind(*this);
+
+  // the opt at position 'pos' is opts[pos - 1]
+  const Char* const* opts = argv + start_at;
+  const CLType last_pos = static_cast<CLType>(argc - start_at);
+  check_fits<TPos>(last_pos, 0);
+  const CLType end = last_pos + 1;
+
+  // split into about equal shares, each moved on to just after a plain
+  // argument
+  const CLType shares = std::min<CLType>(CLType{threads} * 4,
+                                         last_pos / min_chunk);
+  std::vector<CLType> bounds{1};
+  for (CLType i = 1; i < shares; ++i) {
+    CLType b = std::max(bounds.back() + 1, 1 + last_pos * i / shares);
+    while (b < end && opt_is_flag(opts[b - 2])) {
+      ++b;
+    }
+    if (b >= end) {
+      break;
+    }
+    bounds.push_back(b);
+  }
+  bounds.push_back(end);
 
-template <typename TChar>
-[[nodiscard]] CLType BasicOpts<TChar>::get_pos(
-      const StringView name, const InstancePos pos) const {
-  const auto& instances = std::get<1>( map_.at(name) )->instances();
-  return get_pos(instances.at(pos < 0 ? instances.size() + pos : pos));
-}
+  const std::size_t chunks = bounds.size() - 1;
+  std::vector<ResultFor<TPos>> parts;
+  parts.reserve(chunks);
+  for (std::size_t i = 0; i < chunks; ++i) {
+    parts.emplace_back(*this);
+  }
+  std::vector<Parsing> states(chunks);
+  std::vector<char> chunk_errors(chunks, false);
+
+  const auto parse_part = [&](const std::size_t i) {
+    bool errors = false;
+    parse_chunk<Policy>(opts, bounds[i], bounds[i + 1], states[i], errors,
+                        parts[i]);
+    chunk_errors[i] = errors;
+  };
+  helper::run_work_stealing(chunks, threads, parse_part);
+
+  // the chunks after the first stop flag were parsed as if there were none
+  const auto stopped = std::ranges::find_if(states, &Parsing::stop);
+  if (stopped != states.end() && stopped + 1 != states.end()) {
+    const auto after = static_cast<std::size_t>(stopped - states.begin()) + 1;
+    helper::run_work_stealing(chunks - after, threads,
+                              [&](const std::size_t i) {
+      parts[after + i].bind(*this);
+      states[after + i] = Parsing{};
+      states[after + i].stop = true;
+      parse_part(after + i);
+    });
+  }
 
-template <typename TChar>
-[[nodiscard]] CLType BasicOpts<TChar>::get_pos(
-      const Instance& instance) const noexcept {
-  return instance.pos();
-}
+  bool errors = false;
+  for (std::size_t i = 0; i < chunks; ++i) {
+    res.append(parts[i]);
+    errors = chunk_errors[i] || errors;
+  }
 
-template <typename TChar>
-[[nodiscard]] CLType BasicOpts<TChar>::get_subpos(
-      const StringView name, const InstancePos pos) const {
-  const auto& instances = std::get<1>( map_.at(name) )->instances();
-  return get_subpos(instances.at(pos < 0 ? instances.size() + pos : pos));
-}
+  // if prev set, then last mandatory flag was expecting an input
+  parse_opt_finish(last_pos, states.back(), errors, res);
 
-template <typename TChar>
-[[nodiscard]] CLType BasicOpts<TChar>::get_subpos(
-      const Instance& instance) const noexcept {
-  return instance.subpos();
+  return errors;
 }
 
 template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::get_all_unrecognized_flags() noexcept
-      -> Unrecognized& {
-  return unrecognized_flags_;
-}
+template <typename Policy, typename TPos,
+          std::ranges::random_access_range Argvs, PosType T>
+bool BasicCompiledSpec<TChar>::parse_batch(
+      std::span<std::type_identity_t<ResultFor<TPos>>> results,
+      const Argvs& argvs, const T start_at, const unsigned int threads) const {
+  const auto count = static_cast<std::size_t>(std::ranges::size(argvs));
+  if (results.size() < count) {
+    helper::raise<std::length_error>("parse_batch: fewer results than argvs");
+  }
 
-template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::get_all_unrecognized_flags() const noexcept
-      -> const Unrecognized& {
-  return unrecognized_flags_;
+  std::atomic<bool> errors{false};
+  helper::run_work_stealing(count, threads, [&](const std::size_t i) {
+    const auto& argv = std::ranges::begin(argvs)[i];
+    if (parse<Policy>(results[i], static_cast<T>(std::ranges::size(argv)),
+              std::ranges::data(argv), start_at)) {
+      errors.store(true, std::memory_order_relaxed);
+    }
+  });
+  return errors.load();
 }
 
 template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::get_all_unrecognized_opts() noexcept
-      -> Unrecognized& {
-  return get_all_unrecognized_flags();
+[[nodiscard]] auto BasicCompiledSpec<TChar>::create_error_string(
+      const ErrorInfo& error) const -> String {
+  String str;
+  write_error_string(str, error);
+  return str;
 }
 
 template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::get_all_unrecognized_opts() const noexcept
-      -> const Unrecognized& {
-  return get_all_unrecognized_flags();
+template <typename Str>
+void BasicCompiledSpec<TChar>::write_error_string(
+      Str& out, const ErrorInfo& error) const {
+  if ( !error_formats_tainted_ ) {
+    if (const auto it = error_formats_.find(error.key);
+        it != error_formats_.end()) {
+      it->second.write(out, error);
+      return;
+    }
+  }
+  // the formats have changed since they were last compiled
+  ErrorFormat{preamble_ + get_error_string_prototype(error.key) + postscript_}
+    .write(out, error);
 }
 
 template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::get_unrecognized_flag(
-      const UnrecognizedPos pos) -> Arg& {
-  return const_cast<Arg&>(std::as_const(*this).get_unrecognized_flag(pos));
+template <std::output_iterator<const TChar&> Out>
+Out BasicCompiledSpec<TChar>::write_error_to(
+      Out out, const ErrorInfo& error) const {
+  if ( !error_formats_tainted_ ) {
+    if (const auto it = error_formats_.find(error.key);
+        it != error_formats_.end()) {
+      return it->second.write_to(out, error);
+    }
+  }
+  return ErrorFormat{preamble_ + get_error_string_prototype(error.key)
+                       + postscript_}.write_to(out, error);
 }
 
+// compile the error string prototype of every error key, as it will be
+// written out, with the preamble and postscript
 template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::get_unrecognized_flag(
-      const UnrecognizedPos pos) const -> const Arg& {
-  return unrecognized_flags_.at(
-      pos < 0 ? unrecognized_flags_.size() + pos : pos );
+void BasicCompiledSpec<TChar>::compile_error_formats() {
+  if ( !error_formats_tainted_ ) {
+    return;
+  }
+  error_formats_.clear();
+  for (const auto key: error_keys) {
+    error_formats_.emplace(key, ErrorFormat{
+      preamble_ + get_error_string_prototype(key) + postscript_});
+  }
+  error_formats_tainted_ = false;
 }
 
 template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::get_unrecognized_opt(
-      const UnrecognizedPos pos) -> Arg& {
-  return get_unrecognized_flag(pos);
+[[nodiscard]] auto BasicCompiledSpec<TChar>::get_error_string_prototype(
+      const ErrorKey key) const -> String {
+  if (const auto it = custom_error_message_.find(key);
+        it != custom_error_message_.end()) {
+    return it->second;
+  }
+  else {
+    return get_error_string(key);
+  }
 }
 
 template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::get_unrecognized_opt(
-      const UnrecognizedPos pos) const -> const Arg& {
-  return get_unrecognized_flag(pos);
-}
-
-template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::get_all_arguments() noexcept -> Args& {
-  return args_;
-}
-
-template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::get_all_arguments() const noexcept
-      -> const Args& {
-  return args_;
-}
-
-template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::get_argument(const ArgPos pos) -> Arg& {
-  return const_cast<Arg&>(std::as_const(*this).get_argument(pos));
-}
-
-template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::get_argument(const ArgPos pos) const
-      -> const Arg& {
-  return args_.at( pos < 0 ? args_.size() + pos : pos );
-}
-
-template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::get_preamble() const -> StringView {
-  return StringView{preamble_};
-}
-
-template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::get_postscript() const -> StringView {
-  return StringView{postscript_};
-}
-
-template <typename TChar>
-template <typename T>
-bool BasicOpts<TChar>::parse(T&& args) {
-  return parse(std::forward<T>(args), static_cast<CLType>(0));
-}
-
-template <typename TChar>
-template <PosType T>
-bool BasicOpts<TChar>::parse(T argc, Char** argv, T start_at) {
-  guess_types();
-  create_map();
-  clear();
-
-  if (argc < 1 || argv == nullptr || start_at >= argc) {
-    return false;
-  }
-  if (start_at < 0) {
-    start_at = argc + start_at;
-  }
-  if (start_at < 0) {
-    return false;
-  }
-
-  // set to true if any parsing errors found
-  bool errors = false;
-
-  // keep track of prev parsing details on loop through argv
-  Parsing prev;
-
-  // loop over opts
-  // let's always start 'pos' at 1 so that counting (and referencing) opts
-  // at the command-line begins at 1 and not 0
-  for (CLType pos = 1; pos < 1 + static_cast<CLType>(argc) - start_at; ++pos) {
-    parse_opt(pos, argv[pos - 1 + start_at], prev, errors);
-  }
-
-  // if prev set, then last mandatory flag was expecting an input
-  parse_opt_finish(static_cast<CLType>(argc) - start_at, prev, errors);
-
-  return errors;
-}
-
-template <typename TChar>
-template <typename T, PosType U>
-bool BasicOpts<TChar>::parse(T&& argv, U start_at) {
-  const auto argc = std::size(argv);
-  guess_types();
-  create_map();
-  clear();
-
-  if (argc == 0 || start_at >= argc) {
-    return false;
-  }
-  if (start_at < 0) {
-    start_at = argc + start_at;
-  }
-  if (start_at < 0) {
-    return false;
-  }
-
-  // set to true if any parsing errors found
-  bool errors = false;
-
-  // keep track of prev parsing details on loop through argv
-  Parsing prev;
-
-  // save opts, if need be
-  const bool saved = save_opts(std::forward<T>(argv));
-
-  // loop over opts
-  // let's always start 'pos' at 1 so that counting (and referencing) opts
-  // at the command-line begins at 1 and not 0
-  for (CLType pos = 1; pos < 1 + argc - start_at; ++pos) {
-    if (saved) {
-      parse_opt(pos, cl_opts_[pos - 1], prev, errors);
-    }
-    else {
-      parse_opt(pos, argv[pos - 1 + start_at], prev, errors);
-    }
-  }
-
-  // if prev set, then last mandatory flag was expecting an input
-  parse_opt_finish(argc - start_at, prev, errors);
-
-  return errors;
-}
-
-template <typename TChar>
-template <class... T, typename>
-bool BasicOpts<TChar>::parse(T&&... args) {
-  guess_types();
-  create_map();
-  clear();
-
-  // set to true if any parsing errors found
-  bool errors = false;
-
-  // keep track of prev parsing details on loop through argv
-  Parsing prev;
-
-  // save opts
-  save_opts_pack(std::forward<T>(args)...);
-
-  // loop over opts
-  for (CLType pos = 1; pos < 1 + cl_opts_.size(); ++pos) {
-    parse_opt(pos, cl_opts_[pos - 1], prev, errors);
-  }
-
-  // if prev set, then last mandatory flag was expecting an input
-  parse_opt_finish(cl_opts_.size(), prev, errors);
-
-  return errors;
-}
-
-template <typename TChar>
-bool BasicOpts<TChar>::parse() {
-  guess_types();
-  create_map();
-  clear();
-  return false;
-}
-
-template <typename TChar>
-template <typename Str>
-void BasicOpts<TChar>::format_error(const ErrorKey key, Str&& str) {
-  custom_error_message_[key] = std::forward<Str>(str);
-}
-
-template <typename TChar>
-template <typename T>
-T& BasicOpts<TChar>::write_errors(T& out) {
-  // first, cache the errors
-  cache_errors();
-
-  // then, write the strings in cached_error_strings_
-  for (const auto& error: cached_error_strings_) {
-    out << std::get<1>(error) << static_cast<Char>('\n');
-  }
-
-  return out;
-}
-
-template <typename TChar>
-template <typename T, typename U>
-T& BasicOpts<TChar>::write_error(T& out, const U pos) {
-  cache_errors();
-  out << std::get<1>(cached_error_strings_.at(
-                          pos < 0 ? cached_error_strings_.size() + pos : pos))
-      << static_cast<Char>('\n');
-  return out;
-}
-
-template <typename TChar>
-template <typename T, class... U>
-T& BasicOpts<TChar>::write_errors_with(T& out, const U... keys) {
-  cache_errors();
-  const std::unordered_set<ErrorKey> set{keys...};
-  for (const auto& error: cached_error_strings_) {
-    if (set.contains(std::get<0>(error).key)) {
-      out << std::get<1>(error) << static_cast<Char>('\n');
-    }
-  }
-  return out;
-}
-
-template <typename TChar>
-void BasicOpts<TChar>::cache_errors() {
-  // we will construct error strings (in cached_error_strings_) from the
-  // registered errors (in errors_)
-
-  for (auto& error: errors_) {
-    // take an ErrorInfo object (in errors_) and convert it to a string
-    String error_str = create_error_string(error);
-    // store this string in cached_error_strings_:
-    cached_error_strings_.emplace_back(std::move(error), std::move(error_str));
-  }
-
-  // since the registered errors have now been converted into strings
-  // and inserted into cached_error_strings_, then clear errors_:
-  errors_.clear();
-}
-
-template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::create_error_string(
-      const ErrorInfo& error) const -> String {
-  // first, get the error string prototype
-  String proto = preamble_ + get_error_string_prototype(error.key)
-                           + postscript_;
-
-  // next, convert the prototype string into the final error string
-  convert_error_str(proto, error);
-
-  return proto;
-}
-
-template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::get_error_string_prototype(
-      const ErrorKey key) const -> String {
-  if (custom_error_message_.contains(key)) {
-    return custom_error_message_.at(key);
-  }
-  else {
-    return get_error_string(key);
-  }
-}
-
-template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::get_error_string(const ErrorKey key) const
+[[nodiscard]] auto BasicCompiledSpec<TChar>::get_error_string(const ErrorKey key) const
       -> String {
   switch(key) {
   case ErrorKey::ArgEmpty:
@@ -1475,13 +2588,23 @@ template <typename TChar>
     return helper::ErrorStrings<Char>::stopproscribed_;
   case ErrorKey::Unrecognized:
     return helper::ErrorStrings<Char>::unrecognized;
+  case ErrorKey::UnclosedQuote:
+    return helper::ErrorStrings<Char>::unclosed_quote;
+  case ErrorKey::TrailingEscape:
+    return helper::ErrorStrings<Char>::trailing_escape;
   default:
-    throw InternalError{"internal error: unhandled ErrorKey case"};
+    helper::raise<InternalError>("internal error: unhandled ErrorKey case");
   }
 }
 
 template <typename TChar>
-void BasicOpts<TChar>::guess_types() {
+void BasicCompiledSpec<TChar>::guess_types() {
+  // nothing has changed since the last guess (which declaring a flag counts
+  // as), so every name still has its type
+  if (!flag_type_tainted_) {
+    return;
+  }
+
   // pass down to each flag to handle
   for (auto& i: flags_) {
     i.guess_types(flag_markers_, flag_type_tainted_);
@@ -1490,10 +2613,22 @@ void BasicOpts<TChar>::guess_types() {
 }
 
 template <typename TChar>
-void BasicOpts<TChar>::create_map() {
+void BasicCompiledSpec<TChar>::create_map() {
   if ( !map_tainted_ ) {
     return;
   }
+  // rebuild from scratch: adding flags may have moved the flags (and so
+  // their names) that any previous map would be pointing to
+  map_.clear();
+  trie_.clear();
+  short_table_.clear();
+  marker_table_.assign(flag_markers_);
+  // the names were sorted into a table (and checked for conflicts) at
+  // compile time, which the searches use instead
+  if (!static_names_.empty()) {
+    map_tainted_ = false;
+    return;
+  }
   for (auto& flag: flags_) {
     for (auto& name : flag.names()) {
       auto& m = map_[name.name()];
@@ -1505,203 +2640,276 @@ void BasicOpts<TChar>::create_map() {
       // then the mapping is already present and that is ok, otherwise
       // it is an error
       else if (std::get<0>(m) != &name || std::get<1>(m) != &flag) {
-        throw NameConflictError(
+        helper::raise<NameConflictError>(
           "name conflict error: duplicate flags found");
       }
     }
   }
+  for (const auto& m: map_) {
+    trie_.insert(m.first, m.second);
+    short_table_.insert(m.first, m.second, flag_markers_);
+  }
   map_tainted_ = false;
 }
 
+// whether create_map() would find two flags with the same name
 template <typename TChar>
-template <typename... T>
-void BasicOpts<TChar>::register_error(const ErrorKey key, T&&... data) {
-  errors_.emplace_back(key, std::forward<T>(data)...);
-}
-
-template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::search_flag_all(
-      const StringView opt, const bool short_only) const -> SearchAll {
-  SearchAll all;
-  for (const auto& m: map_) {
-    if ( !opt.starts_with( m.first ) ) {
-      continue;
-    }
-
-    // if opt is long and we are only accepting short opts, then skip it
-    if (short_only && std::get<0>(m.second)->type() == FlagType::long_type) {
-      continue;
-    }
-
-    // if no trailing characters, then we have found an opt:
-    if ( opt.size() == m.first.size() ) {
-      all.emplace_back( m.second );
-      continue;
-    } 
-
-    // start of 'opt' matches an opt name, but we need to examine the
-    // trailing characters.
-    if ( std::get<0>(m.second)->type() == FlagType::short_type ) {
-      // we _could_ check if we're chaining and exclude a bare flag
-      // that has trailing input if we're not chaining here, but
-      // we'll let the later code handle that scenario so that we
-      // don't have to duplicate errors; for now, just return
-      // the opt that was found
-      all.emplace_back(m.second);
-      continue;
-
-      // // if we can chain, then no trailing characters will ever invalidate
-      // // the opt, so we can return ok now
-      // if (can_chain_) { 
-      //   all.emplace_back( m.second );
-      //   continue;
-      // }
-
-      // // if we cannot chain, then only trailing characters behind non-
-      // // bare opts are allowed.
-      // if ( std::get<1>(m.second)->flag_class() != FlagClass::bare ) {
-      //   all.emplace_back( m.second );
-      //   continue;
-      // }
-    }
-    else {
-      // for a long opt, the trailing character must be '=', and for this
-      // method, that is as far as it need go
-      if ( opt[ m.first.size() ] == input_marker_ ) {
-        all.emplace_back( m.second );
-        continue;
+[[nodiscard]] bool BasicCompiledSpec<TChar>::names_conflict() const {
+  if (!map_tainted_) {
+    return false;
+  }
+  std::unordered_set<StringView> names;
+  for (const auto& flag: flags_) {
+    for (const auto& name: flag.names()) {
+      if (!names.insert(name.name()).second) {
+        return true;
       }
     }
   }
-  return all;
+  return false;
 }
 
 template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::search_flag(
+[[nodiscard]] auto BasicCompiledSpec<TChar>::search_flag(
       const StringView opt, const bool stop, const bool short_only) const
       -> SearchRes {
+  return search_flag(StringView{}, opt, stop, short_only);
+}
+
+// search for the flag named by 'prefix' followed by 'opt'; chained opts are
+// searched this way with 'prefix' set to the flag marker of the chain so
+// that the subopt need never be copied into a new string
+template <typename TChar>
+[[nodiscard]] auto BasicCompiledSpec<TChar>::search_flag(
+      const StringView prefix, const StringView opt, const bool stop,
+      const bool short_only) const -> SearchRes {
   if (stop) {
     return {nullptr, nullptr};
   }
 
-  const SearchAll all = search_flag_all(opt, short_only);
-
   SearchRes ret = {nullptr, nullptr};
-  typename String::size_type size = 0;
 
-  for (const auto& i: all) {
-    // Note: std::get<0>(i) is a NamePtr (pointer to BasicName) object
-    if ( std::get<0>(i)->length() > size ) {
-      ret = i;
-      size = std::get<0>(i)->length();
+  // both walks visit every name that the opt starts with in order of
+  // increasing length, so the last name that is accepted here is the
+  // longest match
+  const auto accept = [&](const auto len, const SearchRes& m) {
+    if (accept_match(prefix, opt, len, std::get<0>(m), short_only)) {
+      ret = m;
     }
+  };
+  if (!static_names_.empty()) {
+    walk_static_names(prefix, opt, accept);
+  }
+  else {
+    trie_.walk(prefix, opt, accept);
   }
 
   return ret;
 }
 
+// search for the short flag that is a subopt in a chain; see search_flag for
+// the meaning of 'prefix'. The short name table will usually answer this
+// directly, otherwise fall back to searching the trie
 template <typename TChar>
-[[nodiscard]] bool BasicOpts<TChar>::opt_is_flag(const StringView opt) const {
-  if ( opt.empty() ) {
-    return false;
+[[nodiscard]] auto BasicCompiledSpec<TChar>::search_short_flag(
+      const StringView prefix, const StringView opt, const bool stop) const
+      -> SearchRes {
+  if (stop || opt.empty()) {
+    return {nullptr, nullptr};
+  }
+  if (static_names_.empty()) {
+    if (const auto res = short_table_.find(prefix, opt[0])) {
+      return *res;
+    }
   }
-  return flag_markers_.contains(opt[0]);
+  return search_flag(prefix, opt, false, true);
 }
 
+// whether the name 'pname', which the opt formed by 'prefix' followed by
+// 'opt' starts with and which is 'len' long, is the flag that the opt gives
 template <typename TChar>
-[[nodiscard]] bool BasicOpts<TChar>::opt_is_arg(const StringView opt) const {
-  return !opt_is_flag(opt);
+[[nodiscard]] bool BasicCompiledSpec<TChar>::accept_match(
+      const StringView prefix, const StringView opt, const std::size_t len,
+      const NamePtr pname, const bool short_only) const {
+  const FlagType type = pname->type();
+
+  // if opt is long and we are only accepting short opts, then skip it
+  if (short_only && type == FlagType::long_type) {
+    return false;
+  }
+
+  // if no trailing characters, then we have found an opt:
+  if ( prefix.size() + opt.size() == len ) {
+    return true;
+  }
+
+  // start of the opt matches an opt name, but we need to examine the
+  // trailing characters. For a short opt, we _could_ check if we're
+  // chaining and exclude a bare flag that has trailing input if we're not
+  // chaining here, but we'll let the later code handle that scenario so
+  // that we don't have to duplicate errors; for now, just accept the opt.
+  if ( type == FlagType::short_type ) {
+    return true;
+  }
+
+  // for a long opt, the trailing character must be '=', and for this
+  // method, that is as far as it need go
+  return (len < prefix.size() ? prefix[len] : opt[len - prefix.size()])
+           == input_marker_;
+}
+
+// as BasicNameTrie::walk, but over the sorted name table. The names that
+// share the first 'len' code units of the opt are a run of the table, in
+// which a name of exactly that length sorts first; each code unit of the opt
+// narrows the run by binary search
+template <typename TChar>
+template <typename F>
+void BasicCompiledSpec<TChar>::walk_static_names(
+      const StringView prefix, const StringView opt, F&& visit) const {
+  const auto size = prefix.size() + opt.size();
+  auto first = static_names_.begin();
+  auto last = static_names_.end();
+  for (std::size_t len = 0; first != last; ++len) {
+    if (first->name.size() == len) {
+      visit(len, static_match(*first));
+      ++first;
+    }
+    if (len == size) {
+      return;
+    }
+    const Char c = len < prefix.size() ? prefix[len]
+                                       : opt[len - prefix.size()];
+    const auto run = std::ranges::equal_range(first, last, c,
+        [](const Char a, const Char b) {
+          return std::char_traits<Char>::lt(a, b);
+        },
+        [len](const StaticName& entry) { return entry.name[len]; });
+    first = run.begin();
+    last = run.end();
+  }
 }
 
 template <typename TChar>
-void BasicOpts<TChar>::add_unrecognized_flag(
-      const StringView flag, const CLType pos) {
-  unrecognized_flags_.emplace_back(flag, pos);
-  ++collect_unrecognized_flags_count_;
+[[nodiscard]] auto BasicCompiledSpec<TChar>::find_static_name(
+      const StringView name) const noexcept -> std::optional<FlagPos> {
+  const auto it = std::ranges::lower_bound(static_names_, name, {},
+                                           &StaticName::name);
+  if (it != static_names_.end() && it->name == name) {
+    return it->flag;
+  }
+  return std::nullopt;
 }
 
+// the pointers that the map would hold for 'entry'. Searching never changes
+// a flag, but the parser is handed the same (non-const) pointers as those
+// that the map takes of the flags when it is built
 template <typename TChar>
-void BasicOpts<TChar>::add_argument(const StringView arg, const CLType pos) {
-  args_.emplace_back(arg, pos);
-  ++collect_args_count_;
+[[nodiscard]] auto BasicCompiledSpec<TChar>::static_match(
+      const StaticName& entry) const noexcept -> SearchRes {
+  auto& flag = const_cast<Flag&>(flags_[entry.flag]);
+  return {&flag.names()[entry.index], &flag};
 }
 
 template <typename TChar>
-[[nodiscard]] bool BasicOpts<TChar>::handle_unrecognized(
-      const StringView opt, const CLType pos, const bool stop) {
-  // if it's a flag:
-  if ( opt_is_flag(opt) && !stop ) {
-    if ( are_collecting_unrecognized_flags() ) {
-      if ( unrecognized_flags_within_limit() ) {
-        // add flag to list
-        add_unrecognized_flag(opt, pos);
+[[nodiscard]] bool BasicCompiledSpec<TChar>::opt_is_flag(const StringView opt) const {
+  if ( opt.empty() ) {
+    return false;
+  }
+  return marker_table_.contains(opt[0]);
+}
+
+template <typename TChar>
+[[nodiscard]] bool BasicCompiledSpec<TChar>::opt_is_arg(const StringView opt) const {
+  return !opt_is_flag(opt);
+}
+
+template <typename TChar>
+template <typename Policy, typename TPos>
+[[nodiscard]] bool BasicCompiledSpec<TChar>::handle_unrecognized(
+      const StringView opt, const bool is_flag, const CLType pos,
+      const bool stop, ResultFor<TPos>& res) const {
+  // if it's a flag:
+  if ( is_flag && !stop ) {
+    if ( are_collecting_unrecognized_flags<Policy>() ) {
+      if ( unrecognized_flags_within_limit(res) ) {
+        // add flag to list
+        res.add_unrecognized_flag(opt, pos);
         return false;
       }
       else {
         // show error: over max limit
-        register_error(ErrorKey::Surplus, pos, opt, true,
-                       collect_unrecognized_flags_);
+        res.register_error(ErrorKey::Surplus, pos, opt, true,
+                           collect_unrecognized_flags_);
         return true;
       }
     }
     else {
       // show error message: unrecognized flag
-      register_error(ErrorKey::Unrecognized, pos, opt, true);
+      res.register_error(ErrorKey::Unrecognized, pos, opt, true);
       return true;
     }
   }
   // ...or is an arg:
   else {
     // check if is empty and we disallow this
-    if ( opt.empty() && !allow_empty_arg_ ) {
-      register_error(ErrorKey::ArgEmpty, pos);
+    if ( opt.empty() && !empty_arguments<Policy>() ) {
+      res.register_error(ErrorKey::ArgEmpty, pos);
       return true;
     }
 
-    if ( are_collecting_args() ) {
-      if ( args_within_limit() ) {
+    if ( are_collecting_args<Policy>() ) {
+      if ( args_within_limit(res) ) {
         // add input to list
-        add_argument(opt, pos);
+        res.add_argument(opt, pos);
         return false;
       }
       else {
         // show error: over max limit
-        register_error(ErrorKey::Surplus, pos, opt, false, collect_args_);
+        res.register_error(ErrorKey::Surplus, pos, opt, false, collect_args_);
         return true;
       }
     }
     else {
       // show error: not accepting args
-      register_error(ErrorKey::Unrecognized, pos, opt, false);
+      res.register_error(ErrorKey::Unrecognized, pos, opt, false);
       return true;
     }
   }
 }
 
 template <typename TChar>
-[[nodiscard]] bool BasicOpts<TChar>::check_within_limit(
+template <typename TPos>
+[[nodiscard]] auto BasicCompiledSpec<TChar>::within_limit(
+      const FlagPtr pflag, const ResultFor<TPos>& res) const -> LimitType {
+  return pflag->within_limit(res.instance_count(flag_pos(*pflag)));
+}
+
+template <typename TChar>
+template <typename TPos>
+[[nodiscard]] bool BasicCompiledSpec<TChar>::check_within_limit(
       const FlagPtr pflag, const NamePtr pname, const CLType pos,
-      const bool is_flag) {
-  const LimitType limit = pflag->within_limit();
+      const bool is_flag, ResultFor<TPos>& res) const {
+  const LimitType limit = within_limit(pflag, res);
   if ( limit == LimitType::Without ) {
-    register_error(ErrorKey::Surplus, pos, pname->name(), is_flag,
-                   pflag->max());
+    res.register_error(ErrorKey::Surplus, pos, pname->name(), is_flag,
+                       pflag->max());
     return true;
   }
   if (limit == LimitType::Proscribed) {
-    register_error(pflag->flag_class() == FlagClass::stop
-                            ? ErrorKey::StopProscribed : ErrorKey::Proscribed,
-                   pos, pname->name(), is_flag);
+    res.register_error(pflag->flag_class() == FlagClass::stop
+                          ? ErrorKey::StopProscribed : ErrorKey::Proscribed,
+                       pos, pname->name(), is_flag);
     return true;
   }
   return false;
 }
 
 template <typename TChar>
-[[nodiscard]] bool BasicOpts<TChar>::check_within_limit(
+template <typename TPos>
+[[nodiscard]] bool BasicCompiledSpec<TChar>::check_within_limit(
       const Parsing& prev, const CLType pos, const bool is_flag,
-      const bool check_subpos) {
-  const LimitType limit = prev.pflag->within_limit();
+      const bool check_subpos, ResultFor<TPos>& res) const {
+  const LimitType limit = within_limit(prev.pflag, res);
   if ( limit == LimitType::Within ) {
     return false;
   }
@@ -1709,128 +2917,217 @@ template <typename TChar>
   if (check_subpos) {
     if ( prev.subpos > 1 ) {
       if (limit == LimitType::Proscribed) {
-        register_error(prev.pflag->flag_class() == FlagClass::stop
-                          ? ErrorKey::StopProscribed_ : ErrorKey::Proscribed_,
-                       pos, prev.subpos, prev.pname->name(), is_flag);
+        res.register_error(prev.pflag->flag_class() == FlagClass::stop
+                            ? ErrorKey::StopProscribed_ : ErrorKey::Proscribed_,
+                           pos, prev.subpos, prev.pname->name(), is_flag);
       }
       else {
         // stop flags can only ever be called once, so no need to
         // check for stop for surplus input errors as we did above
-        register_error(ErrorKey::Surplus_, pos, prev.subpos,
-          prev.pname->name(), is_flag, prev.pflag->max());
+        res.register_error(ErrorKey::Surplus_, pos, prev.subpos,
+              prev.pname->name(), is_flag, prev.pflag->max());
       }
       return true;
     }
     else {
-      return check_within_limit(prev.pflag, prev.pname, pos, is_flag);
+      return check_within_limit(prev.pflag, prev.pname, pos, is_flag, res);
     }
   }
   else {
     if (limit == LimitType::Proscribed) {
-      register_error(prev.pflag->flag_class() == FlagClass::stop
-                        ? ErrorKey::StopProscribed_ : ErrorKey::Proscribed_,
-                     pos, prev.subpos, prev.pname->name(), is_flag);
+      res.register_error(prev.pflag->flag_class() == FlagClass::stop
+                            ? ErrorKey::StopProscribed_ : ErrorKey::Proscribed_,
+                         pos, prev.subpos, prev.pname->name(), is_flag);
     }
     else {
       // stop flags can only ever be called once, so no need to check
       // for stop for surplus input errors as we did above
-      register_error(ErrorKey::Surplus_, pos, prev.subpos,
-                     prev.pname->name(), is_flag, prev.pflag->max());
+      res.register_error(ErrorKey::Surplus_, pos, prev.subpos,
+                         prev.pname->name(), is_flag, prev.pflag->max());
     }
     return true;
   }
 }
 
 template <typename TChar>
-[[nodiscard]] bool BasicOpts<TChar>::add_instance(
-      const Parsing& prev, const CLType pos, const StringView input) {
+template <typename Policy, typename TPos>
+[[nodiscard]] bool BasicCompiledSpec<TChar>::add_instance(
+      const Parsing& prev, const CLType pos, const StringView input,
+      ResultFor<TPos>& res) const {
   // if 'input' is empty, then print error if empty inputs not allowed
-  if ( input.empty() && !allow_empty_input_ ) {
+  if ( input.empty() && !empty_inputs<Policy>() ) {
     if (prev.subpos > 1) {
-      register_error(ErrorKey::EmptyInput_, pos - 1, prev.subpos,
-                     prev.pname->name(), opt_is_flag(prev.pname->name()), pos);
+      res.register_error(ErrorKey::EmptyInput_, pos - 1, prev.subpos,
+                         prev.pname->name(), opt_is_flag(prev.pname->name()),
+                         pos);
     }
     else {
-      register_error(ErrorKey::EmptyInput, pos - 1, prev.pname->name(),
-                     opt_is_flag(prev.pname->name()), pos);
+      res.register_error(ErrorKey::EmptyInput, pos - 1, prev.pname->name(),
+                         opt_is_flag(prev.pname->name()), pos);
     }
     return true;
   }
-  prev.pflag->add_instance(prev.pname->name(), pos-1, prev.subpos,
-                           input, InputType::external);
+  res.add_instance(flag_pos(*prev.pflag), prev.pname->name(), pos-1,
+                   prev.subpos, input, InputType::external);
   return false;
 }
 
 template <typename TChar>
-void BasicOpts<TChar>::add_instance(const Parsing& prev, const CLType pos) {
-  prev.pflag->add_instance(prev.pname->name(), pos-1, prev.subpos);
+template <typename TPos>
+void BasicCompiledSpec<TChar>::add_instance(
+      const Parsing& prev, const CLType pos, ResultFor<TPos>& res) const {
+  res.add_instance(flag_pos(*prev.pflag), prev.pname->name(), pos-1,
+                   prev.subpos);
 }
 
 template <typename TChar>
-void BasicOpts<TChar>::add_instance(
+template <typename TPos>
+void BasicCompiledSpec<TChar>::add_instance(
       const FlagPtr pflag, const NamePtr pname, const CLType pos,
-      const CLType subpos) {
-  pflag->add_instance(pname->name(), pos, subpos);
+      const CLType subpos, ResultFor<TPos>& res) const {
+  res.add_instance(flag_pos(*pflag), pname->name(), pos, subpos);
 }
 
 template <typename TChar>
-void BasicOpts<TChar>::add_instance(
-      const FlagPtr pflag, const NamePtr pname, const CLType pos) {
-  pflag->add_instance(pname->name(), pos, 0);
+template <typename TPos>
+void BasicCompiledSpec<TChar>::add_instance(
+      const FlagPtr pflag, const NamePtr pname, const CLType pos,
+      ResultFor<TPos>& res) const {
+  res.add_instance(flag_pos(*pflag), pname->name(), pos, 0);
 }
 
 template <typename TChar>
-[[nodiscard]] bool BasicOpts<TChar>::add_instance(
+template <typename Policy, typename TPos>
+[[nodiscard]] bool BasicCompiledSpec<TChar>::add_instance(
       const FlagPtr pflag, const NamePtr pname, const CLType pos,
-      const CLType subpos, const StringView input, const InputType type) {
+      const CLType subpos, const StringView input, const InputType type,
+      ResultFor<TPos>& res) const {
   if ( input.empty() ) {
-    if ( allow_empty_input_ ) {
-      pflag->add_instance(pname->name(), pos, subpos, input, type);
+    if ( empty_inputs<Policy>() ) {
+      res.add_instance(flag_pos(*pflag), pname->name(), pos, subpos, input,
+                       type);
     }
     else {
       // this will never trip with subpos > 0
-      register_error(ErrorKey::MissingInput, pos, pname->name(),
-                     opt_is_flag(pname->name()));
+      res.register_error(ErrorKey::MissingInput, pos, pname->name(),
+                         opt_is_flag(pname->name()));
       return true;
     }
   }
   else {
-    pflag->add_instance(pname->name(), pos, subpos, input, type);
+    res.add_instance(flag_pos(*pflag), pname->name(), pos, subpos, input,
+                     type);
   }
   return false;
 }
 
 template <typename TChar>
-[[nodiscard]] bool BasicOpts<TChar>::add_instance(
+template <typename Policy, typename TPos>
+[[nodiscard]] bool BasicCompiledSpec<TChar>::add_instance(
       const FlagPtr pflag, const NamePtr pname, const CLType pos,
-      const StringView input, const InputType type) {
-  return add_instance(pflag, pname, pos, 0, input, type);
+      const StringView input, const InputType type,
+      ResultFor<TPos>& res) const {
+  return add_instance<Policy>(pflag, pname, pos, 0, input, type, res);
 }
 
 template <typename TChar>
-[[nodiscard]] bool BasicOpts<TChar>::are_collecting_args() const noexcept {
-  return collect_args_ > 0;
+template <typename Policy>
+[[nodiscard]] bool BasicCompiledSpec<TChar>::are_collecting_args()
+      const noexcept {
+  if constexpr (Policy::arguments.has_value()) {
+    return *Policy::arguments;
+  }
+  else {
+    return collect_args_ > 0;
+  }
 }
 
 template <typename TChar>
-[[nodiscard]] bool BasicOpts<TChar>::args_within_limit() const noexcept {
-  return collect_args_count_ < collect_args_;
+template <typename TPos>
+[[nodiscard]] bool BasicCompiledSpec<TChar>::args_within_limit(
+      const ResultFor<TPos>& res) const noexcept {
+  return res.collect_args_count_ < collect_args_;
 }
 
 template <typename TChar>
-[[nodiscard]] bool BasicOpts<TChar>::are_collecting_unrecognized_flags()
+template <typename Policy>
+[[nodiscard]] bool BasicCompiledSpec<TChar>::are_collecting_unrecognized_flags()
       const noexcept {
-  return collect_unrecognized_flags_ > 0;
+  if constexpr (Policy::unrecognized_flags.has_value()) {
+    return *Policy::unrecognized_flags;
+  }
+  else {
+    return collect_unrecognized_flags_ > 0;
+  }
 }
 
+// the parsing behaviour under 'Policy': the value it fixes, if any, or else
+// the value set at run time
 template <typename TChar>
-[[nodiscard]] bool BasicOpts<TChar>::unrecognized_flags_within_limit()
-      const noexcept {
-  return collect_unrecognized_flags_count_ < collect_unrecognized_flags_;
+template <typename Policy>
+[[nodiscard]] bool BasicCompiledSpec<TChar>::chaining() const noexcept {
+  if constexpr (Policy::chaining.has_value()) {
+    return *Policy::chaining;
+  }
+  else {
+    return can_chain_;
+  }
+}
+
+template <typename TChar>
+template <typename Policy>
+[[nodiscard]] Greedy BasicCompiledSpec<TChar>::mandatory_greedy() const noexcept {
+  if constexpr (Policy::mandatory_greedy.has_value()) {
+    return *Policy::mandatory_greedy;
+  }
+  else {
+    return mandatory_greedy_;
+  }
+}
+
+template <typename TChar>
+template <typename Policy>
+[[nodiscard]] bool BasicCompiledSpec<TChar>::optional_greedy() const noexcept {
+  if constexpr (Policy::optional_greedy.has_value()) {
+    return *Policy::optional_greedy;
+  }
+  else {
+    return optional_greedy_;
+  }
+}
+
+template <typename TChar>
+template <typename Policy>
+[[nodiscard]] bool BasicCompiledSpec<TChar>::empty_inputs() const noexcept {
+  if constexpr (Policy::empty_inputs.has_value()) {
+    return *Policy::empty_inputs;
+  }
+  else {
+    return allow_empty_input_;
+  }
+}
+
+template <typename TChar>
+template <typename Policy>
+[[nodiscard]] bool BasicCompiledSpec<TChar>::empty_arguments() const noexcept {
+  if constexpr (Policy::empty_arguments.has_value()) {
+    return *Policy::empty_arguments;
+  }
+  else {
+    return allow_empty_arg_;
+  }
+}
+
+template <typename TChar>
+template <typename TPos>
+[[nodiscard]] bool BasicCompiledSpec<TChar>::unrecognized_flags_within_limit(
+      const ResultFor<TPos>& res) const noexcept {
+  return res.collect_unrecognized_flags_count_ < collect_unrecognized_flags_;
 }
 
 template <typename TChar>
-[[nodiscard]] bool BasicOpts<TChar>::optional_can_take_no_input()
+template <typename Policy>
+[[nodiscard]] bool BasicCompiledSpec<TChar>::optional_can_take_no_input()
       const noexcept {
   //           |     no      .    lax      .   yes       .  opt. greedy
   //     ------|-------------.-------------.-------------.--------------
@@ -1844,66 +3141,75 @@ template <typename TChar>
   //  1) Greedy::no and allow arguments
   //  2) !Greedy::no and not optional greedy and allow arguments AND
   //     allow unrec. flags
-  if (mandatory_greedy_ == Greedy::no) {
-    return are_collecting_args();
+  if (mandatory_greedy<Policy>() == Greedy::no) {
+    return are_collecting_args<Policy>();
   }
   else {
-    return !optional_greedy_ && (are_collecting_args()
-                             && are_collecting_unrecognized_flags());
+    return !optional_greedy<Policy>()
+              && (are_collecting_args<Policy>()
+                    && are_collecting_unrecognized_flags<Policy>());
   }
 }
 
 template <typename TChar>
-[[nodiscard]] bool BasicOpts<TChar>::mandatory_and_greedy(
+template <typename Policy>
+[[nodiscard]] bool BasicCompiledSpec<TChar>::mandatory_and_greedy(
       const Parsing& prev) const noexcept {
   return prev.pflag->flag_class() == FlagClass::mandatory
-            && mandatory_greedy_ == Greedy::yes;
+            && mandatory_greedy<Policy>() == Greedy::yes;
 }
 
 template <typename TChar>
-[[nodiscard]] bool BasicOpts<TChar>::optional_and_greedy(
+template <typename Policy>
+[[nodiscard]] bool BasicCompiledSpec<TChar>::optional_and_greedy(
       const Parsing& prev) const noexcept {
-  return prev.pflag->flag_class() == FlagClass::optional && optional_greedy_;
-}
-
-template <typename TChar>
-template <typename T>
-[[nodiscard]] bool BasicOpts<TChar>::save_opts(T&) {
-  // do nothing; do not save opts
-  return false;
-}
-
-template <typename TChar>
-template <typename T>
-[[nodiscard]] bool BasicOpts<TChar>::save_opts(T&& argv) {
-  cl_opts_.reserve(std::size(argv));
-  for (auto& i : argv) {
-    cl_opts_.emplace_back(std::move(i));
+  return prev.pflag->flag_class() == FlagClass::optional
+            && optional_greedy<Policy>();
+}
+
+// a result with positions of type 'TPos' holds positions, subpositions and
+// lengths of names and inputs as 'TPos', all of which are at most the
+// position or length of an opt: raise a std::length_error for an opt at
+// 'pos' of length 'size' that it could not hold (a check that is compiled
+// out when 'TPos' is as wide as both CLType and std::size_t)
+template <typename TChar>
+template <typename TPos>
+void BasicCompiledSpec<TChar>::check_fits(const CLType pos,
+                                          const std::size_t size) {
+  constexpr TPos max = std::numeric_limits<TPos>::max();
+  if constexpr (max < std::numeric_limits<CLType>::max()
+                  || max < std::numeric_limits<std::size_t>::max()) {
+    if (pos > max || size > max) {
+      helper::raise<std::length_error>(
+          "parse: opt position or length exceeds the position type");
+    }
   }
-  return true;
 }
 
 template <typename TChar>
-template <class... T>
-void BasicOpts<TChar>::save_opts_pack(T&&... args) {
-  cl_opts_ = {std::forward<T>(args)...};
-}
+template <typename Policy, typename TPos>
+void BasicCompiledSpec<TChar>::parse_opt(
+      const CLType pos, const StringView opt, Parsing& prev, bool& errors,
+      ResultFor<TPos>& res) const {
+  check_fits<TPos>(pos, opt.size());
 
-template <typename TChar>
-void BasicOpts<TChar>::parse_opt(
-      const CLType pos, const StringView opt, Parsing& prev, bool& errors) {
 
   // take opt as an input to the previous opt if...
   // prev(): true if previous opt expects an input
   // if we are greedy, then take this opt unconditionally now
-  if (prev() && (mandatory_and_greedy(prev) || optional_and_greedy(prev))) {
-    if (add_instance(prev, pos, opt)) {
+  if (prev() && (mandatory_and_greedy<Policy>(prev)
+                   || optional_and_greedy<Policy>(prev))) {
+    if (add_instance<Policy>(prev, pos, opt, res)) {
       errors = true;
     }
     prev.clear();
     return;
   }
 
+  // whether the opt begins with a flag marker: the rest of the parse of the
+  // opt is in terms of this
+  const bool is_flag = opt_is_flag(opt);
+
   // loop over flags and match start of arg with flag name.
   const auto [pname, pflag] = search_flag(opt, prev.stop);
 
@@ -1928,15 +3234,15 @@ void BasicOpts<TChar>::parse_opt(
     if (prev()) {
       // if prev was an optional flag
       if (prev.pflag->flag_class() == FlagClass::optional) {
-        if (opt_is_arg(opt)) {
+        if (!is_flag) {
           // always capture unless we are allowing arguments
-          if ( are_collecting_args() ) {
-            add_instance(prev, pos);
+          if ( are_collecting_args<Policy>() ) {
+            add_instance(prev, pos, res);
             prev.clear();
             // don't return since _this_ opt still needs handling
           }
           else {
-            if (add_instance(prev, pos, opt)) {
+            if (add_instance<Policy>(prev, pos, opt, res)) {
               errors = true;
             }
             prev.clear();
@@ -1946,14 +3252,14 @@ void BasicOpts<TChar>::parse_opt(
         else {
           // capture if not madatory greedy AND not allowing
           // unrecognized flags
-          if (mandatory_greedy_ == Greedy::no
-                                    || are_collecting_unrecognized_flags()) {
-            add_instance(prev, pos);
+          if (mandatory_greedy<Policy>() == Greedy::no
+                || are_collecting_unrecognized_flags<Policy>()) {
+            add_instance(prev, pos, res);
             prev.clear();
             // don't return since _this_ opt still needs handling
           }
           else {
-            if (add_instance(prev, pos, opt)) {
+            if (add_instance<Policy>(prev, pos, opt, res)) {
               errors = true;
             }
             prev.clear();
@@ -1964,9 +3270,10 @@ void BasicOpts<TChar>::parse_opt(
 
       // otherwise it will be a mandatory flag
       else {
-        if ((mandatory_greedy_ == Greedy::lax ||
-                (mandatory_greedy_ == Greedy::no && opt_is_arg(opt)))) {
-          if (add_instance(prev, pos, opt)) {
+        if ((mandatory_greedy<Policy>() == Greedy::lax ||
+                (mandatory_greedy<Policy>() == Greedy::no
+                  && !is_flag))) {
+          if (add_instance<Policy>(prev, pos, opt, res)) {
             errors = true;
           }
           prev.clear();
@@ -1978,12 +3285,14 @@ void BasicOpts<TChar>::parse_opt(
         // the previous opt having a missing input, and then let the code
         // continue to the code block that follows to handle the '-A' flag.
         if (prev.subpos > 1) {
-          register_error(ErrorKey::MissingInput_, pos - 1, prev.subpos,
-                         prev.pname->name(), opt_is_flag(prev.pname->name()));
+          res.register_error(ErrorKey::MissingInput_, pos - 1, prev.subpos,
+                             prev.pname->name(),
+                             opt_is_flag(prev.pname->name()));
         }
         else {
-          register_error(ErrorKey::MissingInput, pos - 1, prev.pname->name(),
-                         opt_is_flag(prev.pname->name()));
+          res.register_error(ErrorKey::MissingInput, pos - 1,
+                             prev.pname->name(),
+                             opt_is_flag(prev.pname->name()));
         }
         errors = true;
         prev.clear();
@@ -1992,7 +3301,7 @@ void BasicOpts<TChar>::parse_opt(
       }
     }
 
-    if (handle_unrecognized(opt, pos, prev.stop)) {
+    if (handle_unrecognized<Policy>(opt, is_flag, pos, prev.stop, res)) {
       errors = true;
     }
     prev.clear();
@@ -2004,17 +3313,17 @@ void BasicOpts<TChar>::parse_opt(
   // just add an instance with no input
   if (prev()) {
     if (prev.pflag->flag_class() == FlagClass::optional) {
-      add_instance(prev, pos);
+      add_instance(prev, pos, res);
     }
     // else a mandatory flag (no other flag class will set 'prev')
     else {
       if (prev.subpos > 1) {
-        register_error(ErrorKey::MissingInput_, pos - 1, prev.subpos,
-                       prev.pname->name(), opt_is_flag(prev.pname->name()));
+        res.register_error(ErrorKey::MissingInput_, pos - 1, prev.subpos,
+                           prev.pname->name(), opt_is_flag(prev.pname->name()));
       }
       else {
-        register_error(ErrorKey::MissingInput, pos - 1, prev.pname->name(),
-                       opt_is_flag(prev.pname->name()));
+        res.register_error(ErrorKey::MissingInput, pos - 1, prev.pname->name(),
+                           opt_is_flag(prev.pname->name()));
       }
       errors = true;
     }
@@ -2024,13 +3333,13 @@ void BasicOpts<TChar>::parse_opt(
   }
 
   if (pname->type() == FlagType::short_type) {
-    if (parse_short_opt(opt, pflag, pname, pos, prev)) {
+    if (parse_short_opt<Policy>(opt, is_flag, pflag, pname, pos, prev, res)) {
       errors = true;
       return;
     }
   }
   else {
-    if (parse_long_opt(opt, pflag, pname, pos, prev)) {
+    if (parse_long_opt<Policy>(opt, is_flag, pflag, pname, pos, prev, res)) {
       errors = true;
       return;
     }
@@ -2038,39 +3347,105 @@ void BasicOpts<TChar>::parse_opt(
 }
 
 template <typename TChar>
-void BasicOpts<TChar>::parse_opt_finish(
-      const CLType last_pos, Parsing& prev, bool& errors) {
+template <typename TPos>
+void BasicCompiledSpec<TChar>::parse_opt_finish(
+      const CLType last_pos, Parsing& prev, bool& errors,
+      ResultFor<TPos>& res) const {
   if (prev()) {
     if (prev.pflag->flag_class() == FlagClass::optional) {
       // optional flag left hanging; that's fine
       // increment last_pos since add_instance will subtract one
-      add_instance(prev, last_pos + 1);
+      add_instance(prev, last_pos + 1, res);
     }
     else {
       if (prev.subpos > 1) {
-        register_error(ErrorKey::MissingInput_, last_pos, prev.subpos,
-          prev.pname->name(), opt_is_flag(prev.pname->name()));
+        res.register_error(ErrorKey::MissingInput_, last_pos, prev.subpos,
+              prev.pname->name(), opt_is_flag(prev.pname->name()));
       }
       else {
-        register_error(ErrorKey::MissingInput, last_pos, prev.pname->name(),
-                       opt_is_flag(prev.pname->name()));
+        res.register_error(ErrorKey::MissingInput, last_pos, prev.pname->name(),
+                           opt_is_flag(prev.pname->name()));
       }
       errors = true;
     }
   }
 }
 
+// whether parsing argv in chunks comes to the same as parsing it in order:
+// so long as no count that a chunk cannot see can change what is made of an
+// opt, and no opt without a flag marker can be a flag (which could then
+// leave a flag waiting for an input at the end of a chunk); response files
+// are only read by parse()
+template <typename TChar>
+template <typename TPos>
+[[nodiscard]] bool BasicCompiledSpec<TChar>::can_parse_in_chunks(
+      const ResultFor<TPos>& res) const {
+  const auto limited = [](const CLType max) {
+    return max != 0 && max != std::numeric_limits<CLType>::max();
+  };
+  if ( res.keep_events_ || res.keep_ranges_ || res.arg_callback_
+         || res.unrecognized_callback_ || res.error_callback_
+         || !res.flag_callbacks_.empty() || limited(collect_args_)
+         || limited(collect_unrecognized_flags_)
+         || response_files_ != ResponseFiles::no ) {
+    return false;
+  }
+  for (const auto& flag: flags_) {
+    if (limited(flag.max())) {
+      return false;
+    }
+    for (const auto& name: flag.names()) {
+      if (!opt_is_flag(name.name())) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// parse the opts at positions [first, end), where the opt at position 'pos'
+// is argv[pos - 1], as parse() does, going on from the state 'prev'
+template <typename TChar>
+template <typename Policy, typename TPos>
+void BasicCompiledSpec<TChar>::parse_chunk(
+      const Char* const* argv, const CLType first, const CLType end,
+      Parsing& prev, bool& errors, ResultFor<TPos>& res) const {
+  for (CLType pos = first; pos < end; ++pos) {
+    parse_opt<Policy>(pos, argv[pos - 1], prev, errors, res);
+  }
+}
+
+// with argument ranges kept, everything after a stop flag is taken as the
+// tail without being parsed, as long as parsing it would make no more of it
+// than that: arguments, within their limit, and no events to log
+template <typename TChar>
+template <typename Policy, typename TPos>
+[[nodiscard]] bool BasicCompiledSpec<TChar>::take_tail(
+      const CLType pos, const CLType end, const Parsing& prev,
+      ResultFor<TPos>& res) const {
+  if ( !res.keep_ranges_ || res.keep_events_ || res.arg_callback_
+         || prev() ) {
+    return false;
+  }
+  if ( !are_collecting_args<Policy>()
+         || end - pos > collect_args_ - res.collect_args_count_ ) {
+    return false;
+  }
+  res.add_tail(pos, end);
+  return true;
+}
+
 template <typename TChar>
-[[nodiscard]] bool BasicOpts<TChar>::parse_short_opt(
-      const StringView opt, const FlagPtr pflag, const NamePtr pname,
-      const CLType pos, Parsing& prev) {
+template <typename Policy, typename TPos>
+[[nodiscard]] bool BasicCompiledSpec<TChar>::parse_short_opt(
+      const StringView opt, const bool is_flag, const FlagPtr pflag,
+      const NamePtr pname, const CLType pos, Parsing& prev,
+      ResultFor<TPos>& res) const {
   using StringSize = typename String::size_type;
 
   // when chaining opts, we will fill in any present flag marker characters
-  // that begin this chain
-  const auto [flag_marker, fill_count] = opt_is_flag(opt)
-    ? std::make_tuple<Char, StringSize>(static_cast<Char>(opt[0]), 1)
-    : std::make_tuple<Char, StringSize>(static_cast<Char>('\0'), 0);
+  // that begin this chain (i.e., the first 'fill_count' characters of 'opt')
+  const StringSize fill_count = is_flag ? 1 : 0;
 
   // generally, we will return immediately if there are errors, since the
   // remaining opt string should be interpreted as unreliable, but for
@@ -2085,7 +3460,7 @@ template <typename TChar>
   for (StringSize i = 0, skip = 0; i < opt.size(); i += skip) {
     if ( prev() ) {
       // check prev is within limits
-      //if ( check_within_limit(prev, pos, fill_count > 0 )) {
+      //if ( check_within_limit(prev, pos, fill_count > 0 , res)) {
       //  // continue parsing
       //  errors = true;
       //}
@@ -2096,10 +3471,10 @@ template <typename TChar>
         // we will exit with error anyway, so don't worry about the
         // return value; cast to void to suppress the nodiscard
         // warning as per above
-        (void)check_within_limit(prev, pos, fill_count > 0, true);
+        (void)check_within_limit(prev, pos, fill_count > 0, true, res);
 
-        register_error(ErrorKey::StopInput, pos, prev.pname->name(),
-                            fill_count > 0, opt.substr(i));
+        res.register_error(ErrorKey::StopInput, pos, prev.pname->name(),
+                                fill_count > 0, opt.substr(i));
         // don't clear 'prev.stop' set to true previously, since although
         // there is input that follows, we will interpret the presence of
         // the stop flag itself as not an error.
@@ -2112,18 +3487,18 @@ template <typename TChar>
       else if ( prev.pflag->flag_class() == FlagClass::optional
                   || prev.pflag->flag_class() == FlagClass::mandatory ) {
 
-        if ( check_within_limit(prev, pos, fill_count > 0, true )) {
+        if ( check_within_limit(prev, pos, fill_count > 0, true , res)) {
           errors = true;
         }
 
         if (prev.subpos > 1) {
-          errors = add_instance(prev.pflag, prev.pname, pos, prev.subpos,
-                       opt.substr(i), InputType::internal)
+          errors = add_instance<Policy>(prev.pflag, prev.pname, pos,
+                       prev.subpos, opt.substr(i), InputType::internal, res)
                 || errors;
         }
         else {
-          errors = add_instance(prev.pflag, prev.pname, pos,
-                       opt.substr(i), InputType::internal)
+          errors = add_instance<Policy>(prev.pflag, prev.pname, pos,
+                       opt.substr(i), InputType::internal, res)
                 || errors;
         }
         prev.clear();
@@ -2135,16 +3510,17 @@ template <typename TChar>
 
       // bare flag or stop flag
       else {
-        // search for flags
-        const String subopt = String(fill_count, flag_marker)
-                                + String{opt.substr(i)};
+        // search for flags: the subopt is the flag marker that began the
+        // chain (if any) followed by the rest of the opt, which we search
+        // for in place rather than building it as a new string
         // if we cannot chain, then we should not find a flag in subopt
         // even if it matches one; effectively, this is identical to having
         // a stop flag set, so when calling 'search_flag' we will check for
         // 'prev.stop' OR check if we cannot chain opts
-        auto [ next_pname, next_pflag ] = search_flag(
-                                            subopt, prev.stop || !can_chain_,
-                                            true);
+        auto [ next_pname, next_pflag ] = search_short_flag(
+                                            opt.substr(0, fill_count),
+                                            opt.substr(i),
+                                            prev.stop || !chaining<Policy>());
 
         // subopt is not a flag, so this must be an input to a bare opt,
         // which is an error
@@ -2153,20 +3529,20 @@ template <typename TChar>
           // we will exit with error anyway, so don't worry about the
           // return value; cast to void to suppress the nodiscard
           // warning as per above
-          (void)check_within_limit(prev, pos, fill_count > 0, true);
+          (void)check_within_limit(prev, pos, fill_count > 0, true, res);
 
           if (prev.subpos > 1) {
             if ( prev.pflag->flag_class() == FlagClass::stop ) {
               // _will_ set prev.stop even though there is an error here
               prev.stop = true;
-              register_error(ErrorKey::StopInput_, pos, prev.subpos,
-                             prev.pname->name(),
-                             fill_count > 0, opt.substr(i));
+              res.register_error(ErrorKey::StopInput_, pos, prev.subpos,
+                                 prev.pname->name(),
+                                 fill_count > 0, opt.substr(i));
             }
             else {
-              register_error(ErrorKey::BareInput_, pos, prev.subpos,
-                             prev.pname->name(), fill_count > 0,
-                             opt.substr(i));
+              res.register_error(ErrorKey::BareInput_, pos, prev.subpos,
+                                 prev.pname->name(), fill_count > 0,
+                                 opt.substr(i));
             }
           }
           else {
@@ -2176,24 +3552,24 @@ template <typename TChar>
             if ( prev.pflag->flag_class() == FlagClass::stop ) {
               // _will_ set prev.stop even though there is an error here
               prev.stop = true;
-              register_error(ErrorKey::StopInput, pos, prev.pname->name(),
-                             fill_count > 0, opt.substr(i) );
+              res.register_error(ErrorKey::StopInput, pos, prev.pname->name(),
+                                 fill_count > 0, opt.substr(i) );
             }
             else {
-              register_error(ErrorKey::BareInput, pos, prev.pname->name(),
-                             fill_count > 0, opt.substr(i) );
+              res.register_error(ErrorKey::BareInput, pos, prev.pname->name(),
+                                 fill_count > 0, opt.substr(i) );
             }
           }
           prev.clear();
           return true;
         }
 
-        if ( check_within_limit(prev, pos, fill_count > 0, false) ) {
+        if ( check_within_limit(prev, pos, fill_count > 0, false, res) ) {
           errors = true;
         }
         else {
           // add instance, and set prev for next subopt
-          add_instance(prev.pflag, prev.pname, pos, prev.subpos);
+          add_instance(prev.pflag, prev.pname, pos, prev.subpos, res);
         }
 
         // set skip, which will point us to the next opt in the chain:
@@ -2224,14 +3600,14 @@ template <typename TChar>
   // all but the last subopt (or only opt if no chaining) has been handled,
   // which we need to do now. This last opt is stored in 'prev'.
 
-  if ( check_within_limit(prev, pos, fill_count > 0, true) ) {
+  if ( check_within_limit(prev, pos, fill_count > 0, true, res) ) {
     // continue parsing
     errors = true;
   }
 
   if ( prev.pflag->flag_class() == FlagClass::mandatory ||
           (prev.pflag->flag_class() == FlagClass::optional
-            && !optional_can_take_no_input()) ) {
+            && !optional_can_take_no_input<Policy>()) ) {
     // leave 'prev' so that we should expect an input on the next opt; just
     // set subpos: if subpos is 1 so there was no chaining, reset it to zero
     if (prev.subpos == 1) {
@@ -2240,10 +3616,10 @@ template <typename TChar>
   }
   else {
     if (prev.subpos > 1) {
-      add_instance(prev.pflag, prev.pname, pos, prev.subpos);
+      add_instance(prev.pflag, prev.pname, pos, prev.subpos, res);
     }
     else {
-      add_instance(prev.pflag, prev.pname, pos);
+      add_instance(prev.pflag, prev.pname, pos, res);
     }
     if ( prev.pflag->flag_class() == FlagClass::stop ) {
       prev.stop = true;
@@ -2255,20 +3631,22 @@ template <typename TChar>
 }
 
 template <typename TChar>
-[[nodiscard]] bool BasicOpts<TChar>::parse_long_opt(
-      const StringView opt, const FlagPtr pflag, const NamePtr pname,
-      const CLType pos, Parsing& prev) {
+template <typename Policy, typename TPos>
+[[nodiscard]] bool BasicCompiledSpec<TChar>::parse_long_opt(
+      const StringView opt, const bool is_flag, const FlagPtr pflag,
+      const NamePtr pname, const CLType pos, Parsing& prev,
+      ResultFor<TPos>& res) const {
   bool errors = false;
 
   // check limits if given
-  if ( check_within_limit(pflag, pname, pos, opt_is_flag(opt)) ) {
+  if ( check_within_limit(pflag, pname, pos, is_flag, res) ) {
     errors = true;
   }
 
   if ( opt.size() == pname->length() ) {
     // --bare
     if ( pflag->flag_class() == FlagClass::bare ) {
-      add_instance(pflag, pname, pos);
+      add_instance(pflag, pname, pos, res);
     }
 
     // --optional
@@ -2283,8 +3661,8 @@ template <typename TChar>
       // an input, which are:
       //  1) Greedy::no and allow arguments
       //  2) !Greedy::no and allow arguments AND allow unrec. flags
-      if (optional_can_take_no_input()) {
-        add_instance(pflag, pname, pos);
+      if (optional_can_take_no_input<Policy>()) {
+        add_instance(pflag, pname, pos, res);
       }
       else {
         prev.pflag = pflag;
@@ -2301,7 +3679,7 @@ template <typename TChar>
 
     // --stop (stop opt)
     else {
-      add_instance(pflag, pname, pos);
+      add_instance(pflag, pname, pos, res);
       prev.stop = true;
     }
   }
@@ -2310,13 +3688,13 @@ template <typename TChar>
     if ( pflag->flag_class() == FlagClass::bare ) {
       const StringView input = opt.substr( pname->length() + 1 );
       if ( input.empty() ) {
-        register_error(ErrorKey::BareEmptyInput, pos, pname->name(),
-                       opt_is_flag(pname->name()));
+        res.register_error(ErrorKey::BareEmptyInput, pos, pname->name(),
+                           opt_is_flag(pname->name()));
       }
       else {
-        register_error(ErrorKey::BareInput, pos, pname->name(),
-                       opt_is_flag(pname->name()),
-                       opt.substr( pname->length() + 1 ) );
+        res.register_error(ErrorKey::BareInput, pos, pname->name(),
+                           opt_is_flag(pname->name()),
+                           opt.substr( pname->length() + 1 ) );
       }
       return true;
     }
@@ -2327,13 +3705,13 @@ template <typename TChar>
       prev.stop = true;
       const StringView input = opt.substr( pname->length() + 1 );
       if ( input.empty() ) {
-        register_error(ErrorKey::StopEmptyInput, pos, pname->name(),
-                       opt_is_flag(pname->name()));
+        res.register_error(ErrorKey::StopEmptyInput, pos, pname->name(),
+                           opt_is_flag(pname->name()));
       }
       else {
-        register_error(ErrorKey::StopInput, pos, pname->name(),
-                       opt_is_flag(pname->name()),
-                       opt.substr( pname->length() + 1 ) );
+        res.register_error(ErrorKey::StopInput, pos, pname->name(),
+                           opt_is_flag(pname->name()),
+                           opt.substr( pname->length() + 1 ) );
       }
       return true;
     }
@@ -2341,20 +3719,22 @@ template <typename TChar>
     // --man=input
     if ( pflag->flag_class() == FlagClass::mandatory ) {
       const StringView input = opt.substr( pname->length() + 1 );
-      return add_instance(pflag, pname, pos, input, InputType::internal);
+      return add_instance<Policy>(pflag, pname, pos, input, InputType::internal,
+                                     res);
     }
 
     // --opt=input
     else {
       const StringView input = opt.substr( pname->length() + 1 );
-      return add_instance(pflag, pname, pos, input, InputType::internal);
+      return add_instance<Policy>(pflag, pname, pos, input, InputType::internal,
+                                     res);
     }
   }
   return errors;
 }
 
 template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::registered_flags() const -> CanonNames {
+[[nodiscard]] auto BasicCompiledSpec<TChar>::registered_flags() const -> CanonNames {
   CanonNames ret;
   ret.reserve(flags_.size());
   for (const auto& flag: flags_) {
@@ -2364,9 +3744,2831 @@ template <typename TChar>
 }
 
 template <typename TChar>
-[[nodiscard]] auto BasicOpts<TChar>::registered_opts() const -> CanonNames {
+[[nodiscard]] auto BasicCompiledSpec<TChar>::registered_opts() const -> CanonNames {
   return registered_flags();
 }
 
 
+
+// BasicParseResult
+
+template <typename TChar, typename TPos>
+BasicParseResult<TChar, TPos>::BasicParseResult(Resource* resource)
+  : instances_{resource}, touched_{resource}, args_{resource},
+    arg_ranges_{resource}, unrecognized_flags_{resource},
+    cached_error_strings_{resource}, cl_opts_{resource}, cl_taken_{resource},
+    cl_views_{resource},
+    cl_text_{resource}, errors_{resource}, events_{resource},
+    sources_{resource}
+#ifdef DEFPROB_CLUTILS_HAVE_MMAN
+    , mapped_files_{resource}
+#endif
+    , flag_callbacks_{resource}, handed_{resource}, cl_streamed_{resource}
+{}
+
+template <typename TChar, typename TPos>
+BasicParseResult<TChar, TPos>::BasicParseResult(const Spec& spec,
+                                          Resource* resource)
+  : BasicParseResult{resource}
+{
+  bind(spec);
+}
+
+// prepare for a parse with 'spec': one list of instances per flag
+template <typename TChar, typename TPos>
+void BasicParseResult<TChar, TPos>::bind(const Spec& spec) {
+  spec_ = &spec;
+  clear();
+  instances_.resize(spec.flags().size());
+  if (!flag_callbacks_.empty()) {
+    handed_.resize(spec.flags().size());
+  }
+  events_.bind(spec.flags().size());
+}
+
+template <typename TChar, typename TPos>
+void BasicParseResult<TChar, TPos>::clear() noexcept {
+  // clear saved opts
+  cl_opts_.clear();
+  cl_taken_.clear();
+  cl_views_.clear();
+  cl_text_.clear();
+  // (one streamed opt is kept, to be reused by the next stream)
+  if (cl_streamed_.size() > 1) {
+    cl_streamed_.resize(1);
+  }
+  streamed_spare_ = !cl_streamed_.empty();
+  sources_.clear();
+#ifdef DEFPROB_CLUTILS_HAVE_MMAN
+  mapped_files_.clear();
+#endif
+
+  // clear arguments
+  args_.clear();
+  arg_ranges_.clear();
+  tail_ = {};
+  argv_ = nullptr;
+  argv_views_ = nullptr;
+  collect_args_count_ = 0;
+
+  // clear unrecognized flags
+  unrecognized_flags_.clear();
+  collect_unrecognized_flags_count_ = 0;
+
+  // clear errors
+  clear_errors();
+
+  // clear flag instances: only those of the flags that were given any, so
+  // that this costs no more for a spec of thousands of flags than for one of
+  // a few; but all of them if any could have been changed from outside
+  if (instances_lent_) {
+    for (auto& instances: instances_) {
+      instances.clear();
+    }
+    instances_lent_ = false;
+  }
+  else {
+    for (const auto flag: touched_) {
+      instances_[flag].clear();
+    }
+  }
+  for (const auto flag: touched_) {
+    if (flag < handed_.size()) {
+      handed_[flag] = 0;
+    }
+  }
+  touched_.clear();
+
+  events_.clear();
+}
+
+template <typename TChar, typename TPos>
+void BasicParseResult<TChar, TPos>::clear_errors() noexcept {
+  errors_.clear();
+  cached_error_strings_.clear();
+  errors_handed_ = false;
+}
+
+// every container in the result keeps its capacity between parses, so once
+// a parse has been made, later parses of the same shape do not allocate.
+// Reserving ahead extends this to any parse of up to 'args' opts (counting
+// each subopt of a chain as an opt), at the cost of room for that many
+// instances of every flag (or its maximum, if lower); or, if the event log is
+// the only store, for that many events in the one block of the log
+template <typename TChar, typename TPos>
+void BasicParseResult<TChar, TPos>::reserve(const CLType args) {
+  if (spec_ == nullptr) {
+    helper::raise<std::out_of_range>(
+        "parse result has not been parsed with a spec");
+  }
+  if (!events_only_) {
+    const auto& flags = spec_->flags();
+    for (FlagPos i = 0; i < flags.size(); ++i) {
+      instances_[i].reserve(std::min(args, flags[i].max()));
+    }
+    touched_.reserve(std::min(args, static_cast<CLType>(flags.size())));
+    args_.reserve(args);
+    unrecognized_flags_.reserve(args);
+  }
+  errors_.reserve(args + 1);
+  cl_views_.reserve(args);
+  cl_opts_.reserve(args);
+  if (keep_events_) {
+    events_.reserve(args);
+  }
+}
+
+template <typename TChar, typename TPos>
+void BasicParseResult<TChar, TPos>::keep_events(const bool keep) noexcept {
+  keep_events_ = keep;
+  events_only_ = false;
+}
+
+template <typename TChar, typename TPos>
+void BasicParseResult<TChar, TPos>::keep_events_only(const bool only)
+      noexcept {
+  keep_events_ = true;
+  events_only_ = only;
+}
+
+template <typename TChar, typename TPos>
+void BasicParseResult<TChar, TPos>::keep_argument_ranges(
+      const bool keep) noexcept {
+  keep_ranges_ = keep;
+}
+
+template <typename TChar, typename TPos>
+void BasicParseResult<TChar, TPos>::set_argument_callback(
+      ArgCallback callback) {
+  arg_callback_ = std::move(callback);
+}
+
+template <typename TChar, typename TPos>
+void BasicParseResult<TChar, TPos>::set_flag_callback(
+      const FlagHandle flag, InstanceCallback callback) {
+  if (flag.pos() >= flag_callbacks_.size()) {
+    flag_callbacks_.resize(flag.pos() + 1);
+  }
+  if (flag.pos() >= handed_.size()) {
+    handed_.resize(flag.pos() + 1);
+  }
+  flag_callbacks_[flag.pos()] = std::move(callback);
+}
+
+template <typename TChar, typename TPos>
+void BasicParseResult<TChar, TPos>::set_unrecognized_flag_callback(
+      ArgCallback callback) {
+  unrecognized_callback_ = std::move(callback);
+}
+
+template <typename TChar, typename TPos>
+void BasicParseResult<TChar, TPos>::set_error_callback(
+      ErrorCallback callback) {
+  error_callback_ = std::move(callback);
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::spec() const noexcept
+      -> const Spec* {
+  return spec_;
+}
+
+// true if the result holds any errors from its last parse
+template <typename TChar, typename TPos>
+[[nodiscard]] bool BasicParseResult<TChar, TPos>::has_errors() const noexcept {
+  return !errors_.empty() || !cached_error_strings_.empty() || errors_handed_;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::flag_instances(const StringView name)
+      const -> const Instances& {
+  if (spec_ == nullptr) {
+    helper::raise<std::out_of_range>(
+        "parse result has not been parsed with a spec");
+  }
+  return flag_instances(spec_->flag_pos(name));
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::flag_instances(const FlagPos flag)
+      const -> const Instances& {
+  return instances_[flag];
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::flag_instances(
+      const FlagHandle flag) const -> const Instances& {
+  if (flag.pos() >= instances_.size()) {
+    helper::raise<std::out_of_range>(
+        "flag handle does not refer to a flag of the spec");
+  }
+  return instances_[flag.pos()];
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::find_instances(
+      const StringView name) const noexcept -> const Instances* {
+  if (spec_ == nullptr) {
+    return nullptr;
+  }
+  if (const auto flag = spec_->find_flag_pos(name)) {
+    return &instances_[*flag];
+  }
+  return nullptr;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::find_instances(
+      const FlagHandle flag) const noexcept -> const Instances* {
+  return flag.pos() < instances_.size() ? &instances_[flag.pos()] : nullptr;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::flag_index(
+      const StringView name) const -> FlagPos {
+  if (spec_ == nullptr) {
+    helper::raise<std::out_of_range>(
+        "parse result has not been parsed with a spec");
+  }
+  return spec_->flag_pos(name);
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::flag_index(
+      const FlagHandle flag) const -> FlagPos {
+  if (flag.pos() >= instances_.size()) {
+    helper::raise<std::out_of_range>(
+        "flag handle does not refer to a flag of the spec");
+  }
+  return flag.pos();
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::find_flag_index(
+      const StringView name) const noexcept -> std::optional<FlagPos> {
+  if (spec_ == nullptr) {
+    return std::nullopt;
+  }
+  return spec_->find_flag_pos(name);
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::find_flag_index(
+      const FlagHandle flag) const noexcept -> std::optional<FlagPos> {
+  if (flag.pos() >= instances_.size()) {
+    return std::nullopt;
+  }
+  return flag.pos();
+}
+
+// the number of instances of 'flag' that the queries can see: those in
+// instances_ or, if it is their only store, in the event log
+template <typename TChar, typename TPos>
+[[nodiscard]] CLType BasicParseResult<TChar, TPos>::kept_count(
+      const FlagPos flag) const noexcept {
+  return events_only_ ? events_.count(flag) : instances_[flag].size();
+}
+
+// the instance of 'flag' at 'pos' (as the 'pos' argument of the queries, so
+// negative from the back), wherever it is kept; if in the event log, its
+// chain is walked, but for the last instance, which is at its tail
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::find_instance(
+      const std::optional<FlagPos> flag, const InstancePos pos) const noexcept
+      -> std::optional<Instance> {
+  if (!flag) {
+    return std::nullopt;
+  }
+  const auto size = static_cast<InstancePos>(kept_count(*flag));
+  const auto i = pos < 0 ? size + pos : pos;
+  if (i < 0 || i >= size) {
+    return std::nullopt;
+  }
+  if (!events_only_) {
+    return instances_[*flag][static_cast<std::size_t>(i)];
+  }
+
+  auto event = events_.last(*flag);
+  if (i + 1 < size) {
+    event = events_.first(*flag);
+    for (InstancePos k = 0; k < i; ++k) {
+      event = events_.next(event);
+    }
+  }
+  if (events_.has_input(event)) {
+    return Instance{events_.name(event), events_.pos(event),
+                    events_.subpos(event), events_.input(event),
+                    events_.input_type(event)};
+  }
+  return Instance{events_.name(event), events_.pos(event),
+                  events_.subpos(event)};
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::instance_at(
+      const FlagPos flag, const InstancePos pos) const -> Instance {
+  if (auto instance = find_instance(flag, pos)) {
+    return *instance;
+  }
+  helper::raise<std::out_of_range>("no instance of the flag at that index");
+}
+
+// record that 'flag' is about to be given an instance, for clear()
+template <typename TChar, typename TPos>
+void BasicParseResult<TChar, TPos>::touch(const FlagPos flag) {
+  if (instances_[flag].empty()) {
+    touched_.push_back(flag);
+  }
+}
+
+template <typename TChar, typename TPos>
+void BasicParseResult<TChar, TPos>::add_instance(
+      const FlagPos flag, const StringView name, const CLType pos,
+      const CLType subpos, const StringView input, const InputType type) {
+  if (is_handed(flag)) {
+    hand_instance(flag, subpos > 0 ? Instance{name, pos, subpos, input, type}
+                                   : Instance{name, pos, input, type});
+    return;
+  }
+  if (keep_events_) {
+    events_.add(EventLog::Kind::instance, flag, name, pos, subpos, input,
+                type);
+    if (events_only_) {
+      return;
+    }
+  }
+  touch(flag);
+  if (subpos > 0) {
+    // if subpos is set
+    instances_[flag].emplace_back(name, pos, subpos, input, type);
+  }
+  else {
+    instances_[flag].emplace_back(name, pos, input, type);
+  }
+}
+
+template <typename TChar, typename TPos>
+void BasicParseResult<TChar, TPos>::add_instance(
+      const FlagPos flag, const StringView name, const CLType pos,
+      const CLType subpos) {
+  if (is_handed(flag)) {
+    hand_instance(flag, subpos > 0 ? Instance{name, pos, subpos}
+                                   : Instance{name, pos});
+    return;
+  }
+  if (keep_events_) {
+    events_.add(EventLog::Kind::instance, flag, name, pos, subpos);
+    if (events_only_) {
+      return;
+    }
+  }
+  touch(flag);
+  if (subpos > 0) {
+    instances_[flag].emplace_back(name, pos, subpos);
+  }
+  else {
+    instances_[flag].emplace_back(name, pos);
+  }
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] CLType BasicParseResult<TChar, TPos>::instance_count(
+      const FlagPos flag) const noexcept {
+  return kept_count(flag) + (flag < handed_.size() ? handed_[flag] : 0);
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] bool BasicParseResult<TChar, TPos>::is_handed(
+      const FlagPos flag) const noexcept {
+  return flag < flag_callbacks_.size() && flag_callbacks_[flag];
+}
+
+// an instance handed over is only counted, and the flag touched so that the
+// count is cleared with the result
+template <typename TChar, typename TPos>
+void BasicParseResult<TChar, TPos>::hand_instance(const FlagPos flag,
+                                                  const Instance& instance) {
+  if (handed_[flag]++ == 0 && instances_[flag].empty()) {
+    touched_.push_back(flag);
+  }
+  flag_callbacks_[flag](instance);
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::events() const noexcept
+      -> const EventLog& {
+  return events_;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_all_errors() const noexcept
+      -> const Errors& {
+  return errors_;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_all_errors() noexcept
+      -> Errors& {
+  return errors_;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] bool BasicParseResult<TChar, TPos>::have_opt(
+      const StringView name) const {
+  return kept_count(flag_index(name)) > 0;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] bool BasicParseResult<TChar, TPos>::has_opt(
+      const StringView name) const {
+  return have_opt(name);
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] bool BasicParseResult<TChar, TPos>::have_flag(
+      const StringView name) const {
+  return have_opt(name);
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] bool BasicParseResult<TChar, TPos>::has_flag(
+      const StringView name) const {
+  return have_opt(name);
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] bool BasicParseResult<TChar, TPos>::has_input(
+      const StringView name, const InstancePos pos) const {
+  return has_input(instance_at(flag_index(name), pos));
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] bool BasicParseResult<TChar, TPos>::has_input(
+      const Instance& instance) const noexcept {
+  return instance.input()();
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_all_instances(
+      const StringView name) -> Instances& {
+  auto& instances =
+    const_cast<Instances&>(std::as_const(*this).get_all_instances(name));
+  instances_lent_ = true;
+  return instances;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_all_instances(
+      const StringView name) const -> const Instances& {
+  return flag_instances(name);
+}
+
+// pos can be 0, ..., N-1 to get instance k from N total, or else negative
+// fetching retrograde from -1, ..., -N.
+// return will be: <flag_has_input?, input>
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_input(
+      const StringView name, const InstancePos pos) const -> InputResult {
+  return get_input(instance_at(flag_index(name), pos));
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_input(
+      const Instance& instance) const noexcept -> InputResult {
+  const auto& input = instance.input();
+  return {input(), input.value()};
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] bool BasicParseResult<TChar, TPos>::is_input_internal(
+      const StringView name, const InstancePos pos) const {
+  return is_input_internal(instance_at(flag_index(name), pos));
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] bool BasicParseResult<TChar, TPos>::is_input_external(
+      const StringView name, const InstancePos pos) const {
+  return is_input_external(instance_at(flag_index(name), pos));
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] bool BasicParseResult<TChar, TPos>::is_input_internal(
+      const Instance& instance) const noexcept {
+  return instance.input().type() == InputType::internal;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] bool BasicParseResult<TChar, TPos>::is_input_external(
+      const Instance& instance) const noexcept {
+  return instance.input().type() == InputType::external;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_name(
+      const StringView name, const InstancePos pos) const -> StringView {
+  return get_name(instance_at(flag_index(name), pos));
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_name(
+      const Instance& instance) const noexcept -> StringView {
+  return instance.name();
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_opt_name(
+      const StringView name, const InstancePos pos) const -> StringView {
+  return get_name(name, pos);
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_opt_name(
+      const Instance& instance) const noexcept -> StringView {
+  return get_name(instance);
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_flag_name(
+  const StringView name, const InstancePos pos) const -> StringView {
+  return get_name(name, pos);
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_flag_name(
+      const Instance& instance) const noexcept -> StringView {
+  return get_name(instance);
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] CLType BasicParseResult<TChar, TPos>::get_pos(
+      const StringView name, const InstancePos pos) const {
+  return get_pos(instance_at(flag_index(name), pos));
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] CLType BasicParseResult<TChar, TPos>::get_pos(
+      const Instance& instance) const noexcept {
+  return instance.pos();
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] CLType BasicParseResult<TChar, TPos>::get_subpos(
+      const StringView name, const InstancePos pos) const {
+  return get_subpos(instance_at(flag_index(name), pos));
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] CLType BasicParseResult<TChar, TPos>::get_subpos(
+      const Instance& instance) const noexcept {
+  return instance.subpos();
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] bool BasicParseResult<TChar, TPos>::have_opt(
+      const FlagHandle flag) const {
+  return kept_count(flag_index(flag)) > 0;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] bool BasicParseResult<TChar, TPos>::has_opt(
+      const FlagHandle flag) const {
+  return have_opt(flag);
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] bool BasicParseResult<TChar, TPos>::have_flag(
+      const FlagHandle flag) const {
+  return have_opt(flag);
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] bool BasicParseResult<TChar, TPos>::has_flag(
+      const FlagHandle flag) const {
+  return have_opt(flag);
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_all_instances(
+      const FlagHandle flag) -> Instances& {
+  auto& instances =
+    const_cast<Instances&>(std::as_const(*this).get_all_instances(flag));
+  instances_lent_ = true;
+  return instances;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_all_instances(
+      const FlagHandle flag) const -> const Instances& {
+  return flag_instances(flag);
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] bool BasicParseResult<TChar, TPos>::has_input(
+      const FlagHandle flag, const InstancePos pos) const {
+  return has_input(instance_at(flag_index(flag), pos));
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_input(
+      const FlagHandle flag, const InstancePos pos) const -> InputResult {
+  return get_input(instance_at(flag_index(flag), pos));
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] bool BasicParseResult<TChar, TPos>::is_input_internal(
+      const FlagHandle flag, const InstancePos pos) const {
+  return is_input_internal(instance_at(flag_index(flag), pos));
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] bool BasicParseResult<TChar, TPos>::is_input_external(
+      const FlagHandle flag, const InstancePos pos) const {
+  return is_input_external(instance_at(flag_index(flag), pos));
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_name(
+      const FlagHandle flag, const InstancePos pos) const -> StringView {
+  return get_name(instance_at(flag_index(flag), pos));
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_opt_name(
+      const FlagHandle flag, const InstancePos pos) const -> StringView {
+  return get_name(flag, pos);
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_flag_name(
+      const FlagHandle flag, const InstancePos pos) const -> StringView {
+  return get_name(flag, pos);
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] CLType BasicParseResult<TChar, TPos>::get_pos(
+      const FlagHandle flag, const InstancePos pos) const {
+  return get_pos(instance_at(flag_index(flag), pos));
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] CLType BasicParseResult<TChar, TPos>::get_subpos(
+      const FlagHandle flag, const InstancePos pos) const {
+  return get_subpos(instance_at(flag_index(flag), pos));
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_all_unrecognized_flags()
+      noexcept -> Unrecognized& {
+  return unrecognized_flags_;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_all_unrecognized_flags()
+      const noexcept -> const Unrecognized& {
+  return unrecognized_flags_;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_all_unrecognized_opts() noexcept
+      -> Unrecognized& {
+  return get_all_unrecognized_flags();
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_all_unrecognized_opts()
+      const noexcept -> const Unrecognized& {
+  return get_all_unrecognized_flags();
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_unrecognized_flag(
+      const UnrecognizedPos pos) -> UnrecognizedFlag& {
+  return const_cast<UnrecognizedFlag&>(
+      std::as_const(*this).get_unrecognized_flag(pos));
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_unrecognized_flag(
+      const UnrecognizedPos pos) const -> const UnrecognizedFlag& {
+  const auto index = pos < 0 ? unrecognized_flags_.size() + pos : pos;
+  if (index >= unrecognized_flags_.size()) {
+    helper::raise<std::out_of_range>("no unrecognized flag at that index");
+  }
+  return unrecognized_flags_[index];
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_unrecognized_opt(
+      const UnrecognizedPos pos) -> UnrecognizedFlag& {
+  return get_unrecognized_flag(pos);
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_unrecognized_opt(
+      const UnrecognizedPos pos) const -> const UnrecognizedFlag& {
+  return get_unrecognized_flag(pos);
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_all_arguments() noexcept
+      -> Args& {
+  return args_;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_all_arguments() const noexcept
+      -> const Args& {
+  return args_;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_argument(const ArgPos pos)
+      -> Arg& {
+  return const_cast<Arg&>(std::as_const(*this).get_argument(pos));
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_argument(const ArgPos pos) const
+      -> const Arg& {
+  const auto index = pos < 0 ? args_.size() + pos : pos;
+  if (index >= args_.size()) {
+    helper::raise<std::out_of_range>("no argument at that index");
+  }
+  return args_[index];
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_argument_ranges()
+      const noexcept -> const ArgRanges& {
+  return arg_ranges_;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_tail() const noexcept
+      -> const ArgRange& {
+  return tail_;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::get_source(const CLType pos)
+      const -> Source {
+  if (sources_.empty()) {
+    return {pos, {}, 0};
+  }
+  if (pos == 0 || pos > sources_.size()) {
+    helper::raise<std::out_of_range>("get_source: no opt at that position");
+  }
+  return sources_[pos - 1];
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::try_have_opt(
+      const StringView name) const noexcept -> std::optional<bool> {
+  if (const auto index = find_flag_index(name)) {
+    return kept_count(*index) > 0;
+  }
+  return std::nullopt;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::try_get_all_instances(
+      const StringView name) const noexcept -> const Instances* {
+  return find_instances(name);
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::try_has_input(
+      const StringView name, const InstancePos pos) const noexcept
+      -> std::optional<bool> {
+  if (const auto instance = find_instance(find_flag_index(name), pos)) {
+    return has_input(*instance);
+  }
+  return std::nullopt;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::try_get_input(
+      const StringView name, const InstancePos pos) const noexcept
+      -> std::optional<InputResult> {
+  if (const auto instance = find_instance(find_flag_index(name), pos)) {
+    return get_input(*instance);
+  }
+  return std::nullopt;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::try_is_input_internal(
+      const StringView name, const InstancePos pos) const noexcept
+      -> std::optional<bool> {
+  if (const auto instance = find_instance(find_flag_index(name), pos)) {
+    return is_input_internal(*instance);
+  }
+  return std::nullopt;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::try_is_input_external(
+      const StringView name, const InstancePos pos) const noexcept
+      -> std::optional<bool> {
+  if (const auto instance = find_instance(find_flag_index(name), pos)) {
+    return is_input_external(*instance);
+  }
+  return std::nullopt;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::try_get_name(
+      const StringView name, const InstancePos pos) const noexcept
+      -> std::optional<StringView> {
+  if (const auto instance = find_instance(find_flag_index(name), pos)) {
+    return get_name(*instance);
+  }
+  return std::nullopt;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::try_get_pos(
+      const StringView name, const InstancePos pos) const noexcept
+      -> std::optional<CLType> {
+  if (const auto instance = find_instance(find_flag_index(name), pos)) {
+    return get_pos(*instance);
+  }
+  return std::nullopt;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::try_get_subpos(
+      const StringView name, const InstancePos pos) const noexcept
+      -> std::optional<CLType> {
+  if (const auto instance = find_instance(find_flag_index(name), pos)) {
+    return get_subpos(*instance);
+  }
+  return std::nullopt;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::try_have_opt(
+      const FlagHandle flag) const noexcept -> std::optional<bool> {
+  if (const auto index = find_flag_index(flag)) {
+    return kept_count(*index) > 0;
+  }
+  return std::nullopt;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::try_get_all_instances(
+      const FlagHandle flag) const noexcept -> const Instances* {
+  return find_instances(flag);
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::try_has_input(
+      const FlagHandle flag, const InstancePos pos) const noexcept
+      -> std::optional<bool> {
+  if (const auto instance = find_instance(find_flag_index(flag), pos)) {
+    return has_input(*instance);
+  }
+  return std::nullopt;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::try_get_input(
+      const FlagHandle flag, const InstancePos pos) const noexcept
+      -> std::optional<InputResult> {
+  if (const auto instance = find_instance(find_flag_index(flag), pos)) {
+    return get_input(*instance);
+  }
+  return std::nullopt;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::try_is_input_internal(
+      const FlagHandle flag, const InstancePos pos) const noexcept
+      -> std::optional<bool> {
+  if (const auto instance = find_instance(find_flag_index(flag), pos)) {
+    return is_input_internal(*instance);
+  }
+  return std::nullopt;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::try_is_input_external(
+      const FlagHandle flag, const InstancePos pos) const noexcept
+      -> std::optional<bool> {
+  if (const auto instance = find_instance(find_flag_index(flag), pos)) {
+    return is_input_external(*instance);
+  }
+  return std::nullopt;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::try_get_name(
+      const FlagHandle flag, const InstancePos pos) const noexcept
+      -> std::optional<StringView> {
+  if (const auto instance = find_instance(find_flag_index(flag), pos)) {
+    return get_name(*instance);
+  }
+  return std::nullopt;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::try_get_pos(
+      const FlagHandle flag, const InstancePos pos) const noexcept
+      -> std::optional<CLType> {
+  if (const auto instance = find_instance(find_flag_index(flag), pos)) {
+    return get_pos(*instance);
+  }
+  return std::nullopt;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::try_get_subpos(
+      const FlagHandle flag, const InstancePos pos) const noexcept
+      -> std::optional<CLType> {
+  if (const auto instance = find_instance(find_flag_index(flag), pos)) {
+    return get_subpos(*instance);
+  }
+  return std::nullopt;
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::try_get_unrecognized_flag(
+      const UnrecognizedPos pos) const noexcept -> const UnrecognizedFlag* {
+  const auto size = static_cast<UnrecognizedPos>(unrecognized_flags_.size());
+  const auto i = pos < 0 ? size + pos : pos;
+  if (i < 0 || i >= size) {
+    return nullptr;
+  }
+  return &unrecognized_flags_[static_cast<std::size_t>(i)];
+}
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::try_get_argument(
+      const ArgPos pos) const noexcept -> const Arg* {
+  const auto size = static_cast<ArgPos>(args_.size());
+  const auto i = pos < 0 ? size + pos : pos;
+  if (i < 0 || i >= size) {
+    return nullptr;
+  }
+  return &args_[static_cast<std::size_t>(i)];
+}
+
+template <typename TChar, typename TPos>
+template <typename T>
+T& BasicParseResult<TChar, TPos>::write_errors(T& out) {
+  // first, cache the errors
+  cache_errors();
+
+  // then, write the strings in cached_error_strings_
+  for (const auto& error: cached_error_strings_) {
+    out << std::get<1>(error) << static_cast<Char>('\n');
+  }
+
+  return out;
+}
+
+template <typename TChar, typename TPos>
+template <typename T, typename U>
+T& BasicParseResult<TChar, TPos>::write_error(T& out, const U pos) {
+  cache_errors();
+  const auto index = pos < 0 ? cached_error_strings_.size() + pos : pos;
+  if (index >= cached_error_strings_.size()) {
+    helper::raise<std::out_of_range>("write_error: no error at that index");
+  }
+  out << std::get<1>(cached_error_strings_[index]) << static_cast<Char>('\n');
+  return out;
+}
+
+template <typename TChar, typename TPos>
+template <typename T, class... U>
+T& BasicParseResult<TChar, TPos>::write_errors_with(T& out, const U... keys) {
+  cache_errors();
+  const ErrorKeySet set{keys...};
+  for (const auto& error: cached_error_strings_) {
+    if (set.contains(std::get<0>(error).key)) {
+      out << std::get<1>(error) << static_cast<Char>('\n');
+    }
+  }
+  return out;
+}
+
+// errors already written to strings come first, as with write_errors
+template <typename TChar, typename TPos>
+template <std::output_iterator<const TChar&> Out>
+Out BasicParseResult<TChar, TPos>::write_errors_to(
+      Out out, const ErrorKeySet keys) const {
+  for (const auto& [info, str]: cached_error_strings_) {
+    if (keys.contains(info.key)) {
+      out = std::ranges::copy(str, out).out;
+      *out++ = static_cast<Char>('\n');
+    }
+  }
+  for (const auto& error: errors_) {
+    if (keys.contains(error.key)) {
+      out = spec_->write_error_to(out, error);
+      *out++ = static_cast<Char>('\n');
+    }
+  }
+  return out;
+}
+
+template <typename TChar, typename TPos>
+template <typename Sink>
+  requires std::invocable<Sink&, const TChar*, std::size_t>
+void BasicParseResult<TChar, TPos>::write_errors_to_sink(
+      Sink&& sink, const ErrorKeySet keys) const {
+  helper::BatchWriter<Char, std::remove_reference_t<Sink>> writer{sink};
+  write_errors_to(writer.begin(), keys);
+  writer.flush();
+}
+
+#ifdef DEFPROB_CLUTILS_HAVE_UNISTD
+template <typename TChar, typename TPos>
+void BasicParseResult<TChar, TPos>::write_errors_to_fd(
+      const int fd, const ErrorKeySet keys) const
+    requires (sizeof(TChar) == 1) {
+  if (const int error = try_write_errors_to_fd(fd, keys); error != 0) {
+    helper::raise<std::system_error>(error, std::generic_category(),
+                                     "write_errors_to_fd");
+  }
+}
+
+// once a write has failed, nothing more is written
+template <typename TChar, typename TPos>
+[[nodiscard]] int BasicParseResult<TChar, TPos>::try_write_errors_to_fd(
+      const int fd, const ErrorKeySet keys) const
+    requires (sizeof(TChar) == 1) {
+  int error = 0;
+  write_errors_to_sink([fd, &error](const Char* data, std::size_t size) {
+    while (size > 0 && error == 0) {
+      const auto n = ::write(fd, data, size);
+      if (n < 0) {
+        if (errno != EINTR) {
+          error = errno;
+        }
+        continue;
+      }
+      data += n;
+      size -= static_cast<std::size_t>(n);
+    }
+  }, keys);
+  return error;
+}
+#endif
+
+template <typename TChar, typename TPos>
+void BasicParseResult<TChar, TPos>::cache_errors() {
+  // we will construct error strings (in cached_error_strings_) from the
+  // registered errors (in errors_)
+
+  cached_error_strings_.reserve(cached_error_strings_.size() + errors_.size());
+  for (auto& error: errors_) {
+    // take an ErrorInfo object (in errors_) and write it out as a string,
+    // straight into cached_error_strings_:
+    auto& [info, str] = cached_error_strings_.emplace_back(std::move(error),
+                                                           StringView{});
+    spec_->write_error_string(str, info);
+  }
+
+  // since the registered errors have now been converted into strings
+  // and inserted into cached_error_strings_, then clear errors_:
+  errors_.clear();
+}
+
+template <typename TChar, typename TPos>
+template <typename... T>
+void BasicParseResult<TChar, TPos>::register_error(
+      const ErrorKey key, T&&... data) {
+  if (error_callback_) {
+    errors_handed_ = true;
+    ErrorInfo info{key, std::forward<T>(data)...};
+    locate_error(info);
+    error_callback_(info);
+    return;
+  }
+  locate_error(errors_.emplace_back(key, std::forward<T>(data)...));
+}
+
+// once response files have been read, the position of an error is that of
+// the expanded opts, so note where in argv (and in which file) it was
+template <typename TChar, typename TPos>
+void BasicParseResult<TChar, TPos>::locate_error(ErrorInfo& info)
+      const noexcept {
+  if (info.pos == 0 || info.pos > sources_.size()) {
+    return;
+  }
+  const auto& source = sources_[info.pos - 1];
+  info.arg = source.arg;
+  info.file = source.file;
+  info.offset = source.offset;
+}
+
+template <typename TChar, typename TPos>
+void BasicParseResult<TChar, TPos>::add_unrecognized_flag(
+      const StringView flag, const CLType pos) {
+  if (unrecognized_callback_) {
+    unrecognized_callback_(flag, pos);
+    ++collect_unrecognized_flags_count_;
+    return;
+  }
+  if (!events_only_) {
+    unrecognized_flags_.emplace_back(flag, pos);
+  }
+  if (keep_events_) {
+    events_.add(EventLog::Kind::unrecognized, EventLog::no_flag, flag, pos, 0);
+  }
+  ++collect_unrecognized_flags_count_;
+}
+
+template <typename TChar, typename TPos>
+void BasicParseResult<TChar, TPos>::add_argument(
+      const StringView arg, const CLType pos) {
+  if (arg_callback_) {
+    arg_callback_(arg, pos);
+    ++collect_args_count_;
+    return;
+  }
+  // the opts of a stream are not in order in memory for a range to view
+  // (see BasicParseStream), so it keeps an Arg each, ranges or not
+  if (!keep_ranges_ || (argv_ == nullptr && argv_views_ == nullptr)) {
+    if (!events_only_) {
+      args_.emplace_back(arg, pos);
+    }
+  }
+  else if (!arg_ranges_.empty() && arg_ranges_.back().end_pos() == pos) {
+    arg_ranges_.back().extend();
+  }
+  else {
+    arg_ranges_.push_back(arg_range(pos, 1));
+  }
+  if (keep_events_) {
+    events_.add(EventLog::Kind::argument, EventLog::no_flag, arg, pos, 0);
+  }
+  ++collect_args_count_;
+}
+
+// the opts at positions [pos, end) are all arguments, taken as one range
+// without being looked at
+template <typename TChar, typename TPos>
+void BasicParseResult<TChar, TPos>::add_tail(const CLType pos,
+                                             const CLType end) {
+  tail_ = arg_range(pos, end - pos);
+  if (!tail_.empty()) {
+    arg_ranges_.push_back(tail_);
+    collect_args_count_ += tail_.size();
+  }
+}
+
+// take on the results of 'part', the parse of the opts that follow those
+// parsed into this result, as if they had been parsed into it too
+template <typename TChar, typename TPos>
+void BasicParseResult<TChar, TPos>::append(const BasicParseResult& part) {
+  for (const auto flag: part.touched_) {
+    touch(flag);
+    const auto& instances = part.instances_[flag];
+    instances_[flag].insert(instances_[flag].end(), instances.begin(),
+                            instances.end());
+  }
+  args_.insert(args_.end(), part.args_.begin(), part.args_.end());
+  unrecognized_flags_.insert(unrecognized_flags_.end(),
+                             part.unrecognized_flags_.begin(),
+                             part.unrecognized_flags_.end());
+  errors_.insert(errors_.end(), part.errors_.begin(), part.errors_.end());
+  collect_args_count_ += part.collect_args_count_;
+  collect_unrecognized_flags_count_ += part.collect_unrecognized_flags_count_;
+}
+
+template <typename TChar, typename TPos>
+template <typename T>
+[[nodiscard]] bool BasicParseResult<TChar, TPos>::save_opts(T&) {
+  // do nothing; do not save opts
+  return false;
+}
+
+template <typename TChar, typename TPos>
+template <typename T>
+[[nodiscard]] bool BasicParseResult<TChar, TPos>::save_opts(T&& argv) {
+  // reserve first: the views must not be invalidated by a reallocation
+  if constexpr ( std::is_same_v<std::remove_cvref_t<decltype(*std::begin(argv))>,
+                                String> ) {
+    cl_taken_.reserve(std::size(argv));
+  }
+  else {
+    cl_opts_.reserve(std::size(argv));
+  }
+  cl_views_.reserve(std::size(argv));
+  for (auto& i : argv) {
+    save_opt(std::move(i));
+  }
+  return true;
+}
+
+template <typename TChar, typename TPos>
+template <class... T>
+void BasicParseResult<TChar, TPos>::save_opts_pack(T&&... args) {
+  cl_opts_.reserve(sizeof...(T));
+  cl_taken_.reserve(sizeof...(T));
+  cl_views_.reserve(sizeof...(T));
+  (save_opt(std::forward<T>(args)), ...);
+}
+
+// the words of 'line' in cl_views_: as views into 'line', or into cl_text_
+// for those that had to be unquoted. Since a word never grows by being
+// unquoted, cl_text_ is made room for all of 'line' first, so that it is
+// never moved while it is being viewed
+template <typename TChar, typename TPos>
+[[nodiscard]] std::optional<ErrorKey>
+BasicParseResult<TChar, TPos>::save_command_line(const StringView line) {
+  cl_text_.reserve(line.size());
+  return helper::tokenize_command_line(line, cl_text_,
+      [this](const StringView word) { cl_views_.push_back(word); });
+}
+
+// strings that are handed over are taken as they are into cl_taken_, and
+// anything that has to be made a string is copied into cl_opts_ (drawing on
+// the memory resource); everything else is only viewed and, as with argv,
+// must outlive the result
+template <typename TChar, typename TPos>
+template <typename T>
+void BasicParseResult<TChar, TPos>::save_opt(T&& opt) {
+  if constexpr ( std::is_same_v<std::remove_cvref_t<T>, String>
+                   && !std::is_lvalue_reference_v<T> ) {
+    cl_views_.emplace_back(cl_taken_.emplace_back(std::move(opt)));
+  }
+  else if constexpr ( std::is_convertible_v<T, StringView> ) {
+    cl_views_.emplace_back(StringView{opt});
+  }
+  else {
+    cl_views_.emplace_back(cl_opts_.emplace_back(std::forward<T>(opt)));
+  }
+}
+
+// the argv of a parse, from the opt at position 1, for the argument ranges
+// to view
+template <typename TChar, typename TPos>
+void BasicParseResult<TChar, TPos>::view_opts(const Char* const* argv)
+      noexcept {
+  argv_ = argv;
+}
+
+template <typename TChar, typename TPos>
+void BasicParseResult<TChar, TPos>::view_opts(const StringView* views)
+      noexcept {
+  argv_views_ = views;
+}
+
+// as above for a container that is parsed in place; one that does not hold
+// its opts as pointers or views in order must have them viewed in cl_views_
+template <typename TChar, typename TPos>
+template <typename T>
+void BasicParseResult<TChar, TPos>::view_opts(T& argv, const CLType start_at) {
+  using Value = std::ranges::range_value_t<T>;
+  if constexpr ( std::ranges::contiguous_range<T>
+                   && (std::is_same_v<Value, Char*>
+                         || std::is_same_v<Value, const Char*>) ) {
+    view_opts(std::ranges::data(argv) + start_at);
+  }
+  else if constexpr ( std::ranges::contiguous_range<T>
+                        && std::is_same_v<Value, StringView> ) {
+    view_opts(std::ranges::data(argv) + start_at);
+  }
+  else if (keep_ranges_) {
+    cl_views_.reserve(std::size(argv));
+    for (const auto& i : argv) {
+      cl_views_.emplace_back(StringView{i});
+    }
+    view_opts(cl_views_.data() + start_at);
+  }
+}
+
+#ifdef DEFPROB_CLUTILS_HAVE_MMAN
+// view the opts of argv from 'start_at' in cl_views_, with each "@file"
+// replaced by the opts read from the file; false, viewing nothing, if there
+// is no "@file" to replace
+template <typename TChar, typename TPos>
+template <typename T>
+[[nodiscard]] bool BasicParseResult<TChar, TPos>::expand_response_files(
+      const T argc, Char** argv, const T start_at, const bool nested)
+    requires (sizeof(Char) == 1) {
+  const auto is_file = [](const Char* opt) {
+    return opt[0] == '@' && opt[1] != 0;
+  };
+  if (std::none_of(argv + start_at, argv + argc, is_file)) {
+    return false;
+  }
+
+  std::vector<std::size_t> expanding;
+  for (T i = start_at; i < argc; ++i) {
+    const Source from{static_cast<CLType>(i - start_at) + 1, {}, 0};
+    if (is_file(argv[i])) {
+      expand_response_file(StringView{argv[i]}, from, nested, expanding);
+    }
+    else {
+      cl_views_.emplace_back(argv[i]);
+      sources_.push_back(from);
+    }
+  }
+  return true;
+}
+
+// the opts of the response file named by 'opt' (which is from 'from'), or
+// 'opt' itself, as GCC has it, if the file cannot be read or is already
+// being read (for a file that names itself, in turn)
+template <typename TChar, typename TPos>
+void BasicParseResult<TChar, TPos>::expand_response_file(
+      const StringView opt, const Source& from, const bool nested,
+      std::vector<std::size_t>& expanding)
+    requires (sizeof(Char) == 1) {
+  auto file = std::make_shared<helper::MappedFile>();
+  const bool literal = [&] {
+    if (file->open(std::string(reinterpret_cast<const char*>(opt.data()) + 1,
+                               opt.size() - 1)) != 0) {
+      return true;
+    }
+    return std::any_of(expanding.begin(), expanding.end(),
+                       [&](const std::size_t i) {
+                         return mapped_files_[i]->same_file(*file);
+                       });
+  }();
+  if (literal) {
+    cl_views_.emplace_back(opt);
+    sources_.push_back(from);
+    return;
+  }
+
+  expanding.push_back(mapped_files_.size());
+  const StringView name{reinterpret_cast<const Char*>(file->name().data()),
+                        file->name().size()};
+  auto* const data = reinterpret_cast<Char*>(file->data());
+  mapped_files_.push_back(std::move(file));
+  helper::tokenize_response_file(
+      data, data + mapped_files_.back()->size(),
+      [&](Char* const first, const std::size_t size, const std::size_t offset) {
+        const StringView view{first, size};
+        const Source source{from.arg, name, offset};
+        if (nested && view.size() > 1 && view[0] == '@') {
+          expand_response_file(view, source, nested, expanding);
+        }
+        else {
+          cl_views_.push_back(view);
+          sources_.push_back(source);
+        }
+      });
+  expanding.pop_back();
+}
+#endif
+
+template <typename TChar, typename TPos>
+[[nodiscard]] auto BasicParseResult<TChar, TPos>::arg_range(
+      const CLType pos, const CLType size) const noexcept -> ArgRange {
+  if (argv_ != nullptr) {
+    return {argv_ + (pos - 1), pos, size};
+  }
+  return {argv_views_ + (pos - 1), pos, size};
+}
+
+
+
+// BasicParseStream
+
+template <typename TChar, typename TPolicy, typename TPos>
+BasicParseStream<TChar, TPolicy, TPos>::BasicParseStream(const Spec& spec,
+                                                         ParseResult& res)
+  : spec_{&spec}, res_{&res}
+{
+  res.bind(spec);
+}
+
+// the opt is parsed as a copy kept by the result, unless it turns out to be
+// an argument that is handed to the callback, in which case the copy is
+// overwritten by the next opt (so that, once its capacity has grown to the
+// longest argument, streaming arguments does not allocate)
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicParseStream<TChar, TPolicy, TPos>::feed(const StringView opt) {
+  auto& res = *res_;
+  if (!res.streamed_spare_) {
+    res.cl_streamed_.emplace_back();
+  }
+  auto& copy = res.cl_streamed_.back();
+  copy.assign(opt);
+  const CLType args = res.collect_args_count_;
+  spec_->template parse_opt<TPolicy>(++pos_, StringView{copy}, prev_, errors_,
+                                     res);
+  res.streamed_spare_ = res.arg_callback_ && res.collect_args_count_ != args;
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+bool BasicParseStream<TChar, TPolicy, TPos>::finish() {
+  // if prev set, then last mandatory flag was expecting an input
+  spec_->parse_opt_finish(pos_, prev_, errors_, *res_);
+  return errors_;
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] CLType BasicParseStream<TChar, TPolicy, TPos>::size()
+      const noexcept {
+  return pos_;
+}
+
+
+
+// BasicOpts
+
+template <typename TChar, typename TPolicy, typename TPos>
+BasicOpts<TChar, TPolicy, TPos>::BasicOpts() {
+  apply_policy();
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+BasicOpts<TChar, TPolicy, TPos>::BasicOpts(Resource* resource)
+  : result_{resource}
+{
+  apply_policy();
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+BasicOpts<TChar, TPolicy, TPos>::BasicOpts(const BasicOpts& other)
+  : spec_{other.spec_}, result_{other.result_}
+{
+  result_.spec_ = &spec_;
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+BasicOpts<TChar, TPolicy, TPos>::BasicOpts(BasicOpts&& other) noexcept
+  : spec_{std::move(other.spec_)}, result_{std::move(other.result_)}
+{
+  result_.spec_ = &spec_;
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+auto BasicOpts<TChar, TPolicy, TPos>::operator=(const BasicOpts& other) -> BasicOpts& {
+  if (this != &other) {
+    spec_ = other.spec_;
+    result_ = other.result_;
+    result_.spec_ = &spec_;
+  }
+  return *this;
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+auto BasicOpts<TChar, TPolicy, TPos>::operator=(BasicOpts&& other) noexcept -> BasicOpts& {
+  spec_ = std::move(other.spec_);
+  result_ = std::move(other.result_);
+  result_.spec_ = &spec_;
+  return *this;
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <class... N>
+FlagHandle BasicOpts<TChar, TPolicy, TPos>::add_bare(N&&... names) {
+  spec_.flags_.emplace_back(FlagClass::bare, std::forward<N>(names)...);
+  spec_.flag_type_tainted_ = true;
+  spec_.map_tainted_ = true;
+  return FlagHandle{spec_.flags_.size() - 1};
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <class... N>
+FlagHandle BasicOpts<TChar, TPolicy, TPos>::add_optional(N&&... names) {
+  spec_.flags_.emplace_back(FlagClass::optional, std::forward<N>(names)...);
+  spec_.flag_type_tainted_ = true;
+  spec_.map_tainted_ = true;
+  return FlagHandle{spec_.flags_.size() - 1};
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <class... N>
+FlagHandle BasicOpts<TChar, TPolicy, TPos>::add_mandatory(N&&... names) {
+  spec_.flags_.emplace_back(FlagClass::mandatory, std::forward<N>(names)...);
+  spec_.flag_type_tainted_ = true;
+  spec_.map_tainted_ = true;
+  return FlagHandle{spec_.flags_.size() - 1};
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <class... N>
+FlagHandle BasicOpts<TChar, TPolicy, TPos>::add_stop(N&&... names) {
+  spec_.flags_.emplace_back(FlagClass::stop, std::forward<N>(names)...);
+  spec_.flag_type_tainted_ = true;
+  spec_.map_tainted_ = true;
+  return FlagHandle{spec_.flags_.size() - 1};
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <class... N>
+  requires (sizeof...(N) > 0
+            && (std::convertible_to<const N&, std::basic_string_view<TChar>>
+                && ...))
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::try_add_bare(const N&... names)
+      -> std::optional<FlagHandle> {
+  if (!can_declare(names...)) {
+    return std::nullopt;
+  }
+  return add_bare(StringView{names}...);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <PosType C, class... N>
+  requires (sizeof...(N) > 0
+            && (std::convertible_to<const N&, std::basic_string_view<TChar>>
+                && ...))
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::try_add_bare(
+      const C max, const N&... names) -> std::optional<FlagHandle> {
+  if (!can_declare(names...)) {
+    return std::nullopt;
+  }
+  return add_bare(max, StringView{names}...);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <class... N>
+  requires (sizeof...(N) > 0
+            && (std::convertible_to<const N&, std::basic_string_view<TChar>>
+                && ...))
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::try_add_optional(const N&... names)
+      -> std::optional<FlagHandle> {
+  if (!can_declare(names...)) {
+    return std::nullopt;
+  }
+  return add_optional(StringView{names}...);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <PosType C, class... N>
+  requires (sizeof...(N) > 0
+            && (std::convertible_to<const N&, std::basic_string_view<TChar>>
+                && ...))
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::try_add_optional(
+      const C max, const N&... names) -> std::optional<FlagHandle> {
+  if (!can_declare(names...)) {
+    return std::nullopt;
+  }
+  return add_optional(max, StringView{names}...);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <class... N>
+  requires (sizeof...(N) > 0
+            && (std::convertible_to<const N&, std::basic_string_view<TChar>>
+                && ...))
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::try_add_mandatory(const N&... names)
+      -> std::optional<FlagHandle> {
+  if (!can_declare(names...)) {
+    return std::nullopt;
+  }
+  return add_mandatory(StringView{names}...);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <PosType C, class... N>
+  requires (sizeof...(N) > 0
+            && (std::convertible_to<const N&, std::basic_string_view<TChar>>
+                && ...))
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::try_add_mandatory(
+      const C max, const N&... names) -> std::optional<FlagHandle> {
+  if (!can_declare(names...)) {
+    return std::nullopt;
+  }
+  return add_mandatory(max, StringView{names}...);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <class... N>
+  requires (sizeof...(N) > 0
+            && (std::convertible_to<const N&, std::basic_string_view<TChar>>
+                && ...))
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::try_add_stop(const N&... names)
+      -> std::optional<FlagHandle> {
+  if (!can_declare(names...)) {
+    return std::nullopt;
+  }
+  return add_stop(StringView{names}...);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <PosType C, class... N>
+  requires (sizeof...(N) > 0
+            && (std::convertible_to<const N&, std::basic_string_view<TChar>>
+                && ...))
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::try_add_stop(
+      const C max, const N&... names) -> std::optional<FlagHandle> {
+  if (!can_declare(names...)) {
+    return std::nullopt;
+  }
+  return add_stop(max, StringView{names}...);
+}
+
+// whether flags named 'names' may be declared: none may be empty or already
+// declared, here or before
+template <typename TChar, typename TPolicy, typename TPos>
+template <class... N>
+[[nodiscard]] bool BasicOpts<TChar, TPolicy, TPos>::can_declare(const N&... names)
+      const {
+  const std::array<StringView, sizeof...(N)> views{StringView{names}...};
+  for (auto it = views.begin(); it != views.end(); ++it) {
+    if (it->empty() || std::find(views.begin(), it, *it) != it) {
+      return false;
+    }
+    for (const auto& flag: spec_.flags_) {
+      for (const auto& name: flag.names()) {
+        if (name.name() == *it) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicOpts<TChar, TPolicy, TPos>::allow_empty_arguments(const bool state) noexcept
+    requires (!TPolicy::empty_arguments.has_value()) {
+  spec_.allow_empty_arg_ = state;
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicOpts<TChar, TPolicy, TPos>::allow_empty_inputs(const bool state) noexcept
+    requires (!TPolicy::empty_inputs.has_value()) {
+  spec_.allow_empty_input_ = state;
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <PosType T>
+void BasicOpts<TChar, TPolicy, TPos>::allow_arguments(const T max) noexcept
+    requires (TPolicy::arguments.value_or(true)) {
+  spec_.collect_args_ = max < 0 ? 0 : max;
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicOpts<TChar, TPolicy, TPos>::allow_arguments() noexcept
+    requires (TPolicy::arguments.value_or(true)) {
+  spec_.collect_args_ = std::numeric_limits<CLType>::max();
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <PosType T>
+void BasicOpts<TChar, TPolicy, TPos>::allow_unrecognized_flags(
+      const T max, const Aggressive state) noexcept
+    requires (TPolicy::unrecognized_flags.value_or(true)) {
+  spec_.collect_unrecognized_flags_ = max < 0 ? 0 : max;
+  spec_.unrecognized_greedy_ = state == Aggressive::no ? false : true;
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicOpts<TChar, TPolicy, TPos>::allow_unrecognized_flags(
+      const Aggressive state) noexcept
+    requires (TPolicy::unrecognized_flags.value_or(true)) {
+  spec_.collect_unrecognized_flags_ = std::numeric_limits<CLType>::max();
+  spec_.unrecognized_greedy_ = state == Aggressive::no ? false : true;
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <PosType T>
+void BasicOpts<TChar, TPolicy, TPos>::allow_unrecognized_opts(const T max) noexcept
+    requires (TPolicy::unrecognized_flags.value_or(true)) {
+  allow_unrecognized_flags(max);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicOpts<TChar, TPolicy, TPos>::allow_unrecognized_opts() noexcept
+    requires (TPolicy::unrecognized_flags.value_or(true)) {
+  allow_unrecognized_flags();
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicOpts<TChar, TPolicy, TPos>::allow_chaining(const bool state) noexcept
+    requires (!TPolicy::chaining.has_value()) {
+  spec_.can_chain_ = state;
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicOpts<TChar, TPolicy, TPos>::set_chaining(const bool state) noexcept
+    requires (!TPolicy::chaining.has_value()) {
+  allow_chaining(state);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicOpts<TChar, TPolicy, TPos>::set_no_chaining() noexcept
+    requires (!TPolicy::chaining.has_value()) {
+  allow_chaining(false);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicOpts<TChar, TPolicy, TPos>::set_greedy(const bool state) noexcept
+    requires (!TPolicy::mandatory_greedy.has_value()) {
+  spec_.mandatory_greedy_ = state ? Greedy::yes : Greedy::no;
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicOpts<TChar, TPolicy, TPos>::set_not_greedy() noexcept
+    requires (!TPolicy::mandatory_greedy.has_value()) {
+  spec_.mandatory_greedy_ = Greedy::no;
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicOpts<TChar, TPolicy, TPos>::set_lax_greedy() noexcept
+    requires (!TPolicy::mandatory_greedy.has_value()) {
+  spec_.mandatory_greedy_ = Greedy::lax;
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicOpts<TChar, TPolicy, TPos>::set_greedy(const Greedy state) noexcept
+    requires (!TPolicy::mandatory_greedy.has_value()) {
+  spec_.mandatory_greedy_ = state;
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicOpts<TChar, TPolicy, TPos>::set_optional_greedy(const bool state) noexcept
+    requires (!TPolicy::optional_greedy.has_value()) {
+  spec_.optional_greedy_ = state;
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicOpts<TChar, TPolicy, TPos>::set_optional_not_greedy() noexcept
+    requires (!TPolicy::optional_greedy.has_value()) {
+  spec_.optional_greedy_ = false;
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <typename Str>
+void BasicOpts<TChar, TPolicy, TPos>::set_preamble(Str&& str) {
+  spec_.preamble_ = std::forward<Str>(str);
+  spec_.error_formats_tainted_ = true;
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <typename Str>
+void BasicOpts<TChar, TPolicy, TPos>::set_postscript(Str&& str) {
+  spec_.postscript_ = std::forward<Str>(str);
+  spec_.error_formats_tainted_ = true;
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <class... Chars, typename>
+void BasicOpts<TChar, TPolicy, TPos>::set_flag_marker(Chars... flag_markers) {
+  set_flag_markers(flag_markers...);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <class... Chars, typename>
+void BasicOpts<TChar, TPolicy, TPos>::set_flag_markers(Chars... flag_markers) {
+  spec_.flag_markers_.clear();
+  add_flag_markers(flag_markers...);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <class... Chars, typename>
+void BasicOpts<TChar, TPolicy, TPos>::add_flag_marker(Chars... flag_markers) {
+  add_flag_markers(flag_markers...);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <class... Chars, typename>
+void BasicOpts<TChar, TPolicy, TPos>::add_flag_markers(Chars... flag_markers) {
+  (spec_.flag_markers_.emplace(flag_markers), ...);
+  spec_.flag_type_tainted_ = true;
+  // the short name table is keyed on the flag markers
+  spec_.map_tainted_ = true;
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <class... Chars, typename>
+void BasicOpts<TChar, TPolicy, TPos>::set_opt_marker(Chars... flag_markers) {
+  set_flag_markers(flag_markers...);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <class... Chars, typename>
+void BasicOpts<TChar, TPolicy, TPos>::set_opt_markers(Chars... flag_markers) {
+  set_flag_markers(flag_markers...);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <class... Chars, typename>
+void BasicOpts<TChar, TPolicy, TPos>::add_opt_marker(Chars... flag_markers) {
+  add_flag_markers(flag_markers...);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <class... Chars, typename>
+void BasicOpts<TChar, TPolicy, TPos>::add_opt_markers(Chars... flag_markers) {
+  add_flag_markers(flag_markers...);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicOpts<TChar, TPolicy, TPos>::set_input_marker(const Char input_marker) noexcept {
+  spec_.input_marker_ = input_marker;
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicOpts<TChar, TPolicy, TPos>::allow_response_files(
+      const ResponseFiles state) noexcept {
+  spec_.response_files_ = state;
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicOpts<TChar, TPolicy, TPos>::clear() noexcept {
+  result_.clear();
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicOpts<TChar, TPolicy, TPos>::clear_errors() noexcept {
+  result_.clear_errors();
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicOpts<TChar, TPolicy, TPos>::reserve(const CLType args) {
+  spec_.freeze();
+  result_.bind(spec_);
+  result_.reserve(args);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicOpts<TChar, TPolicy, TPos>::keep_events(const bool keep) noexcept {
+  result_.keep_events(keep);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicOpts<TChar, TPolicy, TPos>::keep_events_only(const bool only)
+      noexcept {
+  result_.keep_events_only(only);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicOpts<TChar, TPolicy, TPos>::keep_argument_ranges(
+      const bool keep) noexcept {
+  result_.keep_argument_ranges(keep);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicOpts<TChar, TPolicy, TPos>::set_argument_callback(
+      ArgCallback callback) {
+  result_.set_argument_callback(std::move(callback));
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicOpts<TChar, TPolicy, TPos>::set_flag_callback(
+      const FlagHandle flag, InstanceCallback callback) {
+  result_.set_flag_callback(flag, std::move(callback));
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicOpts<TChar, TPolicy, TPos>::set_unrecognized_flag_callback(
+      ArgCallback callback) {
+  result_.set_unrecognized_flag_callback(std::move(callback));
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicOpts<TChar, TPolicy, TPos>::set_error_callback(
+      ErrorCallback callback) {
+  result_.set_error_callback(std::move(callback));
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicOpts<TChar, TPolicy, TPos>::clear_declarations() noexcept {
+  spec_.flags_.clear();
+  spec_.flag_type_tainted_ = true;
+  spec_.map_.clear();
+  spec_.map_tainted_ = true;
+  spec_.collect_unrecognized_flags_ = 0;
+  spec_.collect_args_ = 0;
+  apply_policy();
+  result_.clear();
+}
+
+// record the behaviour fixed by the policy in the spec as well, so that a
+// compiled spec parses alike without the policy
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicOpts<TChar, TPolicy, TPos>::apply_policy() noexcept {
+  if constexpr (TPolicy::chaining.has_value()) {
+    spec_.can_chain_ = *TPolicy::chaining;
+  }
+  if constexpr (TPolicy::mandatory_greedy.has_value()) {
+    spec_.mandatory_greedy_ = *TPolicy::mandatory_greedy;
+  }
+  if constexpr (TPolicy::optional_greedy.has_value()) {
+    spec_.optional_greedy_ = *TPolicy::optional_greedy;
+  }
+  if constexpr (TPolicy::empty_inputs.has_value()) {
+    spec_.allow_empty_input_ = *TPolicy::empty_inputs;
+  }
+  if constexpr (TPolicy::empty_arguments.has_value()) {
+    spec_.allow_empty_arg_ = *TPolicy::empty_arguments;
+  }
+  if constexpr (TPolicy::arguments.has_value()) {
+    spec_.collect_args_ = *TPolicy::arguments
+                            ? std::numeric_limits<CLType>::max() : 0;
+  }
+  if constexpr (TPolicy::unrecognized_flags.has_value()) {
+    spec_.collect_unrecognized_flags_ = *TPolicy::unrecognized_flags
+                                          ? std::numeric_limits<CLType>::max()
+                                          : 0;
+  }
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicOpts<TChar, TPolicy, TPos>::default_error_formats() noexcept {
+  spec_.custom_error_message_.clear();
+  spec_.error_formats_tainted_ = true;
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::compile() -> CompiledSpec {
+  spec_.freeze();
+  return spec_;
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::try_compile()
+      -> std::optional<CompiledSpec> {
+  if (spec_.names_conflict()) {
+    return std::nullopt;
+  }
+  return compile();
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::result() const noexcept
+      -> const ParseResult& {
+  return result_;
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::result() noexcept -> ParseResult& {
+  return result_;
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_all_errors() const noexcept
+      -> const Errors& {
+  return result_.get_all_errors();
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_all_errors() noexcept -> Errors& {
+  return result_.get_all_errors();
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_map() -> const Map& {
+  spec_.freeze();
+  return spec_.get_map();
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] bool BasicOpts<TChar, TPolicy, TPos>::have_opt(const StringView name) const {
+  return result_.have_opt(name);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] bool BasicOpts<TChar, TPolicy, TPos>::has_opt(const StringView name) const {
+  return result_.has_opt(name);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] bool BasicOpts<TChar, TPolicy, TPos>::have_flag(const StringView name) const {
+  return result_.have_flag(name);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] bool BasicOpts<TChar, TPolicy, TPos>::has_flag(const StringView name) const {
+  return result_.has_flag(name);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_all_instances(const StringView name)
+      -> Instances& {
+  return result_.get_all_instances(name);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_all_instances(
+      const StringView name) const -> const Instances& {
+  return result_.get_all_instances(name);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] bool BasicOpts<TChar, TPolicy, TPos>::has_input(
+      const StringView name, const InstancePos pos) const {
+  return result_.has_input(name, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] bool BasicOpts<TChar, TPolicy, TPos>::has_input(
+      const Instance& instance) const noexcept {
+  return result_.has_input(instance);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_input(
+      const StringView name, const InstancePos pos) const -> InputResult {
+  return result_.get_input(name, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_input(
+      const Instance& instance) const noexcept -> InputResult {
+  return result_.get_input(instance);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] bool BasicOpts<TChar, TPolicy, TPos>::is_input_internal(
+      const StringView name, const InstancePos pos) const {
+  return result_.is_input_internal(name, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] bool BasicOpts<TChar, TPolicy, TPos>::is_input_internal(
+      const Instance& instance) const noexcept {
+  return result_.is_input_internal(instance);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] bool BasicOpts<TChar, TPolicy, TPos>::is_input_external(
+      const StringView name, const InstancePos pos) const {
+  return result_.is_input_external(name, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] bool BasicOpts<TChar, TPolicy, TPos>::is_input_external(
+      const Instance& instance) const noexcept {
+  return result_.is_input_external(instance);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_name(
+      const StringView name, const InstancePos pos) const -> StringView {
+  return result_.get_name(name, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_name(
+      const Instance& instance) const noexcept -> StringView {
+  return result_.get_name(instance);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_opt_name(
+      const StringView name, const InstancePos pos) const -> StringView {
+  return result_.get_opt_name(name, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_opt_name(
+      const Instance& instance) const noexcept -> StringView {
+  return result_.get_opt_name(instance);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_flag_name(
+      const StringView name, const InstancePos pos) const -> StringView {
+  return result_.get_flag_name(name, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_flag_name(
+      const Instance& instance) const noexcept -> StringView {
+  return result_.get_flag_name(instance);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] CLType BasicOpts<TChar, TPolicy, TPos>::get_pos(
+      const StringView name, const InstancePos pos) const {
+  return result_.get_pos(name, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] CLType BasicOpts<TChar, TPolicy, TPos>::get_pos(
+      const Instance& instance) const noexcept {
+  return result_.get_pos(instance);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] CLType BasicOpts<TChar, TPolicy, TPos>::get_subpos(
+      const StringView name, const InstancePos pos) const {
+  return result_.get_subpos(name, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] CLType BasicOpts<TChar, TPolicy, TPos>::get_subpos(
+      const Instance& instance) const noexcept {
+  return result_.get_subpos(instance);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] bool BasicOpts<TChar, TPolicy, TPos>::have_opt(
+      const FlagHandle flag) const {
+  return result_.have_opt(flag);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] bool BasicOpts<TChar, TPolicy, TPos>::has_opt(
+      const FlagHandle flag) const {
+  return result_.has_opt(flag);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] bool BasicOpts<TChar, TPolicy, TPos>::have_flag(
+      const FlagHandle flag) const {
+  return result_.have_flag(flag);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] bool BasicOpts<TChar, TPolicy, TPos>::has_flag(
+      const FlagHandle flag) const {
+  return result_.has_flag(flag);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_all_instances(
+      const FlagHandle flag) -> Instances& {
+  return result_.get_all_instances(flag);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_all_instances(
+      const FlagHandle flag) const -> const Instances& {
+  return result_.get_all_instances(flag);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] bool BasicOpts<TChar, TPolicy, TPos>::has_input(
+      const FlagHandle flag, const InstancePos pos) const {
+  return result_.has_input(flag, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_input(
+      const FlagHandle flag, const InstancePos pos) const -> InputResult {
+  return result_.get_input(flag, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] bool BasicOpts<TChar, TPolicy, TPos>::is_input_internal(
+      const FlagHandle flag, const InstancePos pos) const {
+  return result_.is_input_internal(flag, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] bool BasicOpts<TChar, TPolicy, TPos>::is_input_external(
+      const FlagHandle flag, const InstancePos pos) const {
+  return result_.is_input_external(flag, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_name(
+      const FlagHandle flag, const InstancePos pos) const -> StringView {
+  return result_.get_name(flag, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_opt_name(
+      const FlagHandle flag, const InstancePos pos) const -> StringView {
+  return result_.get_opt_name(flag, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_flag_name(
+      const FlagHandle flag, const InstancePos pos) const -> StringView {
+  return result_.get_flag_name(flag, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] CLType BasicOpts<TChar, TPolicy, TPos>::get_pos(
+      const FlagHandle flag, const InstancePos pos) const {
+  return result_.get_pos(flag, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] CLType BasicOpts<TChar, TPolicy, TPos>::get_subpos(
+      const FlagHandle flag, const InstancePos pos) const {
+  return result_.get_subpos(flag, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_all_unrecognized_flags() noexcept
+      -> Unrecognized& {
+  return result_.get_all_unrecognized_flags();
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_all_unrecognized_flags() const noexcept
+      -> const Unrecognized& {
+  return result_.get_all_unrecognized_flags();
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_all_unrecognized_opts() noexcept
+      -> Unrecognized& {
+  return result_.get_all_unrecognized_opts();
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_all_unrecognized_opts() const noexcept
+      -> const Unrecognized& {
+  return result_.get_all_unrecognized_opts();
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_unrecognized_flag(
+      const UnrecognizedPos pos) -> UnrecognizedFlag& {
+  return result_.get_unrecognized_flag(pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_unrecognized_flag(
+      const UnrecognizedPos pos) const -> const UnrecognizedFlag& {
+  return result_.get_unrecognized_flag(pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_unrecognized_opt(
+      const UnrecognizedPos pos) -> UnrecognizedFlag& {
+  return result_.get_unrecognized_opt(pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_unrecognized_opt(
+      const UnrecognizedPos pos) const -> const UnrecognizedFlag& {
+  return result_.get_unrecognized_opt(pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_all_arguments() noexcept -> Args& {
+  return result_.get_all_arguments();
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_all_arguments() const noexcept
+      -> const Args& {
+  return result_.get_all_arguments();
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_argument(const ArgPos pos) -> Arg& {
+  return result_.get_argument(pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_argument(const ArgPos pos) const
+      -> const Arg& {
+  return result_.get_argument(pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_argument_ranges()
+      const noexcept -> const ArgRanges& {
+  return result_.get_argument_ranges();
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_tail() const noexcept
+      -> const ArgRange& {
+  return result_.get_tail();
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_source(
+      const CLType pos) const -> Source {
+  return result_.get_source(pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::try_have_opt(
+      const StringView name) const noexcept -> std::optional<bool> {
+  return result_.try_have_opt(name);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::try_get_all_instances(
+      const StringView name) const noexcept -> const Instances* {
+  return result_.try_get_all_instances(name);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::try_has_input(
+      const StringView name, const InstancePos pos) const noexcept
+      -> std::optional<bool> {
+  return result_.try_has_input(name, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::try_get_input(
+      const StringView name, const InstancePos pos) const noexcept
+      -> std::optional<InputResult> {
+  return result_.try_get_input(name, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::try_is_input_internal(
+      const StringView name, const InstancePos pos) const noexcept
+      -> std::optional<bool> {
+  return result_.try_is_input_internal(name, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::try_is_input_external(
+      const StringView name, const InstancePos pos) const noexcept
+      -> std::optional<bool> {
+  return result_.try_is_input_external(name, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::try_get_name(
+      const StringView name, const InstancePos pos) const noexcept
+      -> std::optional<StringView> {
+  return result_.try_get_name(name, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::try_get_pos(
+      const StringView name, const InstancePos pos) const noexcept
+      -> std::optional<CLType> {
+  return result_.try_get_pos(name, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::try_get_subpos(
+      const StringView name, const InstancePos pos) const noexcept
+      -> std::optional<CLType> {
+  return result_.try_get_subpos(name, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::try_have_opt(
+      const FlagHandle flag) const noexcept -> std::optional<bool> {
+  return result_.try_have_opt(flag);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::try_get_all_instances(
+      const FlagHandle flag) const noexcept -> const Instances* {
+  return result_.try_get_all_instances(flag);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::try_has_input(
+      const FlagHandle flag, const InstancePos pos) const noexcept
+      -> std::optional<bool> {
+  return result_.try_has_input(flag, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::try_get_input(
+      const FlagHandle flag, const InstancePos pos) const noexcept
+      -> std::optional<InputResult> {
+  return result_.try_get_input(flag, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::try_is_input_internal(
+      const FlagHandle flag, const InstancePos pos) const noexcept
+      -> std::optional<bool> {
+  return result_.try_is_input_internal(flag, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::try_is_input_external(
+      const FlagHandle flag, const InstancePos pos) const noexcept
+      -> std::optional<bool> {
+  return result_.try_is_input_external(flag, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::try_get_name(
+      const FlagHandle flag, const InstancePos pos) const noexcept
+      -> std::optional<StringView> {
+  return result_.try_get_name(flag, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::try_get_pos(
+      const FlagHandle flag, const InstancePos pos) const noexcept
+      -> std::optional<CLType> {
+  return result_.try_get_pos(flag, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::try_get_subpos(
+      const FlagHandle flag, const InstancePos pos) const noexcept
+      -> std::optional<CLType> {
+  return result_.try_get_subpos(flag, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::try_get_unrecognized_flag(
+      const UnrecognizedPos pos) const noexcept -> const UnrecognizedFlag* {
+  return result_.try_get_unrecognized_flag(pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::try_get_argument(
+      const ArgPos pos) const noexcept -> const Arg* {
+  return result_.try_get_argument(pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_preamble() const -> StringView {
+  return spec_.get_preamble();
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::get_postscript() const -> StringView {
+  return spec_.get_postscript();
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <typename T>
+bool BasicOpts<TChar, TPolicy, TPos>::parse(T&& args) {
+  spec_.freeze();
+  return spec_.template parse<TPolicy>(result_, std::forward<T>(args));
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <PosType T>
+bool BasicOpts<TChar, TPolicy, TPos>::parse(T argc, Char** argv, T start_at) {
+  spec_.freeze();
+  return spec_.template parse<TPolicy>(result_, argc, argv, start_at);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <typename T, PosType U>
+bool BasicOpts<TChar, TPolicy, TPos>::parse(T&& argv, U start_at) {
+  spec_.freeze();
+  return spec_.template parse<TPolicy>(result_, std::forward<T>(argv),
+                                       start_at);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <class... T, typename>
+bool BasicOpts<TChar, TPolicy, TPos>::parse(T&&... args) {
+  spec_.freeze();
+  return spec_.template parse<TPolicy>(result_, std::forward<T>(args)...);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+bool BasicOpts<TChar, TPolicy, TPos>::parse() {
+  spec_.freeze();
+  return spec_.parse(result_);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+bool BasicOpts<TChar, TPolicy, TPos>::parse_command_line(
+      const StringView line) {
+  spec_.freeze();
+  return spec_.template parse_command_line<TPolicy>(result_, line);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+bool BasicOpts<TChar, TPolicy, TPos>::parse_nul_separated(
+      std::span<const Char> buf, const CLType start_at) {
+  spec_.freeze();
+  return spec_.template parse_nul_separated<TPolicy>(result_, buf, start_at);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::stream() -> ParseStream {
+  spec_.freeze();
+  return ParseStream{spec_, result_};
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <PosType T>
+bool BasicOpts<TChar, TPolicy, TPos>::parse_parallel(
+      T argc, Char** argv, T start_at, unsigned int threads) {
+  spec_.freeze();
+  return spec_.template parse_parallel<TPolicy>(result_, argc, argv, start_at,
+                                                threads);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <typename Str>
+void BasicOpts<TChar, TPolicy, TPos>::format_error(const ErrorKey key, Str&& str) {
+  spec_.custom_error_message_[key] = std::forward<Str>(str);
+  spec_.error_formats_tainted_ = true;
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <typename T>
+T& BasicOpts<TChar, TPolicy, TPos>::write_errors(T& out) {
+  return result_.write_errors(out);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <std::output_iterator<const TChar&> Out>
+Out BasicOpts<TChar, TPolicy, TPos>::write_errors_to(Out out, const ErrorKeySet keys) const {
+  return result_.write_errors_to(out, keys);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <typename Sink>
+  requires std::invocable<Sink&, const TChar*, std::size_t>
+void BasicOpts<TChar, TPolicy, TPos>::write_errors_to_sink(
+      Sink&& sink, const ErrorKeySet keys) const {
+  result_.write_errors_to_sink(std::forward<Sink>(sink), keys);
+}
+
+#ifdef DEFPROB_CLUTILS_HAVE_UNISTD
+template <typename TChar, typename TPolicy, typename TPos>
+void BasicOpts<TChar, TPolicy, TPos>::write_errors_to_fd(
+      const int fd, const ErrorKeySet keys) const
+    requires (sizeof(TChar) == 1) {
+  result_.write_errors_to_fd(fd, keys);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] int BasicOpts<TChar, TPolicy, TPos>::try_write_errors_to_fd(
+      const int fd, const ErrorKeySet keys) const
+    requires (sizeof(TChar) == 1) {
+  return result_.try_write_errors_to_fd(fd, keys);
+}
+#endif
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <typename T, typename U>
+T& BasicOpts<TChar, TPolicy, TPos>::write_error(T& out, const U pos) {
+  return result_.write_error(out, pos);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+template <typename T, class... U>
+T& BasicOpts<TChar, TPolicy, TPos>::write_errors_with(T& out, const U... keys) {
+  return result_.write_errors_with(out, keys...);
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::registered_flags() const -> CanonNames {
+  return spec_.registered_flags();
+}
+
+template <typename TChar, typename TPolicy, typename TPos>
+[[nodiscard]] auto BasicOpts<TChar, TPolicy, TPos>::registered_opts() const -> CanonNames {
+  return spec_.registered_opts();
+}
+
+
+
+// BasicFixedString
+
+template <typename TChar, std::size_t N>
+constexpr BasicFixedString<TChar, N>::BasicFixedString(
+      const Char (&str)[N]) noexcept {
+  std::copy_n(str, N, data);
+}
+
+template <typename TChar, std::size_t N>
+[[nodiscard]] constexpr auto BasicFixedString<TChar, N>::view() const noexcept
+      -> StringView {
+  return StringView{data, N - 1};
+}
+
+
+
+// Static::Flag
+
+template <FlagClass Class, CLType Max, BasicFixedString... Names>
+[[nodiscard]] constexpr bool Static::Flag<Class, Max, Names...>::has_name(
+      const StringView name) noexcept {
+  return std::ranges::find(names, name) != names.end();
+}
+
+
+
+// StaticOpts
+
+template <typename... Flags>
+StaticOpts<Flags...>::StaticOpts()
+  : StaticOpts{[](Opts&) {}}
+{}
+
+template <typename... Flags>
+template <typename F>
+  requires std::invocable<F&, BasicOpts<typename StaticOpts<Flags...>::Char>&>
+StaticOpts<Flags...>::StaticOpts(F&& configure)
+  : spec_{declare(configure)}, result_{spec_}
+{}
+
+template <typename... Flags>
+StaticOpts<Flags...>::StaticOpts(const StaticOpts& other)
+  : spec_{other.spec_}, result_{other.result_}
+{
+  result_.spec_ = &spec_;
+}
+
+template <typename... Flags>
+StaticOpts<Flags...>::StaticOpts(StaticOpts&& other) noexcept
+  : spec_{std::move(other.spec_)}, result_{std::move(other.result_)}
+{
+  result_.spec_ = &spec_;
+}
+
+template <typename... Flags>
+auto StaticOpts<Flags...>::operator=(const StaticOpts& other) -> StaticOpts& {
+  if (this != &other) {
+    spec_ = other.spec_;
+    result_ = other.result_;
+    result_.spec_ = &spec_;
+  }
+  return *this;
+}
+
+template <typename... Flags>
+auto StaticOpts<Flags...>::operator=(StaticOpts&& other) noexcept
+      -> StaticOpts& {
+  spec_ = std::move(other.spec_);
+  result_ = std::move(other.result_);
+  result_.spec_ = &spec_;
+  return *this;
+}
+
+template <typename... Flags>
+[[nodiscard]] consteval bool StaticOpts<Flags...>::names_nonempty() noexcept {
+  bool nonempty = true;
+  ((nonempty = nonempty && std::ranges::none_of(Flags::names,
+      [](const StringView name) { return name.empty(); })), ...);
+  return nonempty;
+}
+
+// every name is compared against the names of its own flag and of the flags
+// declared after it
+template <typename... Flags>
+[[nodiscard]] consteval bool StaticOpts<Flags...>::names_unique() noexcept {
+  constexpr std::size_t count = (Flags::names.size() + ...);
+  std::array<StringView, count> names{};
+  auto it = names.begin();
+  ((it = std::ranges::copy(Flags::names, it).out), ...);
+  for (auto i = names.begin(); i != names.end(); ++i) {
+    if (std::find(i + 1, names.end(), *i) != names.end()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename... Flags>
+template <BasicFixedString Name>
+[[nodiscard]] consteval auto StaticOpts<Flags...>::flag_pos() noexcept
+      -> FlagPos {
+  static_assert(
+      std::is_same_v<typename std::remove_cvref_t<decltype(Name)>::Char, Char>,
+      "the flag name must have the character type of the declarations");
+  constexpr std::array<bool, flag_count> matches{
+      Flags::has_name(Name.view())...};
+  constexpr FlagPos pos = std::ranges::find(matches, true) - matches.begin();
+  static_assert(pos < flag_count, "no flag is declared with this name");
+  return pos;
+}
+
+template <typename... Flags>
+template <typename F>
+[[nodiscard]] auto StaticOpts<Flags...>::declare(F& configure)
+      -> CompiledSpec {
+  static constexpr auto names = name_table();
+  Opts opts;
+  (declare_flag<Flags>(opts), ...);
+  configure(opts);
+  // the table only knows the flags declared here, which 'configure' may
+  // have added to or cleared
+  const auto& flags = opts.spec_.flags_;
+  if (flags.size() == flag_count
+        && std::ranges::all_of(names, [&flags](const StaticName& entry) {
+             const auto& declared = flags[entry.flag].names();
+             return entry.index < declared.size()
+                      && declared[entry.index].name() == entry.name;
+           })) {
+    opts.spec_.static_names_ = names;
+  }
+  return opts.compile();
+}
+
+// every name with the positions of its flag and of itself in the flag,
+// sorted by name for the walks of BasicCompiledSpec
+template <typename... Flags>
+[[nodiscard]] consteval auto StaticOpts<Flags...>::name_table() noexcept
+      -> std::array<StaticName, name_count> {
+  std::array<StaticName, name_count> names{};
+  auto it = names.begin();
+  FlagPos flag = 0;
+  ((std::ranges::for_each(Flags::names, [&, index = std::size_t{0}](
+        const StringView name) mutable {
+      *it++ = StaticName{name, flag, index++};
+    }), ++flag), ...);
+  std::ranges::sort(names, {}, &StaticName::name);
+  return names;
+}
+
+// the names are views of the template arguments, which have static storage
+// duration, so they are never copied
+template <typename... Flags>
+template <typename Flag>
+void StaticOpts<Flags...>::declare_flag(Opts& opts) {
+  std::apply([&opts](const auto... names) {
+    if constexpr (Flag::flag_class == FlagClass::bare) {
+      opts.add_bare(Flag::max, names...);
+    }
+    else if constexpr (Flag::flag_class == FlagClass::optional) {
+      opts.add_optional(Flag::max, names...);
+    }
+    else if constexpr (Flag::flag_class == FlagClass::mandatory) {
+      opts.add_mandatory(Flag::max, names...);
+    }
+    else {
+      opts.add_stop(Flag::max, names...);
+    }
+  }, Flag::names);
+}
+
+template <typename... Flags>
+template <BasicFixedString Name>
+[[nodiscard]] auto StaticOpts<Flags...>::instance(const InstancePos pos) const
+      -> Instance {
+  return result_.instance_at(flag_pos<Name>(), pos);
+}
+
+template <typename... Flags>
+[[nodiscard]] auto StaticOpts<Flags...>::spec() const noexcept
+      -> const CompiledSpec& {
+  return spec_;
+}
+
+template <typename... Flags>
+[[nodiscard]] auto StaticOpts<Flags...>::result() const noexcept
+      -> const ParseResult& {
+  return result_;
+}
+
+template <typename... Flags>
+[[nodiscard]] auto StaticOpts<Flags...>::result() noexcept -> ParseResult& {
+  return result_;
+}
+
+template <typename... Flags>
+template <class... T>
+bool StaticOpts<Flags...>::parse(T&&... args) {
+  return spec_.parse(result_, std::forward<T>(args)...);
+}
+
+template <typename... Flags>
+template <BasicFixedString Name>
+[[nodiscard]] bool StaticOpts<Flags...>::have_opt() const {
+  return result_.kept_count(flag_pos<Name>()) > 0;
+}
+
+template <typename... Flags>
+template <BasicFixedString Name>
+[[nodiscard]] auto StaticOpts<Flags...>::get_all_instances() const
+      -> const Instances& {
+  return result_.flag_instances(flag_pos<Name>());
+}
+
+template <typename... Flags>
+template <BasicFixedString Name>
+[[nodiscard]] bool StaticOpts<Flags...>::has_input(
+      const InstancePos pos) const {
+  return result_.has_input(instance<Name>(pos));
+}
+
+template <typename... Flags>
+template <BasicFixedString Name>
+[[nodiscard]] auto StaticOpts<Flags...>::get_input(
+      const InstancePos pos) const -> InputResult {
+  return result_.get_input(instance<Name>(pos));
+}
+
+template <typename... Flags>
+template <BasicFixedString Name>
+[[nodiscard]] bool StaticOpts<Flags...>::is_input_internal(
+      const InstancePos pos) const {
+  return result_.is_input_internal(instance<Name>(pos));
+}
+
+template <typename... Flags>
+template <BasicFixedString Name>
+[[nodiscard]] bool StaticOpts<Flags...>::is_input_external(
+      const InstancePos pos) const {
+  return result_.is_input_external(instance<Name>(pos));
+}
+
+template <typename... Flags>
+template <BasicFixedString Name>
+[[nodiscard]] auto StaticOpts<Flags...>::get_name(
+      const InstancePos pos) const -> StringView {
+  return result_.get_name(instance<Name>(pos));
+}
+
+template <typename... Flags>
+template <BasicFixedString Name>
+[[nodiscard]] CLType StaticOpts<Flags...>::get_pos(
+      const InstancePos pos) const {
+  return result_.get_pos(instance<Name>(pos));
+}
+
+template <typename... Flags>
+template <BasicFixedString Name>
+[[nodiscard]] CLType StaticOpts<Flags...>::get_subpos(
+      const InstancePos pos) const {
+  return result_.get_subpos(instance<Name>(pos));
+}
+
+
 } // namespace CLUtils
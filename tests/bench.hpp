@@ -0,0 +1,232 @@
+// Helpers shared by the benchmark programs (bench_*.cpp). Each measurement is
+// written to stdout as a single line of space-separated key=value pairs so
+// that the output can be diffed or parsed between releases, e.g.:
+//
+//   bench=flags flags=1000 args=64 iters=2048 ns_per_arg=21.4 allocs_per_call=0
+//
+// Every benchmark program includes this header in its only translation unit,
+// which also replaces the global operator new and delete to count heap
+// allocations and the bytes held at any one time.
+//
+
+#ifndef DEFPROB_CLUTILS_BENCH_HPP
+#define DEFPROB_CLUTILS_BENCH_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+namespace detail {
+inline std::atomic<unsigned long long> allocations{0};
+inline std::atomic<long long> live_bytes{0};
+
+// each allocation is preceded by a header holding its size
+constexpr std::size_t header = alignof(std::max_align_t);
+}
+
+// the number of heap allocations made so far
+inline unsigned long long allocations() {
+	return detail::allocations.load(std::memory_order_relaxed);
+}
+
+// the number of bytes currently allocated on the heap
+inline long long live_bytes() {
+	return detail::live_bytes.load(std::memory_order_relaxed);
+}
+
+// prevent the compiler from optimizing away a result
+template <typename T>
+inline void keep(const T& val) {
+	asm volatile("" : : "r,m"(val) : "memory");
+}
+
+// run 'f' repeatedly for at least 'min_time' and return the mean time for a
+// single call in nanoseconds, and the mean number of allocations per call in
+// 'allocs'
+template <typename F>
+double time_ns(F&& f, unsigned long long& iters, double& allocs,
+               const std::chrono::milliseconds min_time
+                 = std::chrono::milliseconds{200}) {
+	using clock = std::chrono::steady_clock;
+
+	// warm up (and fill any lazily built state)
+	f();
+
+	iters = 0;
+	unsigned long long batch = 1;
+	const auto allocs_before = allocations();
+	const auto start = clock::now();
+	auto now = start;
+	while (now - start < min_time) {
+		for (unsigned long long i = 0; i < batch; ++i) {
+			f();
+		}
+		iters += batch;
+		batch *= 2;
+		now = clock::now();
+	}
+	const std::chrono::duration<double, std::nano> elapsed = now - start;
+	allocs = static_cast<double>(allocations() - allocs_before)
+	           / static_cast<double>(iters);
+	return elapsed.count() / static_cast<double>(iters);
+}
+
+// the number of heap bytes that are still held once 'f' has returned the
+// object it creates, e.g., a parse result
+template <typename F>
+long long retained_bytes(F&& f) {
+	const auto before = live_bytes();
+	const auto held = f();
+	const auto after = live_bytes();
+	keep(held);
+	return after - before;
+}
+
+// argv storage that owns its strings but can be handed to parse() as
+// (argc, argv)
+template <typename Char = char>
+struct BasicArgv {
+	std::vector<std::basic_string<Char>> strs;
+	std::vector<Char*> ptrs;
+
+	void push(const std::string& s) {
+		strs.emplace_back(s.begin(), s.end());
+	}
+
+	Char** data() {
+		ptrs.clear();
+		for (auto& s: strs) {
+			ptrs.push_back(s.data());
+		}
+		return ptrs.data();
+	}
+
+	int size() const {
+		return static_cast<int>(strs.size());
+	}
+};
+
+using Argv = BasicArgv<char>;
+
+// report a measurement of 'ns' and 'allocs' per call, normalized to 'per'
+// units (args, chained characters, etc.) per call, and the bytes retained by
+// the result of a call (if known)
+inline void report(const std::string& name, const std::string& params,
+                   const unsigned long long iters, const double ns,
+                   const unsigned long long per, const std::string& unit,
+                   const double allocs, const long long retained = -1) {
+	std::cout << "bench=" << name << " " << params << " iters=" << iters
+	          << " ns_per_" << unit << "="
+	          << ns / static_cast<double>(per ? per : 1)
+	          << " allocs_per_call=" << allocs;
+	if (retained >= 0) {
+		std::cout << " bytes_retained=" << retained;
+	}
+	std::cout << std::endl;
+}
+
+// time 'f' and report it as above
+template <typename F>
+void run(const std::string& name, const std::string& params,
+         const unsigned long long per, const std::string& unit, F&& f,
+         const long long retained = -1) {
+	unsigned long long iters = 0;
+	double allocs = 0;
+	const double ns = time_ns(std::forward<F>(f), iters, allocs);
+	report(name, params, iters, ns, per, unit, allocs, retained);
+}
+
+} // namespace bench
+
+
+// counting replacements of the global allocation functions, including the
+// aligned forms that std::pmr::new_delete_resource() allocates through
+
+namespace bench::detail {
+
+inline void* allocate(const std::size_t size, const std::size_t align) {
+	const auto offset = std::max(header, align);
+	auto* p = static_cast<unsigned char*>(std::aligned_alloc(align,
+	            (size + offset + align - 1) / align * align));
+	if (p == nullptr) {
+		throw std::bad_alloc{};
+	}
+	*reinterpret_cast<std::size_t*>(p + offset - header) = size;
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	live_bytes.fetch_add(static_cast<long long>(size),
+	                     std::memory_order_relaxed);
+	return p + offset;
+}
+
+inline void deallocate(void* ptr, const std::size_t align) noexcept {
+	if (ptr == nullptr) {
+		return;
+	}
+	const auto offset = std::max(header, align);
+	auto* p = static_cast<unsigned char*>(ptr) - offset;
+	live_bytes.fetch_sub(static_cast<long long>(
+	    *reinterpret_cast<std::size_t*>(p + offset - header)),
+	    std::memory_order_relaxed);
+	std::free(p);
+}
+
+} // namespace bench::detail
+
+void* operator new(std::size_t size) {
+	return bench::detail::allocate(size, bench::detail::header);
+}
+
+void* operator new[](std::size_t size) {
+	return bench::detail::allocate(size, bench::detail::header);
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+	return bench::detail::allocate(size, static_cast<std::size_t>(align));
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+	return bench::detail::allocate(size, static_cast<std::size_t>(align));
+}
+
+void operator delete(void* ptr) noexcept {
+	bench::detail::deallocate(ptr, bench::detail::header);
+}
+
+void operator delete[](void* ptr) noexcept {
+	bench::detail::deallocate(ptr, bench::detail::header);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+	bench::detail::deallocate(ptr, bench::detail::header);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+	bench::detail::deallocate(ptr, bench::detail::header);
+}
+
+void operator delete(void* ptr, std::align_val_t align) noexcept {
+	bench::detail::deallocate(ptr, static_cast<std::size_t>(align));
+}
+
+void operator delete[](void* ptr, std::align_val_t align) noexcept {
+	bench::detail::deallocate(ptr, static_cast<std::size_t>(align));
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t align) noexcept {
+	bench::detail::deallocate(ptr, static_cast<std::size_t>(align));
+}
+
+void operator delete[](void* ptr, std::size_t,
+                       std::align_val_t align) noexcept {
+	bench::detail::deallocate(ptr, static_cast<std::size_t>(align));
+}
+
+#endif // DEFPROB_CLUTILS_BENCH_HPP
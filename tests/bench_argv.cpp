@@ -0,0 +1,211 @@
+#include <string>
+#include <clutils.hpp>
+#include "bench.hpp"
+
+// parse cost as the argv grows, against a fixed spec: a mix of long flags
+// with inputs, chained short flags, mandatory flags taking the next opt as
+// their input and arguments. The time per arg should stay flat. The same
+// argvs are also parsed with all of the parsing behaviour fixed at compile
+// time (argv_fixed), with the event log kept as well (argv_events) or as
+// the only store (argv_events_only), into a result of 32-bit positions
+// (argv_pos32) and in chunks on as many threads
+// as there are cores (argv_parallel; the same as argv on a single core),
+// and as a single command line with the arguments quoted (command_line).
+// Last, an argv of nothing but arguments (e.g. the file names given to a
+// tool) is parsed into results of both position types (files, files_pos32)
+// and as argument ranges (files_ranges). Then the same file names are given
+// after a stop flag, as xargs would, and parsed as usual (tail) and as
+// argument ranges, where they are taken without being parsed (tail_ranges).
+
+// parse 'argv' into a result of 32-bit positions
+void run_pos32(const std::string& name, const CLUtils::CompiledSpec& spec,
+               bench::Argv& argv) {
+	using Result32 = CLUtils::BasicParseResult<char, std::uint32_t>;
+	char** av = argv.data();
+	const int ac = argv.size();
+	const auto retained = bench::retained_bytes([&] {
+		Result32 res;
+		spec.parse(res, ac, av);
+		return res;
+	});
+	Result32 res;
+	bench::run(name, "args=" + std::to_string(ac - 1), ac - 1, "arg", [&] {
+		bench::keep(spec.parse(res, ac, av));
+	}, retained);
+}
+
+// parse 'argv' into a result that keeps its arguments as ranges
+void run_ranges(const std::string& name, const CLUtils::CompiledSpec& spec,
+                bench::Argv& argv) {
+	char** av = argv.data();
+	const int ac = argv.size();
+	const auto retained = bench::retained_bytes([&] {
+		CLUtils::ParseResult res;
+		res.keep_argument_ranges();
+		spec.parse(res, ac, av);
+		return res;
+	});
+	CLUtils::ParseResult res;
+	res.keep_argument_ranges();
+	bench::run(name, "args=" + std::to_string(ac - 1), ac - 1, "arg", [&] {
+		bench::keep(spec.parse(res, ac, av));
+	}, retained);
+}
+
+int main() {
+	CLUtils::Opts cl;
+	cl.add_bare("-a", "--all");
+	cl.add_bare("-b", "--brief");
+	cl.add_optional("-o", "--output");
+	cl.add_mandatory("-x", "--exclude");
+	cl.add_stop("--");
+	cl.allow_arguments();
+	const auto spec = cl.compile();
+
+	// the behaviour of 'cl' above, as a policy
+	using Fixed = CLUtils::FixedPolicy<true, CLUtils::Greedy::no, false, false,
+		false, true, false>;
+
+	for (const int nargs: {10, 100, 1000, 10000, 100000, 1000000}) {
+		bench::Argv argv;
+		argv.push("bench_argv");
+		for (int i = 0; argv.size() < nargs + 1; ++i) {
+			switch (i % 5) {
+			case 0:
+				argv.push("--output=file-" + std::to_string(i));
+				break;
+			case 1:
+				argv.push("-ab");
+				break;
+			case 2:
+				argv.push("-x");
+				argv.push("pattern");
+				break;
+			case 3:
+				argv.push("--all");
+				break;
+			default:
+				argv.push("argument-" + std::to_string(i));
+				break;
+			}
+		}
+
+		char** av = argv.data();
+		const int ac = argv.size();
+		const auto retained = bench::retained_bytes([&] {
+			CLUtils::ParseResult res;
+			spec.parse(res, ac, av);
+			return res;
+		});
+
+		CLUtils::ParseResult res;
+		bench::run("argv", "args=" + std::to_string(ac - 1), ac - 1, "arg",
+		           [&] {
+			bench::keep(spec.parse(res, ac, av));
+		}, retained);
+		bench::run("argv_fixed", "args=" + std::to_string(ac - 1), ac - 1,
+		           "arg", [&] {
+			bench::keep(spec.parse<Fixed>(res, ac, av));
+		}, retained);
+
+		const auto retained_events = bench::retained_bytes([&] {
+			CLUtils::ParseResult events;
+			events.keep_events();
+			spec.parse(events, ac, av);
+			return events;
+		});
+		CLUtils::ParseResult events;
+		events.keep_events();
+		bench::run("argv_events", "args=" + std::to_string(ac - 1), ac - 1,
+		           "arg", [&] {
+			bench::keep(spec.parse(events, ac, av));
+		}, retained_events);
+
+		const auto retained_only = bench::retained_bytes([&] {
+			CLUtils::ParseResult only;
+			only.keep_events_only();
+			spec.parse(only, ac, av);
+			return only;
+		});
+		CLUtils::ParseResult only;
+		only.keep_events_only();
+		bench::run("argv_events_only", "args=" + std::to_string(ac - 1),
+		           ac - 1, "arg", [&] {
+			bench::keep(spec.parse(only, ac, av));
+		}, retained_only);
+
+		run_pos32("argv_pos32", spec, argv);
+
+		bench::run("argv_parallel", "args=" + std::to_string(ac - 1), ac - 1,
+		           "arg", [&] {
+			bench::keep(spec.parse_parallel(res, ac, av));
+		}, retained);
+
+		std::string line;
+		for (int i = 1; i < ac; ++i) {
+			const std::string_view opt{av[i]};
+			if (opt.starts_with("argument-")) {
+				line.append("\"").append(opt).append("\" ");
+			}
+			else {
+				line.append(opt).append(" ");
+			}
+		}
+		const auto retained_line = bench::retained_bytes([&] {
+			CLUtils::ParseResult words;
+			spec.parse_command_line(words, line);
+			return words;
+		});
+		bench::run("command_line", "args=" + std::to_string(ac - 1), ac - 1,
+		           "arg", [&] {
+			bench::keep(spec.parse_command_line(res, line));
+		}, retained_line);
+	}
+
+	for (const int nargs: {1000, 1000000}) {
+		bench::Argv argv;
+		argv.push("bench_argv");
+		for (int i = 0; argv.size() < nargs + 1; ++i) {
+			argv.push("/some/path/to/file-" + std::to_string(i));
+		}
+		char** av = argv.data();
+		const int ac = argv.size();
+		const auto retained = bench::retained_bytes([&] {
+			CLUtils::ParseResult res;
+			spec.parse(res, ac, av);
+			return res;
+		});
+		CLUtils::ParseResult res;
+		bench::run("files", "args=" + std::to_string(ac - 1), ac - 1, "arg",
+		           [&] {
+			bench::keep(spec.parse(res, ac, av));
+		}, retained);
+
+		run_pos32("files_pos32", spec, argv);
+		run_ranges("files_ranges", spec, argv);
+	}
+
+	for (const int nargs: {1000, 1000000}) {
+		bench::Argv argv;
+		argv.push("bench_argv");
+		argv.push("-a");
+		argv.push("--");
+		for (int i = 0; argv.size() < nargs + 1; ++i) {
+			argv.push("/some/path/to/file-" + std::to_string(i));
+		}
+		char** av = argv.data();
+		const int ac = argv.size();
+		const auto retained = bench::retained_bytes([&] {
+			CLUtils::ParseResult res;
+			spec.parse(res, ac, av);
+			return res;
+		});
+		CLUtils::ParseResult res;
+		bench::run("tail", "args=" + std::to_string(ac - 1), ac - 1, "arg",
+		           [&] {
+			bench::keep(spec.parse(res, ac, av));
+		}, retained);
+
+		run_ranges("tail_ranges", spec, argv);
+	}
+}
@@ -0,0 +1,51 @@
+#include <algorithm>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+#include <clutils.hpp>
+#include "bench.hpp"
+
+// parse_batch throughput as the number of threads grows: a fixed batch of
+// short command-lines parsed against a single compiled spec.
+
+int main() {
+	constexpr int nargvs = 4096;
+
+	CLUtils::Opts cl;
+	for (int i = 0; i < 100; ++i) {
+		cl.add_bare("--bare-" + std::to_string(i));
+	}
+	cl.add_bare("-a");
+	cl.add_bare("-b");
+	cl.add_mandatory("-x", "--input");
+	cl.allow_arguments();
+	const auto spec = cl.compile();
+
+	std::vector<bench::Argv> argvs(nargvs);
+	for (int i = 0; i < nargvs; ++i) {
+		auto& argv = argvs[i];
+		argv.push("bench_batch");
+		argv.push("--bare-" + std::to_string(i % 100));
+		argv.push("-ab");
+		argv.push("--input=" + std::to_string(i));
+		argv.push("file-" + std::to_string(i));
+		if (i % 3 == 0) {
+			argv.push("-x");
+			argv.push("value");
+		}
+	}
+	std::vector<std::span<char*>> batch;
+	for (auto& argv: argvs) {
+		batch.emplace_back(argv.data(), argv.size());
+	}
+	std::vector<CLUtils::ParseResult> results(nargvs);
+
+	const unsigned int cores = std::max(std::thread::hardware_concurrency(), 1u);
+	for (unsigned int threads = 1; threads <= cores; threads *= 2) {
+		bench::run("batch", "argvs=" + std::to_string(nargvs) + " threads="
+		             + std::to_string(threads), nargvs, "argv", [&] {
+			bench::keep(spec.parse_batch(results, batch, 1, threads));
+		});
+	}
+}
@@ -0,0 +1,34 @@
+#include <string>
+#include <clutils.hpp>
+#include "bench.hpp"
+
+// parse cost of a single chained short opt as the length of the chain grows,
+// e.g., "-vvvv...vxinput": the time per character in the chain should stay
+// flat.
+
+int main() {
+	CLUtils::Opts cl;
+	cl.add_bare("-v", "--verbose");
+	cl.add_bare("-q", "--quiet");
+	cl.add_mandatory("-x");
+	const auto spec = cl.compile();
+
+	for (const int len: {10, 100, 1000, 10000, 100000}) {
+		bench::Argv argv;
+		argv.push("bench_chain");
+		argv.push("-" + std::string(len, 'v') + "xinput");
+
+		char** av = argv.data();
+		const int ac = argv.size();
+		const auto retained = bench::retained_bytes([&] {
+			CLUtils::ParseResult res;
+			spec.parse(res, ac, av);
+			return res;
+		});
+
+		CLUtils::ParseResult res;
+		bench::run("chain", "chain=" + std::to_string(len), len, "char", [&] {
+			bench::keep(spec.parse(res, ac, av));
+		}, retained);
+	}
+}
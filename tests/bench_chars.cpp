@@ -0,0 +1,56 @@
+#include <string>
+#include <clutils.hpp>
+#include "bench.hpp"
+
+// parse cost of the same argv for every character type.
+
+template <typename Char>
+void run(const std::string& name) {
+	using String = std::basic_string<Char>;
+	const auto str = [](const std::string& s) {
+		return String(s.begin(), s.end());
+	};
+
+	CLUtils::BasicOpts<Char> cl;
+	cl.add_bare(str("-a"), str("--all"));
+	cl.add_bare(str("-b"), str("--brief"));
+	cl.add_optional(str("-o"), str("--output"));
+	cl.add_mandatory(str("-x"), str("--exclude"));
+	cl.allow_arguments();
+	const auto spec = cl.compile();
+
+	bench::BasicArgv<Char> argv;
+	argv.push("bench_chars");
+	for (int i = 0; argv.size() < 1001; ++i) {
+		switch (i % 4) {
+		case 0:
+			argv.push("--output=file-" + std::to_string(i));
+			break;
+		case 1:
+			argv.push("-abxpattern");
+			break;
+		case 2:
+			argv.push("--all");
+			break;
+		default:
+			argv.push("argument-" + std::to_string(i));
+			break;
+		}
+	}
+
+	Char** av = argv.data();
+	const int ac = argv.size();
+	CLUtils::BasicParseResult<Char> res;
+	bench::run("chars", "char=" + name + " args=" + std::to_string(ac - 1),
+	           ac - 1, "arg", [&] {
+		bench::keep(spec.parse(res, ac, av));
+	});
+}
+
+int main() {
+	run<char>("char");
+	run<wchar_t>("wchar_t");
+	run<char8_t>("char8_t");
+	run<char16_t>("char16_t");
+	run<char32_t>("char32_t");
+}
@@ -0,0 +1,59 @@
+#include <iterator>
+#include <string>
+#include <clutils.hpp>
+#include "bench.hpp"
+
+// cost of an argv in which every opt is an error (unrecognized flags, bare
+// flags given inputs, mandatory flags missing inputs and surplus flags), for
+// the parse itself and for writing the errors out.
+
+int main() {
+	CLUtils::Opts cl;
+	cl.add_bare("-a", "--all");
+	cl.add_bare(1, "-s", "--single");
+	cl.add_mandatory("-x", "--exclude");
+	const auto spec = cl.compile();
+
+	for (const int nargs: {10, 1000, 100000}) {
+		bench::Argv argv;
+		argv.push("bench_errors");
+		for (int i = 0; argv.size() < nargs + 1; ++i) {
+			switch (i % 4) {
+			case 0:
+				argv.push("--unknown-" + std::to_string(i));
+				break;
+			case 1:
+				argv.push("--all=input");
+				break;
+			case 2:
+				argv.push("--single");
+				break;
+			default:
+				argv.push("-ax");
+				break;
+			}
+		}
+
+		char** av = argv.data();
+		const int ac = argv.size();
+		const auto params = "args=" + std::to_string(ac - 1);
+		const auto retained = bench::retained_bytes([&] {
+			CLUtils::ParseResult res;
+			spec.parse(res, ac, av);
+			return res;
+		});
+
+		CLUtils::ParseResult res;
+		bench::run("errors_parse", params, ac - 1, "arg", [&] {
+			bench::keep(spec.parse(res, ac, av));
+		}, retained);
+
+		spec.parse(res, ac, av);
+		std::string out;
+		bench::run("errors_write", params, ac - 1, "arg", [&] {
+			out.clear();
+			res.write_errors_to(std::back_inserter(out));
+			bench::keep(out.data());
+		});
+	}
+}
@@ -0,0 +1,90 @@
+#include <string>
+#include <clutils.hpp>
+#include "bench.hpp"
+
+// parse cost as the number of declared flags grows: the argv is kept at a
+// fixed size and is made up of declared long flags (with and without inputs)
+// and chained short flags. A short argv is also parsed, with the spec and
+// with the Opts object itself, for which the cost should not grow with the
+// flags that are declared but absent.
+
+int main() {
+	constexpr int nargs = 64;
+
+	for (const int nflags: {10, 100, 1000, 10000}) {
+		CLUtils::Opts cl;
+		for (int i = 0; i < nflags; ++i) {
+			const auto n = std::to_string(i);
+			switch (i % 3) {
+			case 0:
+				cl.add_bare("--bare-" + n);
+				break;
+			case 1:
+				cl.add_optional("--optional-" + n);
+				break;
+			default:
+				cl.add_mandatory("--mandatory-" + n);
+				break;
+			}
+		}
+		cl.add_bare("-a");
+		cl.add_bare("-b");
+		cl.add_mandatory("-x");
+		cl.allow_arguments();
+		const auto spec = cl.compile();
+
+		bench::Argv argv;
+		argv.push("bench_flags");
+		for (int i = 0; argv.size() < nargs + 1; ++i) {
+			const auto k = (i * 7919) % nflags;
+			const auto n = std::to_string(k);
+			switch (k % 3) {
+			case 0:
+				argv.push("--bare-" + n);
+				break;
+			case 1:
+				argv.push("--optional-" + n + "=input");
+				break;
+			default:
+				argv.push("--mandatory-" + n + "=input");
+				break;
+			}
+			if (i % 4 == 0) {
+				argv.push("-abxinput");
+			}
+		}
+
+		char** av = argv.data();
+		const int ac = argv.size();
+		const auto retained = bench::retained_bytes([&] {
+			CLUtils::ParseResult res;
+			spec.parse(res, ac, av);
+			return res;
+		});
+
+		CLUtils::ParseResult res;
+		bench::run("flags", "flags=" + std::to_string(nflags)
+		             + " args=" + std::to_string(ac - 1),
+		           ac - 1, "arg", [&] {
+			bench::keep(spec.parse(res, ac, av));
+		}, retained);
+
+		bench::Argv shortv;
+		shortv.push("bench_flags");
+		shortv.push("-ab");
+		shortv.push("-x");
+		shortv.push("input");
+		char** sv = shortv.data();
+		const int sc = shortv.size();
+		bench::run("flags_short", "flags=" + std::to_string(nflags)
+		             + " args=" + std::to_string(sc - 1),
+		           sc - 1, "arg", [&] {
+			bench::keep(spec.parse(res, sc, sv));
+		});
+		bench::run("flags_short_opts", "flags=" + std::to_string(nflags)
+		             + " args=" + std::to_string(sc - 1),
+		           sc - 1, "arg", [&] {
+			bench::keep(cl.parse(sc, sv));
+		});
+	}
+}
@@ -0,0 +1,63 @@
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <span>
+#include <string>
+#include <vector>
+#include <clutils.hpp>
+#include "bench.hpp"
+
+// the cost of parsing the command line of every process on the host, as
+// read from /proc/PID/cmdline (read once, up front): as NUL-separated
+// buffers as they are (proc_cmdline), and split into an argv first, as
+// would be done without parse_nul_separated() (proc_cmdline_argv). Any
+// opt is accepted, as an unrecognized flag or an argument. Without /proc,
+// there are no command lines to parse.
+
+int main() {
+	CLUtils::Opts cl;
+	cl.add_bare("-v", "--verbose");
+	cl.add_optional("-c", "--config");
+	cl.add_stop("--");
+	cl.allow_arguments();
+	cl.allow_unrecognized_flags();
+	const auto spec = cl.compile();
+
+	std::vector<std::string> cmdlines;
+	std::error_code ec;
+	for (const auto& entry: std::filesystem::directory_iterator{"/proc", ec}) {
+		const auto name = entry.path().filename().string();
+		if (name.find_first_not_of("0123456789") != std::string::npos) {
+			continue;
+		}
+		std::ifstream in{entry.path() / "cmdline", std::ios::binary};
+		std::string cmdline{std::istreambuf_iterator<char>{in}, {}};
+		// kernel threads have none
+		if (!cmdline.empty()) {
+			cmdlines.push_back(std::move(cmdline));
+		}
+	}
+	const auto count = static_cast<unsigned long long>(cmdlines.size());
+	const std::string params = "cmdlines=" + std::to_string(count);
+
+	CLUtils::ParseResult res;
+	bench::run("proc_cmdline", params, count, "cmdline", [&] {
+		for (const auto& cmdline: cmdlines) {
+			bench::keep(spec.parse_nul_separated(res, std::span{cmdline}));
+		}
+	});
+
+	std::vector<char*> argv;
+	std::vector<std::string> copies{cmdlines};
+	bench::run("proc_cmdline_argv", params, count, "cmdline", [&] {
+		for (auto& cmdline: copies) {
+			argv.clear();
+			for (std::size_t i = 0; i < cmdline.size();
+			     i += std::char_traits<char>::length(cmdline.data() + i) + 1) {
+				argv.push_back(cmdline.data() + i);
+			}
+			bench::keep(spec.parse(res, static_cast<int>(argv.size()),
+			                       argv.data()));
+		}
+	});
+}
@@ -0,0 +1,79 @@
+#include <string>
+#include <vector>
+#include <clutils.hpp>
+#include "bench.hpp"
+
+// cost of querying a parse result, as the number of declared flags grows:
+// each call queries every one of a fixed set of flags by name, or by the
+// handle returned when it was declared (the *_handle benchmarks).
+
+int main() {
+	constexpr int nqueries = 64;
+
+	for (const int nflags: {10, 1000, 10000}) {
+		CLUtils::Opts cl;
+		std::vector<CLUtils::FlagHandle> declared;
+		for (int i = 0; i < nflags; ++i) {
+			declared.push_back(cl.add_optional("--flag-" + std::to_string(i)));
+		}
+		cl.add_optional("-o");
+		cl.allow_arguments();
+		const auto spec = cl.compile();
+
+		std::vector<std::string> names;
+		std::vector<CLUtils::FlagHandle> handles;
+		bench::Argv argv;
+		argv.push("bench_query");
+		for (int i = 0; i < nqueries; ++i) {
+			const auto name = "--flag-" + std::to_string((i * 7919) % nflags);
+			names.push_back(name);
+			handles.push_back(declared[(i * 7919) % nflags]);
+			argv.push(name + "=input");
+			argv.push("argument");
+		}
+		CLUtils::ParseResult res;
+		spec.parse(res, argv.size(), argv.data());
+
+		const auto params = "flags=" + std::to_string(nflags);
+		bench::run("have_opt", params, nqueries, "query", [&] {
+			for (const auto& name: names) {
+				bench::keep(res.have_opt(name));
+			}
+		});
+		bench::run("get_input", params, nqueries, "query", [&] {
+			for (const auto& name: names) {
+				bench::keep(std::get<1>(res.get_input(name)).data());
+			}
+		});
+		bench::run("get_pos", params, nqueries, "query", [&] {
+			for (const auto& name: names) {
+				bench::keep(res.get_pos(name));
+			}
+		});
+		bench::run("get_all_instances", params, nqueries, "query", [&] {
+			for (const auto& name: names) {
+				bench::keep(res.get_all_instances(name).size());
+			}
+		});
+		bench::run("have_opt_handle", params, nqueries, "query", [&] {
+			for (const auto handle: handles) {
+				bench::keep(res.have_opt(handle));
+			}
+		});
+		bench::run("get_input_handle", params, nqueries, "query", [&] {
+			for (const auto handle: handles) {
+				bench::keep(std::get<1>(res.get_input(handle)).data());
+			}
+		});
+		bench::run("get_pos_handle", params, nqueries, "query", [&] {
+			for (const auto handle: handles) {
+				bench::keep(res.get_pos(handle));
+			}
+		});
+		bench::run("get_argument", params, nqueries, "query", [&] {
+			for (int i = 0; i < nqueries; ++i) {
+				bench::keep(res.get_argument(i).name().data());
+			}
+		});
+	}
+}
@@ -0,0 +1,7 @@
+#include <clutils.hpp>
+
+int main() {
+	using namespace CLUtils;
+	StaticOpts<Static::Bare<"-a">> cl;
+	(void)cl.have_opt<"-b">();
+}
@@ -0,0 +1,6 @@
+#include <clutils.hpp>
+
+int main() {
+	CLUtils::BasicOpts<char, CLUtils::FixedPolicy<>> cl;
+	cl.set_no_chaining();
+}
@@ -0,0 +1,7 @@
+#include <cstdint>
+#include <clutils.hpp>
+
+int main() {
+	CLUtils::BasicOpts<char, CLUtils::RuntimePolicy, std::uint16_t> cl;
+	cl.add_bare("-a");
+}
@@ -0,0 +1,6 @@
+#include <clutils.hpp>
+
+int main() {
+	using namespace CLUtils;
+	StaticOpts<Static::Bare<"-a">, Static::Mandatory<"-b", "-a">> cl;
+}
@@ -1,6 +1,9 @@
 #include <iostream>
+#include <fstream>
+#include <iterator>
 #include <string>
 #include <sstream>
+#include <cstdio>
 #include <vector>
 #include <clutils.hpp>
 
@@ -3900,6 +3903,1020 @@ int main() {
 	}
 
 
+	// error formats: literal '%', unknown placeholders, the preamble and
+	// postscript, and opts that themselves look like placeholders
+
+	cl.set_preamble("[%errno] ");
+	cl.set_postscript(" (%type)");
+	cl.format_error(CLUtils::ErrorKey::Unrecognized,
+									"%%pos=%pos, %%%opt %x %");
+
+	ret = cl.parse(std::vector<std::string>{"--%pos"});
+	if (!ret) {
+		clog << "[parse 7]: no errors on parsing\n";
+		return 7;
+	}
+
+	ss.clear();
+	ss.str("");
+	cl.write_errors(ss);
+	if (auto x = ss.str(); x != "[2000] %pos=1, %--%pos %x % (flag)\n") {
+		clog << "[write_errors]: formats: got: " << x;
+		errors = true;
+	}
+
+
+	// write_errors_to: straight to an iterator, sink or file descriptor
+
+	cl.default_error_formats();
+	cl.set_preamble("");
+	cl.set_postscript("");
+	ret = cl.parse("-aA", "-x", "-a", "--aflag=%pos");
+	if (!ret) {
+		clog << "[parse 8]: no errors on parsing\n";
+		return 8;
+	}
+
+	std::string direct;
+	cl.write_errors_to(std::back_inserter(direct));
+	std::string filtered;
+	cl.write_errors_to(std::back_inserter(filtered), {ErrorKey::MissingInput});
+	std::stringstream streamed;
+	streamed << 1;
+	cl.write_errors_to(std::ostreambuf_iterator<char>{streamed},
+			CLUtils::ErrorKeySet{}.insert(ErrorKey::BareInput));
+	std::string sunk;
+	int batches = 0;
+	cl.write_errors_to_sink([&](const char* data, std::size_t size) {
+		sunk.append(data, size);
+		++batches;
+	});
+
+	ss.clear();
+	ss.str("");
+	cl.write_errors(ss);
+	if (direct != ss.str() || direct.empty()) {
+		clog << "[write_errors_to]: got: " << direct << "expected: " << ss.str();
+		errors = true;
+	}
+	if (filtered != "error: arg 2: flag \u2018-x\u2019: expected input missing.\n") {
+		clog << "[write_errors_to]: filtered: got: " << filtered;
+		errors = true;
+	}
+	if (streamed.str() != "1error: arg 1: flag \u2018-a\u2019: flag does not take an "
+			"input: \u2018A\u2019.\nerror: arg 4: flag \u2018--aflag\u2019: flag "
+			"does not take an input: \u2018%pos\u2019.\n") {
+		clog << "[write_errors_to]: stream: got: " << streamed.str();
+		errors = true;
+	}
+	if (sunk != direct || batches != 1) {
+		clog << "[write_errors_to_sink]: got (" << batches << "): " << sunk;
+		errors = true;
+	}
+
+#ifdef DEFPROB_CLUTILS_HAVE_UNISTD
+	if (int fds[2]; pipe(fds) == 0) {
+		cl.write_errors_to_fd(fds[1], {ErrorKey::MissingInput});
+		close(fds[1]);
+		std::string piped;
+		char buf[256];
+		for (ssize_t n; (n = read(fds[0], buf, sizeof(buf))) > 0; ) {
+			piped.append(buf, static_cast<std::size_t>(n));
+		}
+		close(fds[0]);
+		if (piped != filtered) {
+			clog << "[write_errors_to_fd]: got: " << piped;
+			errors = true;
+		}
+	}
+	else {
+		clog << "[write_errors_to_fd]: pipe\n";
+		errors = true;
+	}
+#endif
+
+	// -- flag handles --
+	{
+		CLUtils::Opts hcl;
+		const auto ha = hcl.add_bare("-a", "--all");
+		const auto ho = hcl.add_optional("-o");
+		const auto hm = hcl.add_mandatory("-m", "--mandatory");
+		const auto hs = hcl.add_stop("--");
+		if (ha.pos() != 0 || ho.pos() != 1 || hm.pos() != 2 || hs.pos() != 3) {
+			clog << "[handles]: positions\n";
+			errors = true;
+		}
+
+		// not yet parsed: a handle throws as a name does
+		try {
+			(void)hcl.have_opt(ha);
+			clog << "[handles]: unparsed, no throw\n";
+			errors = true;
+		}
+		catch (std::out_of_range&) {
+		}
+
+		hcl.parse(std::vector<std::string>{"-a", "--mandatory", "in", "-o=x",
+			"-ma", "--", "-a"});
+		if (hcl.have_opt(ha) != hcl.have_opt("-a")
+				|| hcl.has_flag(hs) != hcl.has_flag("--")
+				|| hcl.get_all_instances(hm).size() != 2
+				|| &hcl.get_all_instances(hm) != &hcl.get_all_instances("-m")
+				|| hcl.get_input(hm) != hcl.get_input("--mandatory")
+				|| hcl.get_input(hm, 0) != hcl.get_input("-m", 0)
+				|| hcl.get_name(hm, 0) != "--mandatory"
+				|| hcl.get_opt_name(hm) != "-m"
+				|| hcl.get_flag_name(ho) != "-o"
+				|| !hcl.is_input_internal(ho)
+				|| !hcl.is_input_external(hm, 0)
+				|| hcl.has_input(ha)
+				|| hcl.get_pos(hm) != hcl.get_pos("-m")
+				|| hcl.get_subpos(hm) != 0
+				|| hcl.result().get_pos(ho) != 4) {
+			clog << "[handles]: queries differ from queries by name\n";
+			errors = true;
+		}
+
+		// a handle from another spec that is out of range
+		try {
+			(void)hcl.have_opt(CLUtils::FlagHandle{4});
+			clog << "[handles]: out of range, no throw\n";
+			errors = true;
+		}
+		catch (std::out_of_range&) {
+		}
+
+		// handles stay valid for a compiled copy of the declarations
+		const auto spec = hcl.compile();
+		CLUtils::ParseResult hres;
+		spec.parse(hres, std::vector<std::string>{"-o"});
+		if (!hres.have_opt(ho) || hres.have_opt(ha)) {
+			clog << "[handles]: compiled spec\n";
+			errors = true;
+		}
+	}
+
+
+	// -- reparsing --
+	{
+		CLUtils::Opts rcl;
+		for (int i = 0; i < 100; ++i) {
+			rcl.add_bare("-f" + std::to_string(i));
+		}
+		const auto rm = rcl.add_mandatory("-m");
+
+		// only the flags of the last parse may have instances
+		rcl.parse(std::vector<std::string>{"-f1", "-f99", "-m", "x", "-f1"});
+		rcl.parse(std::vector<std::string>{"-f2", "-m", "y"});
+		if (rcl.have_opt("-f1") || rcl.have_opt("-f99") || !rcl.have_opt("-f2")
+				|| rcl.get_all_instances(rm).size() != 1
+				|| std::get<1>(rcl.get_input(rm)) != "y") {
+			clog << "[reparse]: instances of the previous parse kept\n";
+			errors = true;
+		}
+
+		// instances added from outside are cleared too
+		rcl.get_all_instances("-f50").push_back(rcl.get_all_instances("-f2")[0]);
+		rcl.parse(std::vector<std::string>{"-f3"});
+		if (rcl.have_opt("-f50") || rcl.have_opt("-f2") || !rcl.have_opt("-f3")) {
+			clog << "[reparse]: instances added from outside kept\n";
+			errors = true;
+		}
+
+		// a flag declared between parses has its type guessed
+		rcl.add_optional("--late");
+		rcl.parse(std::vector<std::string>{"--late=z"});
+		if (!rcl.have_opt("--late")
+				|| std::get<1>(rcl.get_input("--late")) != "z") {
+			clog << "[reparse]: late declaration\n";
+			errors = true;
+		}
+	}
+
+
+	// -- event log --
+	{
+		using Log = CLUtils::ParseResult::EventLog;
+		CLUtils::Opts ecl;
+		const auto ea = ecl.add_bare("-a");
+		const auto eo = ecl.add_optional("-o");
+		const auto em = ecl.add_mandatory("-m");
+		ecl.allow_arguments();
+		ecl.allow_unrecognized_flags();
+		ecl.keep_events();
+
+		for (const auto& argv: std::vector<std::vector<std::string>>{
+				{"-am", "x", "arg1", "-X", "-o", "-mo", "-a", "arg2"},
+				{"-ao", "-m", "-a", "--", "-ma", "-o", "-Y"},
+				{"arg", "-ooa", "-m", "", "-o"}}) {
+			ecl.parse(argv);
+			const auto& log = ecl.result().events();
+
+			// in command-line order, with every result
+			CLUtils::CLType last = 0;
+			std::size_t args = 0, unrecognized = 0;
+			for (Log::EventPos e = 0; e < log.size(); ++e) {
+				if (log.pos(e) < last) {
+					clog << "[events]: out of order at event " << e << "\n";
+					errors = true;
+				}
+				last = log.pos(e);
+				if (log.kind(e) == Log::Kind::argument
+						&& log.name(e) != ecl.get_argument(args++).name()) {
+					clog << "[events]: wrong argument at event " << e << "\n";
+					errors = true;
+				}
+				if (log.kind(e) == Log::Kind::unrecognized
+						&& log.name(e) != ecl.get_unrecognized_flag(unrecognized++).name()) {
+					clog << "[events]: wrong unrecognized flag at event " << e << "\n";
+					errors = true;
+				}
+
+				// the events at each position
+				const auto [first, end] = log.at(log.pos(e));
+				if (e < first || e >= end) {
+					clog << "[events]: event " << e << " not at its position\n";
+					errors = true;
+				}
+			}
+			if (args != ecl.get_all_arguments().size()
+					|| unrecognized != ecl.get_all_unrecognized_flags().size()) {
+				clog << "[events]: arguments or unrecognized flags missing\n";
+				errors = true;
+			}
+
+			// each flag's chain holds its instances
+			for (const auto flag: {ea, eo, em}) {
+				const auto& instances = ecl.get_all_instances(flag);
+				std::size_t i = 0;
+				for (auto e = log.first(flag.pos()); e != Log::no_event;
+						e = log.next(e), ++i) {
+					if (i >= instances.size()
+							|| log.pos(e) != instances[i].pos()
+							|| log.subpos(e) != instances[i].subpos()
+							|| log.name(e) != instances[i].name()
+							|| log.has_input(e) != instances[i].input()()
+							|| log.input(e) != instances[i].input().value()) {
+						clog << "[events]: chain differs from instances\n";
+						errors = true;
+						break;
+					}
+				}
+				if (i != instances.size()) {
+					clog << "[events]: chain is short\n";
+					errors = true;
+				}
+			}
+		}
+
+		// positions with nothing on them
+		ecl.parse(std::vector<std::string>{"-m", "x", "arg"});
+		const auto& log = ecl.result().events();
+		if (log.at(2).first != log.at(2).second
+				|| log.at(1).second - log.at(1).first != 1
+				|| log.at(3).first != 1 || log.at(99).first != log.size()) {
+			clog << "[events]: wrong events by position\n";
+			errors = true;
+		}
+
+		// nothing is kept once turned off
+		ecl.keep_events(false);
+		ecl.parse(std::vector<std::string>{"-a"});
+		if (!ecl.result().events().empty()) {
+			clog << "[events]: kept when turned off\n";
+			errors = true;
+		}
+
+		// the log as the only store: the queries of a flag read it, and
+		// give the same answers, while nothing else is kept
+		const auto declare = [](auto& cl) {
+			cl.add_bare("-a");
+			cl.add_optional(2, "-o");
+			cl.add_mandatory("-m", "--mandatory");
+			cl.allow_arguments();
+			cl.allow_unrecognized_flags();
+		};
+		CLUtils::Opts kept, only;
+		declare(kept);
+		declare(only);
+		only.keep_events_only();
+		const std::vector<std::string> argv{"-am", "x", "arg1", "-X", "-o",
+			"-moa", "--mandatory=y", "-ooo", "arg2", "-m"};
+		std::string kept_errors, only_errors;
+		if (kept.parse(argv) != only.parse(argv)
+				|| (kept.result().write_errors_to(
+						std::back_inserter(kept_errors)),
+					only.result().write_errors_to(
+						std::back_inserter(only_errors)),
+					kept_errors != only_errors || kept_errors.empty())) {
+			clog << "[events only]: errors differ\n";
+			errors = true;
+		}
+		for (const auto name: {"-a", "-o", "-m"}) {
+			const auto count = static_cast<long>(
+				kept.get_all_instances(name).size());
+			if (kept.have_opt(name) != only.have_opt(name)
+					|| !only.get_all_instances(name).empty()
+					|| only.try_get_pos(name, count).has_value()) {
+				clog << "[events only]: " << name << " instances\n";
+				errors = true;
+			}
+			for (long i = -count; i < count; ++i) {
+				if (kept.get_pos(name, i) != only.get_pos(name, i)
+						|| kept.get_subpos(name, i) != only.get_subpos(name, i)
+						|| kept.get_name(name, i) != only.get_name(name, i)
+						|| kept.get_input(name, i) != only.get_input(name, i)
+						|| kept.is_input_external(name, i)
+							!= only.is_input_external(name, i)) {
+					clog << "[events only]: " << name << " instance " << i
+						<< " differs\n";
+					errors = true;
+				}
+			}
+		}
+		if (!only.get_all_arguments().empty()
+				|| !only.get_all_unrecognized_flags().empty()
+				|| only.result().events().size()
+					!= kept.get_all_arguments().size()
+					   + kept.get_all_unrecognized_flags().size()
+					   + kept.get_all_instances("-a").size()
+					   + kept.get_all_instances("-o").size()
+					   + kept.get_all_instances("-m").size()) {
+			clog << "[events only]: arguments or unrecognized flags kept\n";
+			errors = true;
+		}
+
+		// a copy of the result, and so of the log, answers the same
+		const CLUtils::ParseResult copy = only.result();
+		if (copy.events().size() != only.result().events().size()
+				|| copy.get_input("-m", 1) != only.get_input("-m", 1)
+				|| copy.events().name(3) != only.result().events().name(3)) {
+			clog << "[events only]: copy differs\n";
+			errors = true;
+		}
+	}
+
+
+	// -- position type --
+	{
+		// with 32-bit positions, an argument takes at most half the room of a
+		// view and two CLTypes; only unrecognized flags hold a subpos
+		static_assert(2 * sizeof(CLUtils::BasicArg<char, std::uint32_t>)
+		              <= sizeof(std::string_view) + 2 * sizeof(CLUtils::CLType));
+		static_assert(sizeof(CLUtils::BasicArg<char, std::uint32_t>)
+		              < sizeof(CLUtils::BasicUnrecognizedFlag<char, std::uint32_t>));
+
+		using Opts32 = CLUtils::BasicOpts<char, CLUtils::RuntimePolicy,
+		                                  std::uint32_t>;
+		const auto declare = [](auto& cl) {
+			cl.add_bare("-a");
+			cl.add_optional("-o");
+			cl.add_mandatory("-m", "--mandatory");
+			cl.allow_arguments();
+		};
+		CLUtils::Opts wide;
+		Opts32 narrow;
+		declare(wide);
+		declare(narrow);
+
+		const std::vector<std::string> argv{"-ao", "arg", "--mandatory=x",
+		                                    "-am", "y", "-o", "in", "-ma"};
+		if (wide.parse(argv) != narrow.parse(argv)) {
+			clog << "[pos type]: errors differ\n";
+			errors = true;
+		}
+		for (const auto name: {"-a", "-o", "-m"}) {
+			const auto& w = wide.get_all_instances(name);
+			const auto& n = narrow.get_all_instances(name);
+			bool same = w.size() == n.size();
+			for (std::size_t i = 0; same && i < w.size(); ++i) {
+				same = w[i].name() == n[i].name() && w[i].pos() == n[i].pos()
+					&& w[i].subpos() == n[i].subpos()
+					&& w[i].input()() == n[i].input()()
+					&& w[i].input().value() == n[i].input().value()
+					&& w[i].input().type() == n[i].input().type();
+			}
+			if (!same) {
+				clog << "[pos type]: instances of " << name << " differ\n";
+				errors = true;
+			}
+		}
+		if (narrow.get_argument(0).name() != "arg"
+				|| narrow.get_argument(0).pos() != 2
+				|| narrow.get_argument(0).subpos() != 0) {
+			clog << "[pos type]: wrong argument\n";
+			errors = true;
+		}
+
+		// a compiled spec parses into results of any position type
+		const auto spec = wide.compile();
+		CLUtils::BasicParseResult<char, std::uint32_t> res;
+		res.keep_events();
+		spec.parse(res, argv);
+		if (res.get_pos("-o", 0) != wide.get_pos("-o", 0)
+				|| res.events().size() != 9) {
+			clog << "[pos type]: wrong results from compiled spec\n";
+			errors = true;
+		}
+
+#if defined(DEFPROB_CLUTILS_HAVE_MMAN) && SIZE_MAX > UINT32_MAX
+		// an opt longer than the position type can count is refused rather
+		// than wrapped (mapped but never touched past its first page)
+		const std::size_t huge = (std::size_t{1} << 32) + 8;
+		void* const mem = mmap(nullptr, huge, PROT_READ | PROT_WRITE,
+		                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+		                       -1, 0);
+		if (mem != MAP_FAILED) {
+			std::char_traits<char>::copy(static_cast<char*>(mem), "--in=", 5);
+			const std::vector<std::string_view> long_argv{
+				"-a", {static_cast<const char*>(mem), huge}};
+			bool refused = false;
+			try {
+				spec.parse(res, long_argv);
+			}
+			catch (const std::length_error&) {
+				refused = true;
+			}
+			if (!refused) {
+				clog << "[pos type]: opt too long for position type not refused\n";
+				errors = true;
+			}
+			munmap(mem, huge);
+		}
+#endif
+	}
+
+
+	// -- argument ranges --
+	{
+		static_assert(std::ranges::random_access_range<CLUtils::BasicArgRange<char>>);
+
+		CLUtils::Opts cl;
+		const auto a = cl.add_bare("-a");
+		cl.add_stop("--");
+		cl.allow_arguments();
+		cl.keep_argument_ranges();
+
+		using Range = std::vector<std::string_view>;
+		const auto check = [&](const char* tag, const bool views) {
+			const auto& ranges = cl.get_argument_ranges();
+			const auto& tail = cl.get_tail();
+			if (!cl.get_all_arguments().empty() || ranges.size() != 3
+					|| cl.get_all_instances(a).size() != 1) {
+				clog << "[ranges " << tag << "]: wrong results\n";
+				errors = true;
+				return;
+			}
+			if (ranges[0].pos() != 1 || ranges[0].end_pos() != 3
+					|| !std::ranges::equal(ranges[0], Range{"x", "y"})
+					|| ranges[1].pos() != 4 || ranges[1][0] != "z") {
+				clog << "[ranges " << tag << "]: wrong runs\n";
+				errors = true;
+			}
+			if (tail.pos() != 6 || tail.size() != 3
+					|| !std::ranges::equal(tail, Range{"-a", "p", "q"})
+					|| !std::ranges::equal(ranges[2], tail)
+					|| tail.argv().empty() == !views
+					|| tail.views().empty() == views) {
+				clog << "[ranges " << tag << "]: wrong tail\n";
+				errors = true;
+			}
+		};
+
+		char a0[] = "prog", a1[] = "x", a2[] = "y", a3[] = "-a", a4[] = "z",
+		     a5[] = "--", a6[] = "-a", a7[] = "p", a8[] = "q";
+		char* argv[] = {a0, a1, a2, a3, a4, a5, a6, a7, a8};
+		if (cl.parse(9, argv)) {
+			clog << "[ranges argv]: errors\n";
+			errors = true;
+		}
+		check("argv", false);
+
+		const std::vector<std::string> args{"x", "y", "-a", "z", "--", "-a",
+		                                    "p", "q"};
+		if (cl.parse(args)) {
+			clog << "[ranges vector]: errors\n";
+			errors = true;
+		}
+		check("vector", true);
+
+		// the tail is parsed as usual if it would exceed the limit...
+		cl.allow_arguments(4);
+		if (!cl.parse(args) || !cl.get_tail().empty()) {
+			clog << "[ranges limit]: tail taken over the limit\n";
+			errors = true;
+		}
+		cl.allow_arguments();
+
+		// ...or the event log is kept, still as a range
+		cl.keep_events();
+		if (cl.parse(args) || !cl.get_tail().empty()
+				|| cl.get_argument_ranges().size() != 3
+				|| !std::ranges::equal(cl.get_argument_ranges()[2],
+				                       Range{"-a", "p", "q"})) {
+			clog << "[ranges events]: wrong results\n";
+			errors = true;
+		}
+		cl.keep_events(false);
+
+		// no stop flag: no tail
+		if (cl.parse("x", "-a", "y") || !cl.get_tail().empty()
+				|| cl.get_argument_ranges().size() != 2) {
+			clog << "[ranges no stop]: wrong results\n";
+			errors = true;
+		}
+
+		cl.keep_argument_ranges(false);
+		cl.parse(args);
+		if (cl.get_all_arguments().size() != 6
+				|| !cl.get_argument_ranges().empty()) {
+			clog << "[ranges off]: wrong results\n";
+			errors = true;
+		}
+	}
+
+
+	// -- flag markers --
+	{
+		// markers either side of a word of the marker table, and one of the
+		// high bit, are told apart from the code units next to them
+		CLUtils::Opts cl;
+		cl.set_flag_markers('?', '@', '\xff');
+		cl.add_bare("?a");
+		cl.allow_arguments();
+		cl.allow_unrecognized_flags();
+		if (cl.parse("?a", "@b", "\xff" "c", ">d", "Ae", "\xfe" "f")
+				|| !cl.have_opt("?a")
+				|| cl.get_all_arguments().size() != 3) {
+			clog << "[markers]: wrong results\n";
+			errors = true;
+		}
+		if (cl.get_all_unrecognized_flags().size() != 2) {
+			clog << "[markers]: unrecognized flags not found\n";
+			errors = true;
+		}
+
+		CLUtils::WOpts wcl;
+		wcl.set_flag_markers(L'-', L'\u2013');
+		wcl.add_bare(L"\u2013a");
+		wcl.allow_arguments();
+		if (wcl.parse(L"\u2013a", L"\u2014b", L"c")
+				|| !wcl.have_opt(L"\u2013a")
+				|| wcl.get_all_arguments().size() != 2) {
+			clog << "[markers]: wrong results for wide markers\n";
+			errors = true;
+		}
+	}
+
+
+	// -- parallel parse --
+	{
+		CLUtils::Opts cl;
+		cl.add_bare("-a", "--all");
+		cl.add_bare("-b");
+		cl.add_optional("-o", "--output");
+		cl.add_mandatory("-x", "--exclude");
+		cl.add_stop("--");
+		cl.allow_arguments();
+		cl.allow_unrecognized_flags();
+		const auto spec = cl.compile();
+
+		// a stop flag in the middle, errors, and a flag left without its
+		// input at the end
+		std::vector<std::string> opts{"prog"};
+		for (int i = 0; opts.size() < 40000; ++i) {
+			if (i == 24000) {
+				opts.push_back("--");
+			}
+			switch (i % 9) {
+			case 0: opts.push_back("--output=file" + std::to_string(i)); break;
+			case 1: opts.push_back("-ab"); break;
+			case 2: opts.push_back("-x"); opts.push_back("-p"); break;
+			case 3: opts.push_back("-o"); break;
+			case 4: opts.push_back("arg" + std::to_string(i)); break;
+			case 5: opts.push_back("--all=bad"); break;
+			case 6: opts.push_back("-Z"); break;
+			case 7: opts.push_back("-ax"); break;
+			default: opts.push_back("-o" + std::to_string(i)); break;
+			}
+		}
+		opts.push_back("-x");
+		std::vector<char*> argv;
+		for (auto& opt: opts) {
+			argv.push_back(opt.data());
+		}
+		const int argc = argv.size();
+
+		CLUtils::ParseResult in_order, in_chunks;
+		const bool e1 = spec.parse(in_order, argc, argv.data());
+		const bool e2 = spec.parse_parallel(in_chunks, argc, argv.data(), 1, 4);
+
+		const auto same_args = [](const auto& x, const auto& y) {
+			return std::ranges::equal(x, y, [](const auto& a, const auto& b) {
+				return a.name() == b.name() && a.pos() == b.pos();
+			});
+		};
+		bool same = e1 == e2
+			&& same_args(in_order.get_all_arguments(),
+			             in_chunks.get_all_arguments())
+			&& same_args(in_order.get_all_unrecognized_flags(),
+			             in_chunks.get_all_unrecognized_flags());
+		for (const auto name: {"-a", "-b", "-o", "-x", "--"}) {
+			const auto& x = in_order.get_all_instances(name);
+			const auto& y = in_chunks.get_all_instances(name);
+			same = same && std::ranges::equal(x, y,
+				[](const auto& a, const auto& b) {
+					return a.name() == b.name() && a.pos() == b.pos()
+						&& a.subpos() == b.subpos()
+						&& a.input()() == b.input()()
+						&& a.input().value() == b.input().value();
+				});
+		}
+		std::ostringstream errors1, errors2;
+		in_order.write_errors(errors1);
+		in_chunks.write_errors(errors2);
+		if (!same || !e1 || errors1.str() != errors2.str()
+				|| in_order.get_all_instances("--").size() != 1) {
+			clog << "[parallel]: results differ from those in order\n";
+			errors = true;
+		}
+
+		// through an Opts object, and falling back to parsing in order
+		cl.add_bare(2, "-l");
+		cl.parse_parallel(argc, argv.data(), 1, 4);
+		if (!same_args(cl.get_all_arguments(), in_order.get_all_arguments())) {
+			clog << "[parallel]: wrong results with a limit\n";
+			errors = true;
+		}
+	}
+
+
+#ifdef DEFPROB_CLUTILS_HAVE_MMAN
+	// -- response files --
+	{
+		const std::string a_text = "-a \"quoted arg\" 'single \\ q' esc\\ aped\n"
+		                           "@cgood2-b.rsp\n-o x\n";
+		std::ofstream{"cgood2-a.rsp"} << a_text;
+		std::ofstream{"cgood2-b.rsp"} << "-b @cgood2-a.rsp inner\n";
+
+		CLUtils::Opts cl;
+		cl.add_bare("-a");
+		cl.add_bare("-b");
+		cl.add_mandatory("-o");
+		cl.allow_arguments();
+
+		char a0[] = "prog", a1[] = "first", a2[] = "@cgood2-a.rsp",
+		     a3[] = "last", a4[] = "@cgood2-missing.rsp";
+		char* argv[] = {a0, a1, a2, a3, a4};
+
+		using Args = std::vector<std::string_view>;
+		const auto args = [&] {
+			Args ret;
+			for (const auto& arg: cl.get_all_arguments()) {
+				ret.push_back(arg.name());
+			}
+			return ret;
+		};
+
+		// not read unless asked for
+		if (cl.parse(5, argv)
+				|| args() != Args{"first", "@cgood2-a.rsp", "last",
+				                  "@cgood2-missing.rsp"}
+				|| cl.get_source(2).arg != 2 || !cl.get_source(2).file.empty()) {
+			clog << "[response files]: read by default\n";
+			errors = true;
+		}
+
+		cl.allow_response_files();
+		if (cl.parse(5, argv)
+				|| args() != Args{"first", "quoted arg", "single \\ q",
+				                  "esc aped", "@cgood2-b.rsp", "last",
+				                  "@cgood2-missing.rsp"}
+				|| cl.get_all_instances("-o").size() != 1
+				|| cl.get_all_instances("-o")[0].input().value() != "x"
+				|| cl.get_all_instances("-b").size() != 0) {
+			clog << "[response files]: wrong opts\n";
+			errors = true;
+		}
+
+		cl.allow_response_files(CLUtils::ResponseFiles::nested);
+		if (cl.parse(5, argv)
+				|| args() != Args{"first", "quoted arg", "single \\ q",
+				                  "esc aped", "@cgood2-a.rsp", "inner", "last",
+				                  "@cgood2-missing.rsp"}
+				|| cl.get_all_instances("-b").size() != 1) {
+			clog << "[response files]: wrong nested opts\n";
+			errors = true;
+		}
+		const auto quoted = cl.get_source(3);
+		const auto cycle = cl.get_source(7);
+		const auto last = cl.get_source(11);
+		if (quoted.arg != 2 || quoted.file != "cgood2-a.rsp" || quoted.offset != 3
+				|| cycle.arg != 2 || cycle.file != "cgood2-b.rsp"
+				|| cycle.offset != 3
+				|| last.arg != 3 || !last.file.empty()) {
+			clog << "[response files]: wrong sources\n";
+			errors = true;
+		}
+
+		// an error in a response file is placed in argv and in the file
+		std::ofstream{"cgood2-c.rsp"} << "x -o\n";
+		char c2[] = "@cgood2-c.rsp";
+		char* located[] = {a0, a1, c2};
+		std::string text;
+		if (!cl.parse(3, located)
+				|| (cl.write_errors_to(std::back_inserter(text)), text)
+				     != "error: arg 2 (in cgood2-c.rsp at 2): flag \u2018-o\u2019: "
+				        "expected input missing.\n") {
+			clog << "[response files]: wrong error: " << text;
+			errors = true;
+		}
+		cl.format_error(CLUtils::ErrorKey::MissingInput,
+		                "%pos:%file:%offset: %opt");
+		text.clear();
+		if (!cl.parse(3, located)
+				|| (cl.write_errors_to(std::back_inserter(text)), text)
+				     != "2:cgood2-c.rsp:2: -o\n") {
+			clog << "[response files]: wrong formatted error: " << text;
+			errors = true;
+		}
+		std::remove("cgood2-c.rsp");
+
+		// the opts were unquoted in a private mapping, not in the file
+		std::ifstream in{"cgood2-a.rsp"};
+		const std::string on_disk{std::istreambuf_iterator<char>{in}, {}};
+		if (on_disk != a_text) {
+			clog << "[response files]: file changed\n";
+			errors = true;
+		}
+		std::remove("cgood2-a.rsp");
+		std::remove("cgood2-b.rsp");
+	}
+#endif
+
+
+	// -- command line --
+	{
+		CLUtils::Opts cl;
+		cl.add_bare("-a");
+		cl.add_mandatory("-o");
+		cl.allow_arguments();
+
+		const std::string line = "-a plain \"two words\" it\\'s 'a \"b\"' "
+		                         "-o \"x\\\"y\\z\" c\\\nd \\\n e\"\"f\n";
+		using Words = std::vector<std::string_view>;
+		const auto args = [&] {
+			Words ret;
+			for (const auto& arg: cl.get_all_arguments()) {
+				ret.push_back(arg.name());
+			}
+			return ret;
+		};
+		const auto in_line = [&](const std::string_view word) {
+			return word.data() >= line.data()
+				&& word.data() < line.data() + line.size();
+		};
+		if (cl.parse_command_line(line)
+				|| args() != Words{"plain", "two words", "it's", "a \"b\"",
+				                   "cd", "ef"}
+				|| cl.get_all_instances("-a").size() != 1
+				|| cl.get_all_instances("-o").size() != 1
+				|| cl.get_all_instances("-o")[0].input().value() != "x\"y\\z"
+				|| cl.get_all_instances("-o")[0].pos() != 6) {
+			clog << "[command line]: wrong words\n";
+			errors = true;
+		}
+		else if (!in_line(cl.get_argument(0).name())
+				|| in_line(cl.get_argument(1).name())) {
+			clog << "[command line]: words not viewed in place\n";
+			errors = true;
+		}
+
+		// a quote left open, or a backslash at the end, is an error at the
+		// last word, which is still parsed as if the line were closed
+		const auto error_text = [&] {
+			std::string ret;
+			cl.write_errors_to(std::back_inserter(ret));
+			return ret;
+		};
+		if (!cl.parse_command_line("-a 'x  y") || args() != Words{"x  y"}
+				|| error_text() != "error: arg 2: arg \u2018x  y\u2019: quote not "
+				                   "closed at the end of the line.\n") {
+			clog << "[command line]: unclosed quote accepted\n";
+			errors = true;
+		}
+		if (!cl.parse_command_line("a\\") || args() != Words{"a"}
+				|| error_text() != "error: arg 1: arg \u2018a\u2019: backslash at "
+				                   "the end of the line escapes nothing.\n") {
+			clog << "[command line]: trailing backslash accepted\n";
+			errors = true;
+		}
+		// (after the input that the flag then misses)
+		if (!cl.parse_command_line("x \"-o") || !error_text().ends_with(
+				"error: arg 2: flag \u2018-o\u2019: quote not closed at the end "
+				"of the line.\n")) {
+			clog << "[command line]: unclosed quote in a flag accepted\n";
+			errors = true;
+		}
+		if (cl.parse_command_line("x \\\n") || args() != Words{"x"}
+				|| cl.parse_command_line("") || !args().empty()) {
+			clog << "[command line]: wrong words at the end\n";
+			errors = true;
+		}
+
+		CLUtils::WOpts wcl;
+		wcl.allow_arguments();
+		if (wcl.parse_command_line(L"x 'y z'") || wcl.get_all_arguments().size() != 2
+				|| wcl.get_argument(1).name() != L"y z") {
+			clog << "[command line]: wrong wide words\n";
+			errors = true;
+		}
+	}
+
+
+	// -- NUL-separated opts --
+	{
+		CLUtils::Opts cl;
+		cl.add_bare("-a");
+		cl.add_mandatory("-o");
+		cl.allow_arguments();
+		cl.allow_empty_arguments();
+
+		using Words = std::vector<std::string_view>;
+		const auto args = [&] {
+			Words ret;
+			for (const auto& arg: cl.get_all_arguments()) {
+				ret.push_back(arg.name());
+			}
+			return ret;
+		};
+
+		// as read from /proc/PID/cmdline
+		const std::string cmdline{"prog\0-a\0x\0\0-o\0out\0y\0", 20};
+		const std::span<const char> buf{cmdline};
+		if (cl.parse_nul_separated(buf) || args() != Words{"x", "", "y"}
+				|| cl.get_argument(2).pos() != 6
+				|| cl.get_all_instances("-o")[0].input().value() != "out"
+				|| cl.get_argument(0).name().data() != cmdline.data() + 8) {
+			clog << "[nul separated]: wrong opts\n";
+			errors = true;
+		}
+
+		// not ended by a NUL, from the first opt, and as argument ranges
+		cl.keep_argument_ranges();
+		if (cl.parse_nul_separated(buf.first(9), 0)
+				|| cl.get_argument_ranges().size() != 2
+				|| cl.get_argument_ranges()[0][0] != "prog"
+				|| cl.get_argument_ranges()[1].pos() != 3
+				|| cl.get_argument_ranges()[1][0] != "x"
+				|| !cl.parse_nul_separated(buf.first(14), 4)) {
+			clog << "[nul separated]: wrong opts at the end\n";
+			errors = true;
+		}
+	}
+
+
+	// -- streaming --
+	{
+		CLUtils::Opts cl;
+		cl.add_bare("-a");
+		cl.add_mandatory("-o");
+		cl.allow_arguments();
+
+		// fed from one buffer that is overwritten by every opt
+		std::string buf;
+		auto stream = cl.stream();
+		for (const auto opt: {"x", "-o", "out", "-a", "y", "-o"}) {
+			buf = opt;
+			stream.feed(buf);
+		}
+		buf = "overwritten";
+		const bool e = stream.finish();
+		if (!e || stream.size() != 6 || cl.get_all_arguments().size() != 2
+				|| cl.get_argument(0).name() != "x"
+				|| cl.get_argument(1).name() != "y"
+				|| cl.get_argument(1).pos() != 5
+				|| cl.get_all_instances("-o")[0].input().value() != "out"
+				|| cl.get_all_instances("-o").size() != 1) {
+			clog << "[stream]: wrong results\n";
+			errors = true;
+		}
+
+		// the arguments handed over rather than kept
+		std::vector<std::pair<std::string, CLUtils::CLType>> handed;
+		cl.set_argument_callback([&](const std::string_view arg,
+		                             const CLUtils::CLType pos) {
+			handed.emplace_back(arg, pos);
+		});
+		auto args = cl.stream();
+		for (const auto opt: {"x", "-a", "y", "-o", "z", "w"}) {
+			buf = opt;
+			args.feed(buf);
+		}
+		if (args.finish() || !cl.get_all_arguments().empty()
+				|| handed.size() != 3 || handed[1].first != "y"
+				|| handed[1].second != 3 || handed[2].first != "w"
+				|| cl.get_all_instances("-o")[0].input().value() != "z"
+				|| cl.get_all_instances("-a")[0].name() != "-a") {
+			clog << "[stream callback]: wrong results\n";
+			errors = true;
+		}
+
+		// and likewise for an ordinary parse
+		handed.clear();
+		if (cl.parse("p", "-a", "q") || handed.size() != 2
+				|| handed[1].first != "q" || handed[1].second != 3) {
+			clog << "[stream callback]: wrong parse results\n";
+			errors = true;
+		}
+
+		// with argument ranges kept, a stream still keeps an Arg each, since
+		// there is no argv in order in memory for a range to view
+		CLUtils::Opts ranged;
+		ranged.allow_arguments();
+		ranged.keep_argument_ranges();
+		auto kept = ranged.stream();
+		for (const auto opt: {"x", "y"}) {
+			buf = opt;
+			kept.feed(buf);
+		}
+		buf = "overwritten";
+		if (kept.finish() || !ranged.result().get_argument_ranges().empty()
+				|| ranged.get_all_arguments().size() != 2
+				|| ranged.get_argument(0).name() != "x"
+				|| ranged.get_argument(1).name() != "y"
+				|| ranged.get_argument(1).pos() != 2) {
+			clog << "[stream ranges]: wrong results\n";
+			errors = true;
+		}
+	}
+
+
+	// -- callbacks --
+	{
+		CLUtils::Opts cl;
+		const auto a = cl.add_bare("-a");
+		const auto o = cl.add_mandatory("-o");
+		const auto l = cl.add_bare(1, "-l");
+		cl.allow_arguments();
+		cl.allow_unrecognized_flags();
+
+		std::vector<std::string> seen;
+		const auto opt = [&](const char* tag) {
+			return [&seen, tag](const std::string_view name,
+			                    const CLUtils::CLType pos) {
+				seen.push_back(tag + std::string{name} + std::to_string(pos));
+			};
+		};
+		cl.set_flag_callback(a, [&](const auto& instance) {
+			seen.push_back("flag:" + std::string{instance.name()}
+			               + std::to_string(instance.pos()));
+		});
+		cl.set_flag_callback(o, [&](const auto& instance) {
+			seen.push_back("input:" + std::string{instance.input().value()});
+		});
+		cl.set_flag_callback(l, [&](const auto&) { seen.push_back("l"); });
+		cl.set_argument_callback(opt("arg:"));
+		cl.set_unrecognized_flag_callback(opt("unrecognized:"));
+		std::vector<ErrorKey> keys;
+		cl.set_error_callback([&](const auto& error) {
+			keys.push_back(error.key);
+		});
+
+		const bool e = cl.parse("x", "-a", "-o", "in", "-Z", "-l", "-l", "y",
+		                        "-a", "-o");
+		const std::vector<std::string> expected{"arg:x1", "flag:-a2",
+			"input:in", "unrecognized:-Z5", "l", "l", "arg:y8", "flag:-a9"};
+		if (!e || seen != expected || !cl.result().has_errors()
+				|| keys != std::vector{ErrorKey::Surplus, ErrorKey::MissingInput}
+				|| !cl.get_all_instances(a).empty()
+				|| !cl.get_all_instances(l).empty()
+				|| !cl.get_all_arguments().empty()
+				|| !cl.get_all_unrecognized_flags().empty()) {
+			clog << "[callbacks]: wrong results\n";
+			errors = true;
+		}
+
+		// the counts toward the limits are cleared with the result
+		seen.clear();
+		keys.clear();
+		if (cl.parse("-l", "-a")
+				|| seen != std::vector<std::string>{"l", "flag:-a2"}
+				|| !keys.empty() || cl.result().has_errors()) {
+			clog << "[callbacks]: counts not cleared\n";
+			errors = true;
+		}
+
+		// a flag without a callback is kept as usual
+		cl.set_flag_callback(a, {});
+		seen.clear();
+		if (cl.parse("-a", "-a") || !seen.empty()
+				|| cl.get_all_instances(a).size() != 2) {
+			clog << "[callbacks]: instances not kept again\n";
+			errors = true;
+		}
+	}
+
 
 	if (errors) {
 		return 51;
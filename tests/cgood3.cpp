@@ -0,0 +1,185 @@
+#include <iostream>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <clutils.hpp>
+
+using std::clog;
+using namespace std::string_literals;
+
+// parse 'argv' into 'res' and check the result against what the
+// declarations in main() should give
+bool check(const CLUtils::CompiledSpec& spec, CLUtils::ParseResult& res,
+           std::vector<std::string> argv, const std::string& input) {
+	argv.push_back("--mand="s + input);
+	if (spec.parse(res, argv)) {
+		return false;
+	}
+	if ( !res.have_opt("-a") || res.get_all_instances("-a").size() != 2 ) {
+		return false;
+	}
+	if ( std::get<1>(res.get_input("--mand")) != input ) {
+		return false;
+	}
+	if ( res.get_all_arguments().size() != 1
+			|| res.get_argument().name() != "arg" ) {
+		return false;
+	}
+	return true;
+}
+
+int main() {
+	bool errors = false;
+
+	CLUtils::Opts cl;
+	cl.add_bare("-a", "--aflag");
+	cl.add_mandatory("-m", "--mand");
+	cl.add_bare(1, "-b");
+	cl.allow_arguments(1);
+
+	const CLUtils::CompiledSpec spec = cl.compile();
+
+	// the spec is unaffected by later declarations on 'cl'
+	cl.add_bare("-x");
+	if ( spec.registered_flags().size() != 3 ) {
+		clog << "[compile]: registered flags\n";
+		errors = true;
+	}
+
+	// -- a single result, reused --
+
+	CLUtils::ParseResult res{spec};
+	if ( res.have_opt("-a") ) {
+		clog << "[result]: unparsed result has -a\n";
+		errors = true;
+	}
+	for (int i = 0; i < 3; ++i) {
+		if ( !check(spec, res, {"-a", "arg", "--aflag"}, std::to_string(i)) ) {
+			clog << "[result]: reuse " << i << "\n";
+			errors = true;
+		}
+	}
+
+	// -- errors are written through the spec's formats --
+
+	if ( !spec.parse(res, std::vector<std::string>{"-b", "-b"}) ) {
+		clog << "[result]: surplus -b not an error\n";
+		errors = true;
+	}
+	std::stringstream ss;
+	res.write_errors(ss);
+	if ( ss.str().find("exceeded presence limit") == std::string::npos ) {
+		clog << "[result]: write_errors: got: " << ss.str();
+		errors = true;
+	}
+
+	// -- an unparsed result has no flags --
+
+	try {
+		CLUtils::ParseResult unbound;
+		(void)unbound.have_opt("-a");
+		clog << "[result]: unbound have_opt\n";
+		errors = true;
+	}
+	catch (std::out_of_range&) {}
+
+	// -- many threads, one spec --
+
+	constexpr int threads = 8;
+	std::vector<int> failed(threads, 0);
+	std::vector<std::thread> pool;
+	for (int t = 0; t < threads; ++t) {
+		pool.emplace_back([&spec, &failed, t] {
+			CLUtils::ParseResult thread_res;
+			for (int i = 0; i < 500; ++i) {
+				const auto input = std::to_string(t) + ":"s + std::to_string(i);
+				if ( !check(spec, thread_res, {"--aflag", "-a", "arg"}, input) ) {
+					++failed[t];
+				}
+			}
+		});
+	}
+	for (auto& thread: pool) {
+		thread.join();
+	}
+	for (int t = 0; t < threads; ++t) {
+		if (failed[t]) {
+			clog << "[threads]: thread " << t << " failed " << failed[t] << "\n";
+			errors = true;
+		}
+	}
+
+	// -- parse_batch: each result matches a sequential parse --
+
+	std::vector<std::vector<std::string>> batch_strs;
+	for (int i = 0; i < 1000; ++i) {
+		std::vector<std::string> v{"prog", "-a", "--aflag", "arg"};
+		v.push_back("--mand=" + std::to_string(i));
+		if (i % 7 == 0) {
+			v.push_back("-b");
+			v.push_back("-b");
+		}
+		batch_strs.push_back(std::move(v));
+	}
+	std::vector<std::vector<char*>> batch_ptrs;
+	std::vector<std::span<char*>> batch;
+	for (auto& v: batch_strs) {
+		auto& ptrs = batch_ptrs.emplace_back();
+		for (auto& str: v) {
+			ptrs.push_back(str.data());
+		}
+	}
+	for (auto& ptrs: batch_ptrs) {
+		batch.emplace_back(ptrs);
+	}
+
+	for (const unsigned int threads: {0u, 1u, 3u, 16u}) {
+		std::vector<CLUtils::ParseResult> batch_res(batch.size());
+		if ( !spec.parse_batch(batch_res, batch, 1, threads) ) {
+			clog << "[parse_batch]: threads " << threads << ": no errors\n";
+			errors = true;
+		}
+		for (std::size_t i = 0; i < batch.size(); ++i) {
+			CLUtils::ParseResult seq;
+			const bool seq_errors = spec.parse(seq,
+					static_cast<int>(batch[i].size()), batch[i].data(), 1);
+			const auto& r = batch_res[i];
+			if ( r.has_errors() != seq_errors
+					|| r.get_all_instances("-a").size()
+						!= seq.get_all_instances("-a").size()
+					|| r.get_input("-m") != seq.get_input("-m")
+					|| r.get_all_arguments().size()
+						!= seq.get_all_arguments().size() ) {
+				clog << "[parse_batch]: threads " << threads << ": slot " << i
+						<< " differs from a sequential parse\n";
+				errors = true;
+				break;
+			}
+		}
+	}
+
+	try {
+		std::vector<CLUtils::ParseResult> too_few(1);
+		(void)spec.parse_batch(too_few, batch);
+		clog << "[parse_batch]: too few results\n";
+		errors = true;
+	}
+	catch (std::length_error&) {}
+
+	// -- the wrapper still works after a copy --
+
+	CLUtils::Opts copy = cl;
+	copy.parse(std::vector<std::string>{"-x", "-a"});
+	if ( !copy.have_opt("-x") || !copy.have_opt("--aflag") ) {
+		clog << "[copy]: parse\n";
+		errors = true;
+	}
+
+	if (errors) {
+		return 51;
+	}
+	return 0;
+}
@@ -0,0 +1,368 @@
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <vector>
+#include <clutils.hpp>
+
+using std::clog;
+
+// every heap allocation made by the program is counted here, so that the
+// parses below can be checked to make none once the result has warmed up
+
+static std::size_t allocations = 0;
+
+void* operator new(std::size_t size) {
+	++allocations;
+	if (void* p = std::malloc(size ? size : 1)) {
+		return p;
+	}
+	throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+	std::free(p);
+}
+
+// std::pmr::new_delete_resource() allocates through the aligned forms
+
+void* operator new(std::size_t size, std::align_val_t align) {
+	++allocations;
+	const auto alignment = static_cast<std::size_t>(align);
+	if (void* p = std::aligned_alloc(alignment,
+			(size + alignment - 1) / alignment * alignment)) {
+		return p;
+	}
+	throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+	return operator new(size, align);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+	std::free(p);
+}
+
+// count the allocations made by 'f'
+template <typename F>
+std::size_t count(F&& f) {
+	const auto before = allocations;
+	f();
+	return allocations - before;
+}
+
+// argv storage that outlives the parses made with it
+struct Argv {
+	std::vector<std::string> strs;
+	std::vector<char*> ptrs;
+
+	Argv(std::vector<std::string> args) : strs{std::move(args)} {
+		for (auto& s: strs) {
+			ptrs.push_back(s.data());
+		}
+	}
+
+	int argc() const {
+		return static_cast<int>(ptrs.size());
+	}
+
+	char** argv() {
+		return ptrs.data();
+	}
+};
+
+int main() {
+	bool errors = false;
+
+	CLUtils::Opts cl;
+	cl.add_bare("-a", "--a-rather-long-bare-flag-name");
+	cl.add_bare("-b");
+	cl.add_bare(2, "-c");
+	cl.add_optional("-o", "--optional");
+	cl.add_mandatory("-m", "--mandatory");
+	cl.add_stop("--");
+	cl.allow_arguments(4);
+	cl.allow_unrecognized_flags(2);
+	for (int i = 0; i < 50; ++i) {
+		cl.add_bare("--flag-number-" + std::to_string(i));
+	}
+	const CLUtils::CompiledSpec spec = cl.compile();
+
+	// the widest argv: chains, inputs, arguments, unrecognized flags, a stop
+	// flag and a few errors (surplus -c, surplus arguments and flags, a bare
+	// flag with an input and a missing input)
+	Argv wide{{"prog", "-abc", "--a-rather-long-bare-flag-name", "-c", "-c",
+		"--optional=an-input-well-beyond-small-string-size", "-m", "input",
+		"--mandatory=another-input-longer-than-sso", "-ob", "--flag-number-7",
+		"--flag-number-49", "-X", "-Y", "-Z", "--unknown-and-long-flag-name",
+		"arg1", "arg2", "arg3", "arg4", "arg5", "-a=input", "--", "-a", "-b",
+		"-m"}};
+	Argv narrow{{"prog", "-ab", "--optional", "arg1", "-m"}};
+	Argv clean{{"prog", "-ab", "-mfile", "--flag-number-3", "arg1", "--",
+		"-c"}};
+
+	// -- a reused result: argv of the same shape as a previous parse --
+
+	CLUtils::ParseResult res;
+	if ( !spec.parse(res, wide.argc(), wide.argv()) ) {
+		clog << "[warm-up]: no errors\n";
+		errors = true;
+	}
+	const auto wide_args = res.get_all_arguments().size();
+
+	for (int i = 0; i < 3; ++i) {
+		for (auto* argv: {&wide, &narrow, &wide}) {
+			if (const auto n = count([&] {
+					spec.parse(res, argv->argc(), argv->argv()); }); n) {
+				clog << "[argv]: " << argv->argc() << " args: " << n
+						<< " allocations\n";
+				errors = true;
+			}
+		}
+	}
+	if ( !spec.parse(res, wide.argc(), wide.argv())
+			|| res.get_all_arguments().size() != wide_args ) {
+		clog << "[argv]: result differs after reuse\n";
+		errors = true;
+	}
+
+	// -- a reserved result: any argv of no more opts --
+
+	res.reserve(32);
+	for (auto* argv: {&clean, &narrow, &wide}) {
+		if (const auto n = count([&] {
+				spec.parse(res, argv->argc(), argv->argv()); }); n) {
+			clog << "[reserve]: " << argv->argc() << " args: " << n
+					<< " allocations\n";
+			errors = true;
+		}
+	}
+
+	// -- the event log as the only store: reserved as one block --
+
+	CLUtils::ParseResult log_res{spec};
+	log_res.keep_events_only();
+	// the log's block, the errors and the saved opts (views and copies);
+	// nothing per flag
+	if (const auto n = count([&] { log_res.reserve(32); }); n > 4) {
+		clog << "[events only]: reserve: " << n << " allocations\n";
+		errors = true;
+	}
+	for (auto* argv: {&clean, &narrow, &wide}) {
+		if (const auto n = count([&] {
+				spec.parse(log_res, argv->argc(), argv->argv()); }); n) {
+			clog << "[events only]: " << argv->argc() << " args: " << n
+					<< " allocations\n";
+			errors = true;
+		}
+	}
+	if ( log_res.get_input("--optional", 0) != res.get_input("--optional", 0)
+			|| log_res.events().size() <= wide_args ) {
+		clog << "[events only]: result\n";
+		errors = true;
+	}
+
+	// -- argv as a container and as a pack --
+
+	const std::vector<std::string> vec{"-ab", "--mandatory",
+		"an-input-well-beyond-small-string-size", "--flag-number-20", "arg"};
+	spec.parse(res, vec);
+	if (const auto n = count([&] { spec.parse(res, vec); }); n) {
+		clog << "[vector]: " << n << " allocations\n";
+		errors = true;
+	}
+
+	spec.parse(res, "-ab", "--flag-number-20",
+			"--optional=an-input-well-beyond-small-string-size", "arg");
+	if (const auto n = count([&] {
+			spec.parse(res, "-ab", "--flag-number-20",
+					"--optional=an-input-well-beyond-small-string-size", "arg"); }); n) {
+		clog << "[pack]: " << n << " allocations\n";
+		errors = true;
+	}
+	if ( std::get<1>(res.get_input("-o"))
+			!= "an-input-well-beyond-small-string-size" ) {
+		clog << "[pack]: input\n";
+		errors = true;
+	}
+
+	// strings handed over are kept by the result without a copy
+	for (int i = 0; i < 2; ++i) {
+		std::vector<std::string> moved{"prog", "-m",
+			"an-input-well-beyond-small-string-size"};
+		if (const auto n = count([&] {
+				spec.parse(res, std::move(moved), 1u); }); n) {
+			clog << "[moved]: " << n << " allocations\n";
+			errors = true;
+		}
+	}
+	if ( res.get_pos("-m") != 1 || std::get<1>(res.get_input("-m"))
+			!= "an-input-well-beyond-small-string-size" ) {
+		clog << "[moved]: input\n";
+		errors = true;
+	}
+
+	// -- the wrapper, reused --
+
+	cl.reserve(32);
+	if (const auto n = count([&] {
+			cl.parse(clean.argc(), clean.argv()); }); n) {
+		clog << "[opts]: " << n << " allocations\n";
+		errors = true;
+	}
+
+	// -- a result drawing from an arena allocates nothing, even cold --
+
+	for (int i = 0; i < 2; ++i) {
+		alignas(std::max_align_t) std::byte buffer[1 << 14];
+		std::pmr::monotonic_buffer_resource arena{buffer, sizeof(buffer),
+			std::pmr::null_memory_resource()};
+		if (const auto n = count([&] {
+				CLUtils::ParseResult arena_res{spec, &arena};
+				if ( !spec.parse(arena_res, wide.argc(), wide.argv())
+						|| arena_res.get_all_arguments().size() != wide_args
+						|| !arena_res.have_opt("--optional") ) {
+					clog << "[arena]: result\n";
+					errors = true;
+				}
+				spec.parse(arena_res, "-ab", std::string{"--flag-number-1"});
+				if ( !arena_res.have_opt("--flag-number-1") ) {
+					clog << "[arena]: pack result\n";
+					errors = true;
+				}
+				// the copies of streamed opts are drawn from the arena too
+				CLUtils::BasicParseStream<char, CLUtils::RuntimePolicy,
+				                          CLUtils::CLType> stream{spec, arena_res};
+				for (std::size_t j = 1; j < wide.strs.size(); ++j) {
+					stream.feed(wide.strs[j]);
+				}
+				if ( !stream.finish()
+						|| arena_res.get_all_arguments().size() != wide_args
+						|| std::get<1>(arena_res.get_input("--optional", 0))
+							!= "an-input-well-beyond-small-string-size" ) {
+					clog << "[arena]: stream result\n";
+					errors = true;
+				}
+			}); n) {
+			clog << "[arena]: " << n << " allocations\n";
+			errors = true;
+		}
+	}
+
+	alignas(std::max_align_t) std::byte opts_buffer[1 << 14];
+	std::pmr::monotonic_buffer_resource opts_arena{opts_buffer,
+		sizeof(opts_buffer), std::pmr::null_memory_resource()};
+	CLUtils::Opts arena_cl{&opts_arena};
+	arena_cl.add_bare("-a", "--aflag");
+	arena_cl.add_mandatory("-m");
+	(void)arena_cl.compile();
+	if (const auto n = count([&] {
+			arena_cl.parse(clean.argc(), clean.argv()); }); n) {
+		clog << "[arena opts]: " << n << " allocations\n";
+		errors = true;
+	}
+	if ( std::get<1>(arena_cl.get_input("-m")) != "file" ) {
+		clog << "[arena opts]: input\n";
+		errors = true;
+	}
+
+
+	// -- a result that hands everything to callbacks allocates nothing --
+
+	CLUtils::ParseResult visit;
+	std::size_t visited = 0;
+	for (std::size_t i = 0; i < spec.flags().size(); ++i) {
+		visit.set_flag_callback(CLUtils::FlagHandle{i},
+			[&](const CLUtils::ParseResult::Instance&) { ++visited; });
+	}
+	visit.set_argument_callback(
+		[&](std::string_view, CLUtils::CLType) { ++visited; });
+	visit.set_unrecognized_flag_callback(
+		[&](std::string_view, CLUtils::CLType) { ++visited; });
+	visit.set_error_callback(
+		[&](const CLUtils::ParseResult::ErrorInfo&) { ++visited; });
+	(void)spec.parse(visit, wide.argc(), wide.argv());
+	for (auto* argv: {&clean, &narrow, &wide}) {
+		visited = 0;
+		if (const auto n = count([&] {
+				spec.parse(visit, argv->argc(), argv->argv()); }); n) {
+			clog << "[callbacks]: " << argv->argc() << " args: " << n
+					<< " allocations\n";
+			errors = true;
+		}
+		if ( visited == 0 || !visit.get_all_arguments().empty()
+				|| !visit.get_all_unrecognized_flags().empty()
+				|| !visit.get_all_instances("-a").empty() ) {
+			clog << "[callbacks]: results kept\n";
+			errors = true;
+		}
+	}
+
+	// -- streaming arguments to a callback allocates nothing, however many --
+
+	CLUtils::Opts stream_cl;
+	stream_cl.add_mandatory("-m");
+	stream_cl.allow_arguments();
+	std::size_t streamed = 0;
+	stream_cl.set_argument_callback(
+		[&](std::string_view, CLUtils::CLType) { ++streamed; });
+	const std::string flag{"-m"};
+	const std::string files[] = {"/some/path/to/file-0",
+	                             "/some/path/to/file-one"};
+	std::string next;
+	const auto feed_all = [&](const int n, const bool flags) {
+		auto stream = stream_cl.stream();
+		for (int i = 0; i < n; ++i) {
+			next = flags && i % 100 == 0 ? flag : files[i % 2];
+			stream.feed(next);
+		}
+		return stream.finish();
+	};
+	(void)feed_all(1000, true);
+	if ( streamed != 1000 - 2 * 10 || !stream_cl.get_all_arguments().empty()
+			|| stream_cl.get_all_instances("-m").size() != 10 ) {
+		clog << "[stream]: results\n";
+		errors = true;
+	}
+	(void)feed_all(10, false);
+	if (const auto n = count([&] { (void)feed_all(100000, false); }); n) {
+		clog << "[stream]: " << n << " allocations\n";
+		errors = true;
+	}
+
+	if (errors) {
+		return 51;
+	}
+	return 0;
+}
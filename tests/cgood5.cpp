@@ -0,0 +1,193 @@
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <clutils.hpp>
+
+using std::clog;
+using namespace CLUtils;
+
+using Spec = StaticOpts<
+	Static::Bare<"-a", "--all">,
+	Static::Flag<FlagClass::bare, 2, "-c">,
+	Static::Optional<"-o", "--optional">,
+	Static::Mandatory<"-m", "--mandatory">,
+	Static::Stop<"--">>;
+
+// the flag positions are known at compile time
+static_assert(Spec::flag_pos<"-a">() == 0);
+static_assert(Spec::flag_pos<"--all">() == 0);
+static_assert(Spec::flag_pos<"-c">() == 1);
+static_assert(Spec::flag_pos<"--mandatory">() == 3);
+static_assert(Spec::flag_pos<"--">() == 4);
+
+// a StaticOpts must parse exactly as a BasicOpts declared alike
+template <BasicFixedString Name, typename S>
+bool same(const S& s, const Opts& o, const std::string& tag) {
+	const std::string name{Name.view()};
+	if (s.template have_opt<Name>() != o.have_opt(name)) {
+		clog << "[" << tag << "]: have_opt(" << name << ") differs\n";
+		return false;
+	}
+	const auto count = s.template get_all_instances<Name>().size();
+	if (count != o.get_all_instances(name).size()) {
+		clog << "[" << tag << "]: instances of " << name << " differ\n";
+		return false;
+	}
+	for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(count); ++i) {
+		if (s.template get_name<Name>(i) != o.get_name(name, i)
+				|| s.template get_pos<Name>(i) != o.get_pos(name, i)
+				|| s.template get_subpos<Name>(i) != o.get_subpos(name, i)
+				|| s.template has_input<Name>(i) != o.has_input(name, i)
+				|| s.template get_input<Name>(i) != o.get_input(name, i)
+				|| s.template is_input_internal<Name>(i) != o.is_input_internal(name, i)
+				|| s.template is_input_external<Name>(i) != o.is_input_external(name, i)) {
+			clog << "[" << tag << "]: instance " << i << " of " << name
+				<< " differs\n";
+			return false;
+		}
+	}
+	return true;
+}
+
+int main() {
+	bool errors = false;
+
+	Spec s{[](Opts& opts) {
+		opts.allow_arguments();
+		opts.allow_unrecognized_flags(1);
+	}};
+
+	Opts o;
+	o.add_bare("-a", "--all");
+	o.add_bare(2, "-c");
+	o.add_optional("-o", "--optional");
+	o.add_mandatory("-m", "--mandatory");
+	o.add_stop("--");
+	o.allow_arguments();
+	o.allow_unrecognized_flags(1);
+
+	const std::vector<std::vector<std::string>> argvs{
+		{"prog", "-ac", "--all", "-o=x", "-m", "in", "arg"},
+		{"prog", "-acc", "-c", "--optional", "--mandatory=in", "-X", "-Y"},
+		{"prog", "-mo", "--", "-a", "-c"},
+		{"prog", "--all=x", "-m"},
+		{"prog"},
+	};
+
+	for (std::size_t i = 0; i < argvs.size(); ++i) {
+		const std::string tag = "argv " + std::to_string(i);
+		if (s.parse(argvs[i]) != o.parse(argvs[i])) {
+			clog << "[" << tag << "]: parse result differs\n";
+			errors = true;
+		}
+		std::string s_errors, o_errors;
+		s.result().write_errors_to(std::back_inserter(s_errors));
+		o.write_errors_to(std::back_inserter(o_errors));
+		if (s_errors != o_errors) {
+			clog << "[" << tag << "]: errors differ\n";
+			errors = true;
+		}
+		if (s.result().get_all_arguments().size()
+				!= o.get_all_arguments().size()) {
+			clog << "[" << tag << "]: argument count differs\n";
+			errors = true;
+		}
+		errors |= !same<"-a">(s, o, tag);
+		errors |= !same<"-c">(s, o, tag);
+		errors |= !same<"--optional">(s, o, tag);
+		errors |= !same<"-m">(s, o, tag);
+		errors |= !same<"--">(s, o, tag);
+	}
+
+	// a copy is bound to its own spec
+	s.parse(argvs[0]);
+	const Spec copy{s};
+	s.parse(argvs[4]);
+	if (copy.result().spec() != &copy.spec()) {
+		clog << "[copy]: copy bound to the original spec\n";
+		errors = true;
+	}
+	if (!copy.have_opt<"--all">() || s.have_opt<"--all">()) {
+		clog << "[copy]: copy shares results with the original\n";
+		errors = true;
+	}
+
+	// queries out of range throw as their BasicOpts counterparts
+	try {
+		(void)s.get_pos<"-a">();
+		clog << "[range]: no instance, no throw\n";
+		errors = true;
+	}
+	catch (std::out_of_range&) {
+	}
+
+	// the names are looked up in the table generated at compile time, and
+	// the longest name that an opt begins with wins
+	using Prefixed = StaticOpts<
+		Static::Bare<"-a">,
+		Static::Optional<"-ab", "--in">,
+		Static::Mandatory<"--input", "--inputs">,
+		Static::Bare<"b">>;
+	Prefixed p{[](Opts& opts) { opts.allow_arguments(); }};
+	Opts po;
+	po.add_bare("-a");
+	po.add_optional("-ab", "--in");
+	po.add_mandatory("--input", "--inputs");
+	po.add_bare("b");
+	po.allow_arguments();
+	if (!p.spec().get_map().empty()) {
+		clog << "[table]: a map was built\n";
+		errors = true;
+	}
+	if (p.spec().flag_pos("--inputs") != 2 || p.spec().find_flag_pos("--inp")) {
+		clog << "[table]: flag positions differ\n";
+		errors = true;
+	}
+	const std::vector<std::vector<std::string>> prefixed{
+		{"prog", "-ab", "-abx", "-aa", "--in=1", "--input=2", "--inputs", "3"},
+		{"prog", "--inp=x", "--inputsx", "b", "bb", "-a=b", "--ins"},
+	};
+	for (std::size_t i = 0; i < prefixed.size(); ++i) {
+		const std::string tag = "prefixed " + std::to_string(i);
+		if (p.parse(prefixed[i]) != po.parse(prefixed[i])) {
+			clog << "[" << tag << "]: parse result differs\n";
+			errors = true;
+		}
+		std::string p_errors, po_errors;
+		p.result().write_errors_to(std::back_inserter(p_errors));
+		po.write_errors_to(std::back_inserter(po_errors));
+		if (p_errors != po_errors
+				|| p.result().get_all_arguments().size()
+				     != po.get_all_arguments().size()) {
+			clog << "[" << tag << "]: errors or arguments differ\n";
+			errors = true;
+		}
+		errors |= !same<"-a">(p, po, tag);
+		errors |= !same<"--in">(p, po, tag);
+		errors |= !same<"--input">(p, po, tag);
+		errors |= !same<"b">(p, po, tag);
+	}
+
+	// flags declared by 'configure' are unknown to the table, so the map is
+	// built as usual
+	Spec extra{[](Opts& opts) { opts.add_bare("-x"); }};
+	extra.parse(std::vector<std::string>{"prog", "-x", "-a"});
+	if (extra.spec().get_map().empty() || !extra.result().have_opt("-x")
+			|| !extra.have_opt<"-a">()) {
+		clog << "[configure]: flags declared by configure not found\n";
+		errors = true;
+	}
+
+	// wide characters
+	StaticOpts<Static::Bare<L"-w">, Static::Mandatory<L"--in">> w;
+	w.parse(std::vector<std::wstring>{L"prog", L"-w", L"--in=file"});
+	if (!w.have_opt<L"-w">() || std::get<1>(w.get_input<L"--in">()) != L"file") {
+		clog << "[wide]: parse failed\n";
+		errors = true;
+	}
+
+	if (errors) {
+		return 51;
+	}
+}
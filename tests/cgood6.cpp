@@ -0,0 +1,146 @@
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <clutils.hpp>
+
+using std::clog;
+using namespace CLUtils;
+
+// every opt of every argv below, under each policy, must parse exactly as
+// with the same behaviour set at run time
+
+const std::vector<std::vector<std::string>> argvs{
+	{"prog", "-abc", "-m", "-o", "arg", "-X"},
+	{"prog", "-ma", "-o", "-m", "-X", "--", "-a"},
+	{"prog", "-o", "-X", "-m", "", "arg", "", "-c=x"},
+	{"prog", "-cm", "-o", "--long=", "-a", "-m"},
+	{"prog", "-X", "-Y", "arg", "-ob", "-mc", "--long", "in"},
+};
+
+template <typename Opts>
+void declare(Opts& cl) {
+	cl.add_bare("-a");
+	cl.add_bare(2, "-b");
+	cl.add_optional("-o");
+	cl.add_mandatory("-m", "--long");
+	cl.add_stop("--");
+}
+
+// a description of everything that a parse gave
+template <typename Opts>
+std::string outcome(const Opts& cl) {
+	std::string out;
+	for (const auto name: {"-a", "-b", "-o", "-m", "--"}) {
+		out += name;
+		for (const auto& instance: cl.get_all_instances(name)) {
+			const auto [has, input] = cl.get_input(instance);
+			out += " " + std::to_string(cl.get_pos(instance)) + "."
+				+ std::to_string(cl.get_subpos(instance))
+				+ (has ? "=" + std::string{input} : "");
+		}
+		out += "\n";
+	}
+	for (const auto& arg: cl.get_all_arguments()) {
+		out += "arg " + std::string{arg.name()} + "\n";
+	}
+	for (const auto& flag: cl.get_all_unrecognized_flags()) {
+		out += "unrecognized " + std::string{flag.name()} + "\n";
+	}
+	cl.write_errors_to(std::back_inserter(out));
+	return out;
+}
+
+template <typename Policy>
+bool check(const std::string& tag) {
+	BasicOpts<char, Policy> fixed;
+	declare(fixed);
+
+	Opts runtime;
+	declare(runtime);
+	runtime.set_chaining(*Policy::chaining);
+	runtime.set_greedy(*Policy::mandatory_greedy);
+	runtime.set_optional_greedy(*Policy::optional_greedy);
+	runtime.allow_empty_inputs(*Policy::empty_inputs);
+	runtime.allow_empty_arguments(*Policy::empty_arguments);
+	if (*Policy::arguments) {
+		runtime.allow_arguments();
+	}
+	if (*Policy::unrecognized_flags) {
+		runtime.allow_unrecognized_flags();
+	}
+
+	// a compiled spec may be parsed with a policy too
+	const auto spec = runtime.compile();
+	ParseResult res;
+
+	bool errors = false;
+	for (std::size_t i = 0; i < argvs.size(); ++i) {
+		const bool a = fixed.parse(argvs[i]);
+		const bool b = runtime.parse(argvs[i]);
+		const bool c = spec.parse<Policy>(res, argvs[i]);
+		const auto expected = outcome(runtime);
+		if (a != b || outcome(fixed) != expected) {
+			clog << "[" << tag << "]: argv " << i << ": fixed policy differs:\n"
+				<< outcome(fixed) << "-- expected:\n" << expected;
+			errors = true;
+		}
+		std::string spec_errors;
+		res.write_errors_to(std::back_inserter(spec_errors));
+		std::string runtime_errors;
+		runtime.write_errors_to(std::back_inserter(runtime_errors));
+		if (c != b || spec_errors != runtime_errors) {
+			clog << "[" << tag << "]: argv " << i
+				<< ": spec parsed with policy differs\n";
+			errors = true;
+		}
+	}
+	return errors;
+}
+
+// only the chaining is fixed; everything else is set at run time
+struct NoChaining : RuntimePolicy {
+	static constexpr std::optional<bool> chaining = false;
+};
+
+int main() {
+	bool errors = false;
+
+	errors |= check<FixedPolicy<>>("defaults");
+	errors |= check<FixedPolicy<false>>("no chaining");
+	errors |= check<FixedPolicy<true, Greedy::lax>>("lax");
+	errors |= check<FixedPolicy<true, Greedy::yes, true>>("greedy");
+	errors |= check<FixedPolicy<true, Greedy::no, false, true, true>>("empty");
+	errors |= check<FixedPolicy<true, Greedy::no, false, false, false, true>>(
+		"arguments");
+	errors |= check<FixedPolicy<true, Greedy::lax, false, false, false, true,
+		true>>("arguments and unrecognized");
+	errors |= check<FixedPolicy<false, Greedy::yes, true, true, true, true,
+		true>>("everything");
+
+	// a partly fixed policy: the rest is still set at run time
+	BasicOpts<char, NoChaining> cl;
+	declare(cl);
+	cl.allow_arguments();
+	cl.parse(std::vector<std::string>{"-ab", "arg"});
+	if (cl.have_opt("-b") || cl.get_all_arguments().size() != 1) {
+		clog << "[partial]: -ab chained or arg not collected\n";
+		errors = true;
+	}
+
+	// the fixed behaviour is restored by clear_declarations
+	BasicOpts<char, FixedPolicy<true, Greedy::no, false, false, false, true>>
+		args;
+	args.allow_arguments(1);
+	args.clear_declarations();
+	declare(args);
+	args.parse(std::vector<std::string>{"x", "y"});
+	if (args.get_all_arguments().size() != 2) {
+		clog << "[clear]: argument limit not reset\n";
+		errors = true;
+	}
+
+	if (errors) {
+		return 51;
+	}
+}
@@ -0,0 +1,209 @@
+#include <csignal>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+// the throwing queries abort through the library rather than throw, even
+// when built with exceptions
+#define DEFPROB_CLUTILS_NO_EXCEPTIONS 1
+#include <clutils.hpp>
+
+using std::clog;
+using namespace CLUtils;
+
+// nothing here may throw: this is also compiled with -fno-exceptions
+
+// whether 'query', run in a child process, aborts with the message of the
+// library, as it does without exceptions (the standard library's own throw
+// sites would abort without it)
+bool aborts_with_message(const std::function<void()>& query) {
+	int fds[2];
+	if (::pipe(fds) != 0) {
+		return false;
+	}
+	const pid_t child = ::fork();
+	if (child == 0) {
+		::dup2(fds[1], STDERR_FILENO);
+		query();
+		::_exit(0);
+	}
+	::close(fds[1]);
+	char buffer[256];
+	const auto n = ::read(fds[0], buffer, sizeof(buffer));
+	::close(fds[0]);
+	int status = 0;
+	::waitpid(child, &status, 0);
+	const std::string message = n > 0
+		? std::string(buffer, static_cast<std::size_t>(n)) : std::string{};
+	return WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT
+		&& message.starts_with("libclutils: ");
+}
+
+int main() {
+	bool errors = false;
+
+	Opts cl;
+	const auto h = cl.try_add_bare("-h", "--help");
+	const auto o = cl.try_add_optional("-o");
+	const auto m = cl.try_add_mandatory(2, "-m");
+	if (!h || !o || !m) {
+		clog << "[declare]: valid names rejected\n";
+		errors = true;
+	}
+
+	// -- rejected declarations --
+	if (cl.try_add_bare("--help")) {
+		clog << "[declare]: name declared twice\n";
+		errors = true;
+	}
+	if (cl.try_add_stop("")) {
+		clog << "[declare]: empty name accepted\n";
+		errors = true;
+	}
+	if (cl.try_add_optional("-x", "-x")) {
+		clog << "[declare]: repeated name in one call accepted\n";
+		errors = true;
+	}
+
+	cl.allow_arguments();
+	cl.parse(std::vector<std::string>{"-h", "-ma", "arg", "-o", "-mb"});
+
+	// -- queries --
+	if (cl.try_have_opt("-h") != true || cl.try_have_opt(*o) != true) {
+		clog << "[query]: declared opts not found\n";
+		errors = true;
+	}
+	// a rejected declaration declares nothing
+	if (cl.try_have_opt("-x") || cl.try_get_all_instances("-y") != nullptr) {
+		clog << "[query]: undeclared opt found\n";
+		errors = true;
+	}
+	if (cl.try_have_opt(FlagHandle{99}) || cl.try_get_pos(FlagHandle{99})) {
+		clog << "[query]: invalid handle found\n";
+		errors = true;
+	}
+	if (const auto* ms = cl.try_get_all_instances(*m);
+			ms == nullptr || ms->size() != 2) {
+		clog << "[query]: wrong instances of -m\n";
+		errors = true;
+	}
+	if (const auto input = cl.try_get_input("-m");
+			!input || std::get<1>(*input) != "b") {
+		clog << "[query]: wrong input of last -m\n";
+		errors = true;
+	}
+	if (const auto input = cl.try_get_input(*m, 0);
+			!input || std::get<1>(*input) != "a") {
+		clog << "[query]: wrong input of first -m\n";
+		errors = true;
+	}
+	if (cl.try_get_input(*m, 2) || cl.try_get_input(*m, -3)) {
+		clog << "[query]: instance out of range found\n";
+		errors = true;
+	}
+	if (cl.try_has_input("-o") != false || cl.try_get_pos("-o") != 4
+			|| cl.try_get_subpos(*m, 0) != 0 || cl.try_get_name(*h) != "-h") {
+		clog << "[query]: wrong instance details\n";
+		errors = true;
+	}
+	if (cl.try_is_input_internal("-m") != true
+			|| cl.try_is_input_external(*m) != false) {
+		clog << "[query]: wrong input kind\n";
+		errors = true;
+	}
+	if (const auto* arg = cl.try_get_argument();
+			arg == nullptr || arg->name() != "arg"
+			|| cl.try_get_argument(1) != nullptr
+			|| cl.try_get_unrecognized_flag() != nullptr) {
+		clog << "[query]: wrong arguments\n";
+		errors = true;
+	}
+
+	// -- compiling --
+	if (const auto spec = cl.try_compile(); !spec) {
+		clog << "[compile]: valid spec rejected\n";
+		errors = true;
+	} else {
+		ParseResult res;
+		spec->parse(res, std::vector<std::string>{"-o"});
+		if (res.try_has_input(*o) != false || res.try_have_opt("-h") != false) {
+			clog << "[compile]: wrong results\n";
+			errors = true;
+		}
+	}
+	cl.add_bare("-o");  // a conflict, only found when compiling
+	if (cl.try_compile()) {
+		clog << "[compile]: conflicting spec accepted\n";
+		errors = true;
+	}
+	cl.clear_declarations();
+
+	// -- writing errors --
+	cl.add_mandatory("-m");
+	cl.parse(std::vector<std::string>{"-m"});
+	int fds[2];
+	if (::pipe(fds) != 0) {
+		clog << "[fd]: no pipe\n";
+		return 51;
+	}
+	if (cl.try_write_errors_to_fd(fds[1]) != 0) {
+		clog << "[fd]: write to pipe failed\n";
+		errors = true;
+	}
+	::close(fds[1]);
+	char buffer[256];
+	const auto n = ::read(fds[0], buffer, sizeof(buffer));
+	::close(fds[0]);
+	std::string expected;
+	cl.write_errors_to(std::back_inserter(expected));
+	if (n <= 0 || std::string(buffer, static_cast<std::size_t>(n)) != expected) {
+		clog << "[fd]: wrong errors written\n";
+		errors = true;
+	}
+	if (cl.try_write_errors_to_fd(-1) == 0) {
+		clog << "[fd]: write to bad fd succeeded\n";
+		errors = true;
+	}
+
+	// -- throw sites --
+	cl.clear_declarations();
+	cl.add_bare("-a");
+	cl.allow_arguments();
+	cl.allow_unrecognized_flags();
+	cl.parse(std::vector<std::string>{"-a", "arg", "-Z"});
+	std::ostringstream out;
+	const std::vector<std::pair<const char*, std::function<void()>>> queries{
+		{"have_opt", [&] { (void)cl.have_opt("-zz"); }},
+		{"get_input", [&] { (void)cl.get_input("-zz"); }},
+		{"get_unrecognized_flag", [&] { (void)cl.get_unrecognized_flag(1); }},
+		{"get_argument", [&] { (void)cl.get_argument(-2); }},
+		{"write_error", [&] { cl.write_error(out, 5); }},
+	};
+	for (const auto& [tag, query]: queries) {
+		if (!aborts_with_message(query)) {
+			clog << "[throw sites]: " << tag << " did not abort through raise\n";
+			errors = true;
+		}
+	}
+#ifdef DEFPROB_CLUTILS_HAVE_MMAN
+	std::ofstream{"cgood7.rsp"} << "x y\n";
+	cl.allow_response_files();
+	char a0[] = "prog", a1[] = "@cgood7.rsp";
+	char* argv[] = {a0, a1};
+	cl.parse(2, argv);
+	if (cl.get_source(2).file != "cgood7.rsp"
+			|| !aborts_with_message([&] { (void)cl.get_source(9); })) {
+		clog << "[throw sites]: get_source did not abort through raise\n";
+		errors = true;
+	}
+	::unlink("cgood7.rsp");
+#endif
+
+	if (errors) {
+		return 51;
+	}
+}
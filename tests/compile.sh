@@ -24,8 +24,11 @@ echo "CXXFLAGS: $CXXFLAGS"
 echo "top_srcdir: $top_srcdir"
 echo "RM: $RM"
 
-xsuccess=( cgood1 cgood2 )
-xfail=( cfail1 cfail2 cfail3 cfail4 cfail5 cfail6 cfail7 cfail8 )
+xsuccess=( cgood1 cgood2 cgood3 cgood4 cgood5 cgood6 cgood7 )
+xfail=( cfail1 cfail2 cfail3 cfail4 cfail5 cfail6 cfail7 cfail8 cfail9
+        cfail10 cfail11 cfail12 )
+# compiled again without exceptions
+xsuccess_noexcept=( cgood7 )
 error=0
 
 for i in "${xsuccess[@]}"; do
@@ -50,6 +53,28 @@ for i in "${xsuccess[@]}"; do
 	fi
 done
 
+for i in "${xsuccess_noexcept[@]}"; do
+	echo "[compile] ${i}.cpp (-fno-exceptions)"
+	if $CXX $CXXFLAGS -fno-exceptions -I${srcdir} -o $i ${testsdir}/${i}.cpp; then
+		if ./$i ; then
+			$RM ./$i
+		else
+			ret=$?
+			echo "-- $CXX $CXXFLAGS -fno-exceptions -I${srcdir} -o $i ${testsdir}/${i}.cpp"
+			echo "-- binary exited with code: $ret"
+			error=1
+			$RM ./$i
+			break
+		fi
+	else
+		ret=$?
+		echo "-- $CXX $CXXFLAGS -fno-exceptions -I${srcdir} -o $i ${testsdir}/${i}.cpp"
+		echo "-- compilation unexpectedly failed: returned: $ret"
+		error=1
+		break
+	fi
+done
+
 for i in "${xfail[@]}"; do
 	echo "[compile] ${i}.cpp"
 	if $CXX $CXXFLAGS -I${srcdir} -o /dev/null ${testsdir}/${i}.cpp; then